@@ -0,0 +1,364 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Elements/AabbTree.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+using namespace Cass;
+
+namespace {
+	// leaves are enlarged by this share of their largest extent, plus a minimum for flat and point like boxes
+	const float s_marginRatio = 0.1f;
+	const float s_minMargin = 0.001f;
+
+	using Node = detail::AABB_TREE_NODE;
+
+	void Merge(Node& _node, const Node& _a, const Node& _b) {
+		_node.lb = { std::min(_a.lb.x, _b.lb.x), std::min(_a.lb.y, _b.lb.y), std::min(_a.lb.z, _b.lb.z) };
+		_node.ub = { std::max(_a.ub.x, _b.ub.x), std::max(_a.ub.y, _b.ub.y), std::max(_a.ub.z, _b.ub.z) };
+	}
+
+	/**
+	* @brief Half the surface area of the union of two nodes' bounds
+	*/
+	float MergedArea(const Node& _a, const Node& _b) {
+		float x = std::max(_a.ub.x, _b.ub.x) - std::min(_a.lb.x, _b.lb.x);
+		float y = std::max(_a.ub.y, _b.ub.y) - std::min(_a.lb.y, _b.lb.y);
+		float z = std::max(_a.ub.z, _b.ub.z) - std::min(_a.lb.z, _b.lb.z);
+
+		return x * y + y * z + z * x;
+	}
+
+	float Area(const Node& _node) {
+		return MergedArea(_node, _node);
+	}
+
+	bool Contains(const Node& _node, const DirectX::XMFLOAT3& _lb, const DirectX::XMFLOAT3& _ub) {
+		return _node.lb.x <= _lb.x && _node.lb.y <= _lb.y && _node.lb.z <= _lb.z &&
+			_ub.x <= _node.ub.x && _ub.y <= _node.ub.y && _ub.z <= _node.ub.z;
+	}
+
+	bool Overlaps(const Node& _node, const DirectX::XMFLOAT3& _lb, const DirectX::XMFLOAT3& _ub) {
+		return _node.lb.x <= _ub.x && _lb.x <= _node.ub.x && _node.lb.y <= _ub.y && _lb.y <= _node.ub.y &&
+			_node.lb.z <= _ub.z && _lb.z <= _node.ub.z;
+	}
+
+	float DistanceSq(const Node& _node, const DirectX::XMFLOAT3& _point) {
+		float x = std::max(std::max(_node.lb.x - _point.x, _point.x - _node.ub.x), 0.0f);
+		float y = std::max(std::max(_node.lb.y - _point.y, _point.y - _node.ub.y), 0.0f);
+		float z = std::max(std::max(_node.lb.z - _point.z, _point.z - _node.ub.z), 0.0f);
+
+		return x * x + y * y + z * z;
+	}
+
+	void Enlarge(Node& _node, const DirectX::XMFLOAT3& _lb, const DirectX::XMFLOAT3& _ub) {
+		float margin = s_marginRatio * std::max(std::max(_ub.x - _lb.x, _ub.y - _lb.y), _ub.z - _lb.z) + s_minMargin;
+
+		_node.lb = { _lb.x - margin, _lb.y - margin, _lb.z - margin };
+		_node.ub = { _ub.x + margin, _ub.y + margin, _ub.z + margin };
+	}
+}
+
+//
+// ---------- class AabbTree
+//
+
+AabbTree::AabbTree() {
+	m_root = s_nullProxy;
+	m_freeList = s_nullProxy;
+	m_proxyCount = 0;
+}
+
+uint32_t AabbTree::AllocateNode() {
+	uint32_t index;
+	if (m_freeList != s_nullProxy) {
+		index = m_freeList;
+		m_freeList = m_nodes[index].parent;
+	}
+	else {
+		if (m_nodes.size() >= s_nullProxy) throw std::length_error("AabbTree node count exceeds 32 bit indices");
+
+		index = static_cast <uint32_t> (m_nodes.size());
+		m_nodes.emplace_back();
+	}
+
+	Node& node = m_nodes[index];
+	node.parent = s_nullProxy;
+	node.children[0] = node.children[1] = s_nullProxy;
+	node.height = 0;
+	node.userData = 0;
+
+	return index;
+}
+
+void AabbTree::FreeNode(uint32_t _node) {
+	m_nodes[_node].parent = m_freeList;
+	m_nodes[_node].height = -1;
+	m_freeList = _node;
+}
+
+uint32_t AabbTree::Insert(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, uint64_t _userData) {
+	uint32_t proxy = AllocateNode();
+	Enlarge(m_nodes[proxy], _lb, _ub);
+	m_nodes[proxy].userData = _userData;
+
+	InsertLeaf(proxy);
+	m_proxyCount++;
+
+	return proxy;
+}
+
+void AabbTree::Remove(uint32_t _proxy) {
+	if (_proxy >= m_nodes.size() || m_nodes[_proxy].height != 0) throw std::invalid_argument("Not a proxy of this tree");
+
+	RemoveLeaf(_proxy);
+	FreeNode(_proxy);
+	m_proxyCount--;
+}
+
+bool AabbTree::Move(uint32_t _proxy, DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub) {
+	if (_proxy >= m_nodes.size() || m_nodes[_proxy].height != 0) throw std::invalid_argument("Not a proxy of this tree");
+	if (Contains(m_nodes[_proxy], _lb, _ub)) return false;
+
+	RemoveLeaf(_proxy);
+	Enlarge(m_nodes[_proxy], _lb, _ub);
+	InsertLeaf(_proxy);
+
+	return true;
+}
+
+void AabbTree::InsertLeaf(uint32_t _leaf) {
+	if (m_root == s_nullProxy) {
+		m_root = _leaf;
+		m_nodes[_leaf].parent = s_nullProxy;
+		return;
+	}
+
+	// descend while placing the leaf further down costs less than pairing it here
+	uint32_t index = m_root;
+	while (!IsLeaf(index)) {
+		const Node& node = m_nodes[index], & leaf = m_nodes[_leaf];
+		float mergedArea = MergedArea(node, leaf);
+
+		// pairing with this node, or the growth every ancestor of a deeper pairing pays
+		float cost = 2.0f * mergedArea;
+		float inheritedCost = 2.0f * (mergedArea - Area(node));
+
+		float childCost[2];
+		for (int i = 0; i < 2; i++) {
+			const Node& child = m_nodes[node.children[i]];
+			childCost[i] = MergedArea(child, leaf) + inheritedCost;
+			if (child.height > 0) childCost[i] -= Area(child);
+		}
+
+		if (cost < childCost[0] && cost < childCost[1]) break;
+		index = childCost[0] < childCost[1] ? node.children[0] : node.children[1];
+	}
+
+	uint32_t sibling = index;
+	uint32_t oldParent = m_nodes[sibling].parent;
+	uint32_t newParent = AllocateNode();
+
+	Node& parent = m_nodes[newParent];
+	parent.parent = oldParent;
+	parent.height = m_nodes[sibling].height + 1;
+	parent.children[0] = sibling;
+	parent.children[1] = _leaf;
+	Merge(parent, m_nodes[sibling], m_nodes[_leaf]);
+
+	if (oldParent != s_nullProxy) {
+		Node& grandParent = m_nodes[oldParent];
+		grandParent.children[grandParent.children[0] == sibling ? 0 : 1] = newParent;
+	}
+	else {
+		m_root = newParent;
+	}
+	m_nodes[sibling].parent = newParent;
+	m_nodes[_leaf].parent = newParent;
+
+	Repair(newParent);
+}
+
+void AabbTree::RemoveLeaf(uint32_t _leaf) {
+	if (_leaf == m_root) {
+		m_root = s_nullProxy;
+		return;
+	}
+
+	uint32_t parent = m_nodes[_leaf].parent;
+	uint32_t grandParent = m_nodes[parent].parent;
+	uint32_t sibling = m_nodes[parent].children[m_nodes[parent].children[0] == _leaf ? 1 : 0];
+
+	// the sibling takes the place of the parent
+	if (grandParent != s_nullProxy) {
+		Node& node = m_nodes[grandParent];
+		node.children[node.children[0] == parent ? 0 : 1] = sibling;
+		m_nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		Repair(grandParent);
+	}
+	else {
+		m_root = sibling;
+		m_nodes[sibling].parent = s_nullProxy;
+		FreeNode(parent);
+	}
+}
+
+void AabbTree::Repair(uint32_t _node) {
+	for (uint32_t index = _node; index != s_nullProxy; index = m_nodes[index].parent) {
+		index = Balance(index);
+
+		Node& node = m_nodes[index];
+		const Node& a = m_nodes[node.children[0]], & b = m_nodes[node.children[1]];
+		node.height = 1 + std::max(a.height, b.height);
+		Merge(node, a, b);
+	}
+}
+
+uint32_t AabbTree::Balance(uint32_t _node) {
+	Node& a = m_nodes[_node];
+	if (IsLeaf(_node) || a.height < 2) return _node;
+
+	uint32_t iB = a.children[0], iC = a.children[1];
+	Node& b = m_nodes[iB], & c = m_nodes[iC];
+	int32_t balance = c.height - b.height;
+	if (balance >= -1 && balance <= 1) return _node;
+
+	// the taller child takes the place of _node, _node keeps the shorter child and the lower of the taller one's children
+	uint32_t iUp = balance > 1 ? iC : iB;
+	int side = balance > 1 ? 1 : 0;
+	Node& up = m_nodes[iUp];
+	const Node& kept = m_nodes[a.children[1 - side]];
+
+	uint32_t iF = up.children[0], iG = up.children[1];
+	Node& f = m_nodes[iF], & g = m_nodes[iG];
+
+	up.children[0] = _node;
+	up.parent = a.parent;
+	a.parent = iUp;
+
+	if (up.parent != s_nullProxy) {
+		Node& parent = m_nodes[up.parent];
+		parent.children[parent.children[0] == _node ? 0 : 1] = iUp;
+	}
+	else {
+		m_root = iUp;
+	}
+
+	uint32_t iHigh = f.height > g.height ? iF : iG, iLow = f.height > g.height ? iG : iF;
+	Node& high = m_nodes[iHigh], & low = m_nodes[iLow];
+
+	up.children[1] = iHigh;
+	a.children[side] = iLow;
+	low.parent = _node;
+
+	Merge(a, kept, low);
+	a.height = 1 + std::max(kept.height, low.height);
+	Merge(up, a, high);
+	up.height = 1 + std::max(a.height, high.height);
+
+	return iUp;
+}
+
+void AabbTree::Query(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, std::vector <uint32_t>& _oProxies) const {
+	if (m_root == s_nullProxy) return;
+
+	std::vector <uint32_t> stack = { m_root };
+	while (!stack.empty()) {
+		uint32_t index = stack.back();
+		stack.pop_back();
+
+		const Node& node = m_nodes[index];
+		if (!Overlaps(node, _lb, _ub)) continue;
+
+		if (IsLeaf(index)) {
+			_oProxies.push_back(index);
+			continue;
+		}
+		stack.push_back(node.children[0]);
+		stack.push_back(node.children[1]);
+	}
+}
+
+uint32_t AabbTree::RayCast(const Ray& _ray, const std::function <bool(uint32_t, float&)>& _hit, float& _oDistance) const {
+	float tNear, tFar;
+	if (m_root == s_nullProxy || !_ray.IntersectBox(m_nodes[m_root].lb, m_nodes[m_root].ub, tNear, tFar)) return s_nullProxy;
+
+	float closest = std::numeric_limits <float>::max();
+	uint32_t result = s_nullProxy;
+
+	std::vector <std::pair <uint32_t, float>> stack = { { m_root, tNear } };
+	while (!stack.empty()) {
+		auto [index, entry] = stack.back();
+		stack.pop_back();
+		if (entry >= closest) continue;
+
+		const Node& node = m_nodes[index];
+		if (IsLeaf(index)) {
+			float distance;
+			if (_hit(index, distance) && distance < closest) {
+				closest = distance;
+				result = index;
+			}
+			continue;
+		}
+
+		// the nearer child is pushed last to be visited first
+		float entries[2];
+		bool hit[2];
+		for (int i = 0; i < 2; i++) {
+			const Node& child = m_nodes[node.children[i]];
+			hit[i] = _ray.IntersectBox(child.lb, child.ub, entries[i], tFar) && entries[i] < closest;
+		}
+
+		int first = entries[1] < entries[0] ? 1 : 0;
+		if (hit[1 - first]) stack.push_back({ node.children[1 - first], entries[1 - first] });
+		if (hit[first]) stack.push_back({ node.children[first], entries[first] });
+	}
+
+	if (result != s_nullProxy) _oDistance = closest;
+	return result;
+}
+
+uint32_t AabbTree::Nearest(DirectX::XMFLOAT3 _point, const std::function <float(uint32_t)>& _distance, float& _oDistance) const {
+	if (m_root == s_nullProxy) return s_nullProxy;
+
+	// closest bounds first, stops once no remaining bounds are nearer than the best proxy
+	using Entry = std::pair <float, uint32_t>;
+	std::priority_queue <Entry, std::vector <Entry>, std::greater <Entry>> queue;
+	queue.push({ DistanceSq(m_nodes[m_root], _point), m_root });
+
+	float closest = std::numeric_limits <float>::max();
+	uint32_t result = s_nullProxy;
+	while (!queue.empty()) {
+		auto [distanceSq, index] = queue.top();
+		queue.pop();
+		if (distanceSq >= closest * closest) break;
+
+		const Node& node = m_nodes[index];
+		if (IsLeaf(index)) {
+			float distance = _distance(index);
+			if (distance < closest) {
+				closest = distance;
+				result = index;
+			}
+			continue;
+		}
+
+		for (int i = 0; i < 2; i++) {
+			float childSq = DistanceSq(m_nodes[node.children[i]], _point);
+			if (childSq < closest * closest) queue.push({ childSq, node.children[i] });
+		}
+	}
+
+	if (result != s_nullProxy) _oDistance = closest;
+	return result;
+}
\ No newline at end of file
@@ -30,53 +30,18 @@ void BoundingBox::Calculate(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub) {
 }
 
 int BoundingBox::Intersect(const Cass::Ray& _ray) const {
-	if (m_dims.x <= 0.0f || m_dims.y <= 0.0f || m_dims.z <= 0.0f) return false;
+	float tNear, tFar;
+	if (!Intersect(_ray, tNear, tFar)) return 0;
 
-	int count = 0;
-	// bottom and upper quad
-	for (int i = -1; i <= 1; i += 2) {
-		count += _ray.IntersectTriangle(
-			{ m_pos.x - m_dims.x * 0.5f, m_pos.y - m_dims.y * 0.5f, m_pos.z + i * m_dims.z * 0.5f },
-			{ m_pos.x + m_dims.x * 0.5f, m_pos.y - m_dims.y * 0.5f, m_pos.z + i * m_dims.z * 0.5f },
-			{ m_pos.x + m_dims.x * 0.5f, m_pos.y + m_dims.y * 0.5f, m_pos.z + i * m_dims.z * 0.5f }
-		);
-		count += _ray.IntersectTriangle(
-			{ m_pos.x - m_dims.x * 0.5f, m_pos.y - m_dims.y * 0.5f, m_pos.z + i * m_dims.z * 0.5f },
-			{ m_pos.x - m_dims.x * 0.5f, m_pos.y + m_dims.y * 0.5f, m_pos.z + i * m_dims.z * 0.5f },
-			{ m_pos.x + m_dims.x * 0.5f, m_pos.y + m_dims.y * 0.5f, m_pos.z + i * m_dims.z * 0.5f }
-		);
-		if (count >= 2) return 1;
-	}
+	return tNear > 0.0f ? 1 : -1;
+}
 
-	// front and back quad
-	for (int i = -1; i <= 1; i += 2) {
-		count += _ray.IntersectTriangle(
-			{ m_pos.x - m_dims.x * 0.5f, m_pos.y + i * m_dims.y * 0.5f, m_pos.z - m_dims.z * 0.5f },
-			{ m_pos.x + m_dims.x * 0.5f, m_pos.y + i * m_dims.y * 0.5f, m_pos.z - m_dims.z * 0.5f },
-			{ m_pos.x + m_dims.x * 0.5f, m_pos.y + i * m_dims.y * 0.5f, m_pos.z + m_dims.z * 0.5f }
-		);
-		count += _ray.IntersectTriangle(
-			{ m_pos.x - m_dims.x * 0.5f, m_pos.y + i * m_dims.y * 0.5f, m_pos.z - m_dims.z * 0.5f },
-			{ m_pos.x - m_dims.x * 0.5f, m_pos.y + i * m_dims.y * 0.5f, m_pos.z + m_dims.z * 0.5f },
-			{ m_pos.x + m_dims.x * 0.5f, m_pos.y + i * m_dims.y * 0.5f, m_pos.z + m_dims.z * 0.5f }
-		);
-		if (count >= 2) return 1;
-	}
+bool BoundingBox::Intersect(const Cass::Ray& _ray, float& _oNear, float& _oFar) const {
+	if (m_dims.x <= 0.0f || m_dims.y <= 0.0f || m_dims.z <= 0.0f) return false;
 
-	// left and right quad
-	for (int i = -1; i <= 1; i += 2) {
-		count += _ray.IntersectTriangle(
-			{ m_pos.x + i * m_dims.x * 0.5f, m_pos.y - m_dims.y * 0.5f, m_pos.z - m_dims.z * 0.5f },
-			{ m_pos.x + i * m_dims.x * 0.5f, m_pos.y + m_dims.y * 0.5f, m_pos.z - m_dims.z * 0.5f },
-			{ m_pos.x + i * m_dims.x * 0.5f, m_pos.y + m_dims.y * 0.5f, m_pos.z + m_dims.z * 0.5f }
-		);
-		count += _ray.IntersectTriangle(
-			{ m_pos.x + i * m_dims.x * 0.5f, m_pos.y - m_dims.y * 0.5f, m_pos.z - m_dims.z * 0.5f },
-			{ m_pos.x + i * m_dims.x * 0.5f, m_pos.y - m_dims.y * 0.5f, m_pos.z + m_dims.z * 0.5f },
-			{ m_pos.x + i * m_dims.x * 0.5f, m_pos.y + m_dims.y * 0.5f, m_pos.z + m_dims.z * 0.5f }
-		);
-		if (count >= 2) return 1;
-	}
-	
-	return -count;
+	return _ray.IntersectBox(
+		{ m_pos.x - m_dims.x * 0.5f, m_pos.y - m_dims.y * 0.5f, m_pos.z - m_dims.z * 0.5f },
+		{ m_pos.x + m_dims.x * 0.5f, m_pos.y + m_dims.y * 0.5f, m_pos.z + m_dims.z * 0.5f },
+		_oNear, _oFar
+	);
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Elements/Frustum.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Cass;
+
+//
+// ---------- class BoxArray
+//
+
+BoxArray::BoxArray() {
+	m_size = 0;
+}
+
+void BoxArray::Resize(size_t _size) {
+	// the padding holds empty boxes, never reported since the tests stop at m_size
+	size_t padded = (_size + 3) & ~static_cast <size_t> (3);
+	for (size_t axis = 0; axis < 3; axis++) {
+		m_centers[axis].resize(padded, 0.0f);
+		m_extents[axis].resize(padded, 0.0f);
+	}
+	m_size = _size;
+}
+
+void BoxArray::Set(size_t _index, DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub) {
+	const float* lb = &_lb.x, * ub = &_ub.x;
+	for (size_t axis = 0; axis < 3; axis++) {
+		m_centers[axis][_index] = 0.5f * (lb[axis] + ub[axis]);
+		m_extents[axis][_index] = 0.5f * (ub[axis] - lb[axis]);
+	}
+}
+
+void BoxArray::Push(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub) {
+	Resize(m_size + 1);
+	Set(m_size - 1, _lb, _ub);
+}
+
+//
+// ---------- class Frustum
+//
+
+Frustum::Frustum() {
+	Update(DirectX::XMMatrixIdentity());
+}
+
+Frustum::Frustum(DirectX::FXMMATRIX _viewProjection) {
+	Update(_viewProjection);
+}
+
+void Frustum::Update(DirectX::FXMMATRIX _viewProjection) {
+	// with row vectors clip = p * M, so the planes combine the columns of M
+	DirectX::XMMATRIX columns = DirectX::XMMatrixTranspose(_viewProjection);
+
+	DirectX::XMVECTOR planes[6] = {
+		DirectX::XMVectorAdd(columns.r[3], columns.r[0]),		// -w <= x
+		DirectX::XMVectorSubtract(columns.r[3], columns.r[0]),	// x <= w
+		DirectX::XMVectorAdd(columns.r[3], columns.r[1]),		// -w <= y
+		DirectX::XMVectorSubtract(columns.r[3], columns.r[1]),	// y <= w
+		columns.r[2],											// 0 <= z
+		DirectX::XMVectorSubtract(columns.r[3], columns.r[2])	// z <= w
+	};
+
+	for (size_t i = 0; i < 6; i++) {
+		DirectX::XMStoreFloat4(&m_planes[i], DirectX::XMPlaneNormalize(planes[i]));
+	}
+}
+
+bool Frustum::Intersects(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub) const {
+	DirectX::XMFLOAT3 center = { 0.5f * (_lb.x + _ub.x), 0.5f * (_lb.y + _ub.y), 0.5f * (_lb.z + _ub.z) };
+	DirectX::XMFLOAT3 extent = { 0.5f * (_ub.x - _lb.x), 0.5f * (_ub.y - _lb.y), 0.5f * (_ub.z - _lb.z) };
+
+	// the corner furthest along the normal decides, its distance is the center's plus the extents projected on |normal|
+	for (const DirectX::XMFLOAT4& plane : m_planes) {
+		float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w +
+			std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+		if (distance < 0.0f) return false;
+	}
+
+	return true;
+}
+
+size_t Frustum::Cull(const BoxArray& _boxes, std::vector <uint32_t>& _oVisible) const {
+	size_t count = _boxes.GetSize(), before = _oVisible.size();
+
+	// every plane component splatted, the four lanes hold four boxes
+	DirectX::XMVECTOR normal[6][3], absNormal[6][3], distance[6];
+	for (size_t p = 0; p < 6; p++) {
+		const float* plane = &m_planes[p].x;
+		for (size_t axis = 0; axis < 3; axis++) {
+			normal[p][axis] = DirectX::XMVectorReplicate(plane[axis]);
+			absNormal[p][axis] = DirectX::XMVectorReplicate(std::abs(plane[axis]));
+		}
+		distance[p] = DirectX::XMVectorReplicate(m_planes[p].w);
+	}
+
+	const float* centers[3] = { _boxes.GetCenters(0), _boxes.GetCenters(1), _boxes.GetCenters(2) };
+	const float* extents[3] = { _boxes.GetExtents(0), _boxes.GetExtents(1), _boxes.GetExtents(2) };
+	DirectX::XMVECTOR zero = DirectX::XMVectorZero();
+
+	for (size_t i = 0; i < count; i += 4) {
+		DirectX::XMVECTOR center[3], extent[3];
+		for (size_t axis = 0; axis < 3; axis++) {
+			center[axis] = DirectX::XMLoadFloat4(reinterpret_cast <const DirectX::XMFLOAT4*> (centers[axis] + i));
+			extent[axis] = DirectX::XMLoadFloat4(reinterpret_cast <const DirectX::XMFLOAT4*> (extents[axis] + i));
+		}
+
+		DirectX::XMVECTOR outside = DirectX::XMVectorFalseInt();
+		for (size_t p = 0; p < 6; p++) {
+			DirectX::XMVECTOR d = DirectX::XMVectorMultiplyAdd(center[0], normal[p][0], distance[p]);
+			d = DirectX::XMVectorMultiplyAdd(center[1], normal[p][1], d);
+			d = DirectX::XMVectorMultiplyAdd(center[2], normal[p][2], d);
+			d = DirectX::XMVectorMultiplyAdd(extent[0], absNormal[p][0], d);
+			d = DirectX::XMVectorMultiplyAdd(extent[1], absNormal[p][1], d);
+			d = DirectX::XMVectorMultiplyAdd(extent[2], absNormal[p][2], d);
+
+			outside = DirectX::XMVectorOrInt(outside, DirectX::XMVectorLess(d, zero));
+		}
+
+		uint32_t lanes[4];
+		DirectX::XMStoreInt4(lanes, outside);
+		for (size_t k = 0; k < 4 && i + k < count; k++) {
+			if (lanes[k] == 0) _oVisible.push_back(static_cast <uint32_t> (i + k));
+		}
+	}
+
+	return _oVisible.size() - before;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Elements/MinMaxOctree.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace Cass;
+
+MinMaxOctree::MinMaxOctree(const float* _samples, DirectX::XMUINT3 _res, uint32_t _brickSize) {
+	if (_samples == nullptr || _res.x < 2 || _res.y < 2 || _res.z < 2) {
+		throw std::invalid_argument("Volume needs at least 2 samples along each axis");
+	}
+
+	m_brickSize = std::max(_brickSize, 1U);
+
+	DirectX::XMUINT3 dims = {
+		(_res.x - 2U) / m_brickSize + 1U,
+		(_res.y - 2U) / m_brickSize + 1U,
+		(_res.z - 2U) / m_brickSize + 1U
+	};
+
+	// bricks, a brick includes the samples on its upper faces so that every cell lies within one brick
+	std::vector <DirectX::XMFLOAT2> bricks(static_cast <size_t> (dims.x) * dims.y * dims.z);
+	ParallelFor(0, dims.z, [&](size_t _begin, size_t _end) {
+		for (uint32_t bz = static_cast <uint32_t> (_begin); bz < _end; bz++) {
+			for (uint32_t by = 0; by < dims.y; by++) {
+				for (uint32_t bx = 0; bx < dims.x; bx++) {
+					float lo = std::numeric_limits <float>::max(), hi = std::numeric_limits <float>::lowest();
+
+					uint32_t z1 = std::min((bz + 1U) * m_brickSize, _res.z - 1U);
+					uint32_t y1 = std::min((by + 1U) * m_brickSize, _res.y - 1U);
+					uint32_t x1 = std::min((bx + 1U) * m_brickSize, _res.x - 1U);
+					for (uint32_t z = bz * m_brickSize; z <= z1; z++) {
+						for (uint32_t y = by * m_brickSize; y <= y1; y++) {
+							const float* row = _samples + (static_cast <size_t> (z) * _res.y + y) * _res.x;
+							for (uint32_t x = bx * m_brickSize; x <= x1; x++) {
+								lo = std::min(lo, row[x]);
+								hi = std::max(hi, row[x]);
+							}
+						}
+					}
+
+					bricks[(static_cast <size_t> (bz) * dims.y + by) * dims.x + bx] = { lo, hi };
+				}
+			}
+		}
+	});
+
+	m_levels.push_back(std::move(bricks));
+	m_levelDims.push_back(dims);
+
+	// merge 2x2x2 nodes until a single root is left
+	while (dims.x > 1 || dims.y > 1 || dims.z > 1) {
+		const std::vector <DirectX::XMFLOAT2>& below = m_levels.back();
+		DirectX::XMUINT3 belowDims = dims;
+		dims = { (dims.x + 1U) / 2U, (dims.y + 1U) / 2U, (dims.z + 1U) / 2U };
+
+		std::vector <DirectX::XMFLOAT2> level(static_cast <size_t> (dims.x) * dims.y * dims.z);
+		for (uint32_t z = 0; z < dims.z; z++) {
+			for (uint32_t y = 0; y < dims.y; y++) {
+				for (uint32_t x = 0; x < dims.x; x++) {
+					DirectX::XMFLOAT2 range = { std::numeric_limits <float>::max(), std::numeric_limits <float>::lowest() };
+
+					for (uint32_t c = 0; c < 8; c++) {
+						uint32_t cx = x * 2U + (c & 1U), cy = y * 2U + (c >> 1 & 1U), cz = z * 2U + (c >> 2 & 1U);
+						if (cx >= belowDims.x || cy >= belowDims.y || cz >= belowDims.z) continue;
+
+						const DirectX::XMFLOAT2& child = below[(static_cast <size_t> (cz) * belowDims.y + cy) * belowDims.x + cx];
+						range.x = std::min(range.x, child.x);
+						range.y = std::max(range.y, child.y);
+					}
+
+					level[(static_cast <size_t> (z) * dims.y + y) * dims.x + x] = range;
+				}
+			}
+		}
+
+		m_levels.push_back(std::move(level));
+		m_levelDims.push_back(dims);
+	}
+}
+
+void MinMaxOctree::Query(float _isoValue, uint32_t _z0, uint32_t _z1, std::vector <DirectX::XMUINT3>& _oBricks) const {
+	if (_z1 <= _z0) return;
+
+	Visit(m_levels.size() - 1, 0, 0, 0, _isoValue, _z0, _z1, _oBricks);
+}
+
+void MinMaxOctree::Visit(size_t _level, uint32_t _x, uint32_t _y, uint32_t _z, float _isoValue, uint32_t _z0, uint32_t _z1, std::vector <DirectX::XMUINT3>& _oBricks) const {
+	const DirectX::XMUINT3& dims = m_levelDims[_level];
+	if (_x >= dims.x || _y >= dims.y || _z >= dims.z) return;
+
+	// cell layers covered by the node
+	uint64_t span = static_cast <uint64_t> (m_brickSize) << _level;
+	if (_z * span >= _z1 || (_z + 1U) * span <= _z0) return;
+
+	// a cell is crossed if some corner lies below the iso value and another one doesn't
+	const DirectX::XMFLOAT2& range = m_levels[_level][(static_cast <size_t> (_z) * dims.y + _y) * dims.x + _x];
+	if (!(range.x < _isoValue && range.y >= _isoValue)) return;
+
+	if (_level == 0) {
+		_oBricks.push_back({ _x, _y, _z });
+		return;
+	}
+
+	for (uint32_t c = 0; c < 8; c++) {
+		Visit(_level - 1, _x * 2U + (c & 1U), _y * 2U + (c >> 1 & 1U), _z * 2U + (c >> 2 & 1U), _isoValue, _z0, _z1, _oBricks);
+	}
+}
\ No newline at end of file
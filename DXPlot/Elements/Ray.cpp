@@ -1,28 +1,44 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
 #include <Elements/Ray.hpp>
 #include <util.hpp>
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 using namespace Cass;
 
 Ray::Ray(DirectX::XMFLOAT3 _origin, DirectX::XMFLOAT3 _dir) {
-	m_origin = _origin;
-	m_dir = _dir;
-
-	if (_dir.x == 0.0f && _dir.y == 0.0f && _dir.z == 0.0f) return;
-	DirectX::XMVECTOR dir_vec = DirectX::XMLoadFloat3(&_dir);
-	DirectX::XMStoreFloat3(&m_dir, DirectX::XMVector3Normalize(dir_vec));
+	Update(_origin, _dir);
 }
 
 void Ray::Update(DirectX::XMFLOAT3 _origin = { 0.0f, 0.0f, 0.0f }, DirectX::XMFLOAT3 _dir = { 0.0f, 0.0f, 0.0f }) {
 	m_origin = _origin;
 	m_dir = _dir;
+	m_invDir = { 0.0f, 0.0f, 0.0f };
 
 	if (_dir.x == 0.0f && _dir.y == 0.0f && _dir.z == 0.0f) return;
-	DirectX::XMVECTOR dir_vec = DirectX::XMLoadFloat3(&_dir);
-	DirectX::XMStoreFloat3(&m_dir, DirectX::XMVector3Normalize(dir_vec));
+	DirectX::XMVECTOR dir_vec = DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&_dir));
+	DirectX::XMStoreFloat3(&m_dir, dir_vec);
+
+	// axes the ray runs parallel to get a huge but finite reciprocal, an infinite one would give 0 * inf = NaN
+	// in the slab test for an origin lying on one of the slab's planes
+	DirectX::XMFLOAT3 dir;
+	DirectX::XMStoreFloat3(&dir, dir_vec);
+	auto reciprocal = [](float _v) { return 1.0f / (_v != 0.0f ? _v : std::copysign(FLT_MIN, _v)); };
+	m_invDir = { reciprocal(dir.x), reciprocal(dir.y), reciprocal(dir.z) };
 }
 
 bool Ray::IntersectTriangle(DirectX::XMFLOAT3 _a, DirectX::XMFLOAT3 _b, DirectX::XMFLOAT3 _c) const {
-	if (m_dir.x == 0.0f && m_dir.y == 0.0f && m_dir.z == 0.0f) return false;
+	float distance;
+	return IntersectTriangle(_a, _b, _c, distance);
+}
+
+bool Ray::IntersectTriangle(DirectX::XMFLOAT3 _a, DirectX::XMFLOAT3 _b, DirectX::XMFLOAT3 _c, float& _oDistance) const {
+	if (!IsValid()) return false;
 
 	// Moller-Trumbore ray-triangle intersection
 
@@ -47,7 +63,73 @@ bool Ray::IntersectTriangle(DirectX::XMFLOAT3 _a, DirectX::XMFLOAT3 _b, DirectX:
 	if (v < 0.0f || u + v > 1.0f) return false;
 
 	float t = f * DirectX::XMVectorGetX(DirectX::XMVector3Dot(edge2, q));
-	if (t > EPSILON) return true;
+	if (t <= EPSILON) return false;
+
+	_oDistance = t;
+	return true;
+}
+
+bool Ray::IntersectBox(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, float& _oNear, float& _oFar) const {
+	if (!IsValid()) return false;
+
+	// distances to both planes of every slab, ordered per axis without branching
+	DirectX::XMVECTOR origin = DirectX::XMLoadFloat3(&m_origin), invDir = DirectX::XMLoadFloat3(&m_invDir);
+	DirectX::XMVECTOR t0 = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&_lb), origin), invDir);
+	DirectX::XMVECTOR t1 = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&_ub), origin), invDir);
+
+	DirectX::XMFLOAT3 tMin, tMax;
+	DirectX::XMStoreFloat3(&tMin, DirectX::XMVectorMin(t0, t1));
+	DirectX::XMStoreFloat3(&tMax, DirectX::XMVectorMax(t0, t1));
+
+	// on an axis the ray runs parallel to, a plane through the origin gives 0 instead of an unbounded distance,
+	// the slab is then either never left or never entered, so a ray in the plane of any face still touches the box
+	auto parallel = [](float _dir, float _origin, float _lb, float _ub, float& _oMin, float& _oMax) {
+		if (_dir != 0.0f) return true;
+		_oMin = -FLT_MAX;
+		_oMax = FLT_MAX;
+		return _origin >= _lb && _origin <= _ub;
+	};
+	if (!parallel(m_dir.x, m_origin.x, _lb.x, _ub.x, tMin.x, tMax.x) || !parallel(m_dir.y, m_origin.y, _lb.y, _ub.y, tMin.y, tMax.y) ||
+		!parallel(m_dir.z, m_origin.z, _lb.z, _ub.z, tMin.z, tMax.z)) return false;
+
+	// the ray is inside the box where it is inside all three slabs
+	_oNear = std::max(std::max(tMin.x, tMin.y), tMin.z);
+	_oFar = std::min(std::min(tMax.x, tMax.y), tMax.z);
+
+	return _oFar >= std::max(_oNear, 0.0f);
+}
+
+bool Ray::IntersectSphere(DirectX::XMFLOAT3 _center, float _radius, float& _oDistance) const {
+	if (!IsValid()) return false;
+
+	// |o + t * d - c|^2 = r^2 with |d| = 1
+	DirectX::XMVECTOR offset = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&m_origin), DirectX::XMLoadFloat3(&_center));
+	float b = DirectX::XMVectorGetX(DirectX::XMVector3Dot(offset, DirectX::XMLoadFloat3(&m_dir)));
+	float c = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(offset)) - _radius * _radius;
+
+	float discriminant = b * b - c;
+	if (discriminant < 0.0f) return false;
+
+	float root = std::sqrt(discriminant);
+	float t = -b - root;
+	if (t < 0.0f) t = -b + root;
+	if (t < 0.0f) return false;
+
+	_oDistance = t;
+	return true;
+}
+
+bool Ray::IntersectPlane(DirectX::XMFLOAT3 _point, DirectX::XMFLOAT3 _normal, float& _oDistance) const {
+	if (!IsValid()) return false;
+
+	DirectX::XMVECTOR normal = DirectX::XMLoadFloat3(&_normal);
+	float denominator = DirectX::XMVectorGetX(DirectX::XMVector3Dot(normal, DirectX::XMLoadFloat3(&m_dir)));
+	if (denominator == 0.0f) return false;
+
+	DirectX::XMVECTOR offset = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&_point), DirectX::XMLoadFloat3(&m_origin));
+	float t = DirectX::XMVectorGetX(DirectX::XMVector3Dot(offset, normal)) / denominator;
+	if (t < 0.0f) return false;
 
-	return false;
+	_oDistance = t;
+	return true;
 }
\ No newline at end of file
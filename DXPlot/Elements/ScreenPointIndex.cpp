@@ -0,0 +1,203 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Elements/ScreenPointIndex.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Cass;
+
+namespace {
+	// points projected by one thread
+	const size_t s_minBlock = 16384;
+}
+
+//
+// ---------- class ScreenPointIndex
+//
+
+ScreenPointIndex::ScreenPointIndex(float _cellSize) {
+	m_cellSize = std::max(_cellSize, 1.0f);
+	m_columns = m_rows = 0;
+
+	m_valid = false;
+	DirectX::XMStoreFloat4x4(&m_lastTransform, DirectX::XMMatrixIdentity());
+	m_lastViewport = { 0.0f, 0.0f };
+	m_lastPoints = nullptr;
+	m_lastCount = 0;
+}
+
+bool ScreenPointIndex::Update(const CameraFrame& _frame, DirectX::FXMMATRIX _model, const DirectX::XMFLOAT3* _points, size_t _count, size_t _stride) {
+	DirectX::XMMATRIX toClip = DirectX::XMMatrixMultiply(_model, _frame.GetViewProjection());
+	if (!Changed(toClip, _frame.GetViewportSize(), _points, _count)) return false;
+
+	Build(toClip, _frame.GetViewportSize(), reinterpret_cast <const uint8_t*> (_points), _count, _stride, false);
+	return true;
+}
+
+bool ScreenPointIndex::Update(const CameraFrame& _frame, DirectX::FXMMATRIX _model, const DirectX::XMFLOAT2* _points, size_t _count) {
+	DirectX::XMMATRIX toClip = DirectX::XMMatrixMultiply(_model, _frame.GetViewProjection());
+	if (!Changed(toClip, _frame.GetViewportSize(), _points, _count)) return false;
+
+	Build(toClip, _frame.GetViewportSize(), reinterpret_cast <const uint8_t*> (_points), _count, sizeof(DirectX::XMFLOAT2), true);
+	return true;
+}
+
+uint32_t ScreenPointIndex::Nearest(float _x, float _y, float _radius, float& _oDistance) const {
+	uint32_t x0, y0, x1, y1;
+	if (!GetCellRange(_x, _y, _radius, x0, y0, x1, y1)) return s_nullPoint;
+
+	uint32_t nearest = s_nullPoint;
+	float best = _radius * _radius;
+	for (uint32_t row = y0; row <= y1; row++) {
+		// the cells of a row are contiguous, so are their entries
+		uint32_t first = m_cellStarts[row * m_columns + x0], last = m_cellStarts[row * m_columns + x1 + 1];
+		for (uint32_t i = first; i < last; i++) {
+			float dx = m_cellPositions[i].x - _x, dy = m_cellPositions[i].y - _y;
+			float d = dx * dx + dy * dy;
+
+			// ties go to the lower index, so the answer doesn't depend on the grid
+			if (d < best || (d == best && m_cellPoints[i] < nearest)) {
+				best = d;
+				nearest = m_cellPoints[i];
+			}
+		}
+	}
+
+	if (nearest != s_nullPoint) _oDistance = std::sqrt(best);
+	return nearest;
+}
+
+size_t ScreenPointIndex::WithinRadius(float _x, float _y, float _radius, std::vector <uint32_t>& _oPoints) const {
+	uint32_t x0, y0, x1, y1;
+	if (!GetCellRange(_x, _y, _radius, x0, y0, x1, y1)) return 0;
+
+	size_t before = _oPoints.size();
+	float radiusSq = _radius * _radius;
+	for (uint32_t row = y0; row <= y1; row++) {
+		uint32_t first = m_cellStarts[row * m_columns + x0], last = m_cellStarts[row * m_columns + x1 + 1];
+		for (uint32_t i = first; i < last; i++) {
+			float dx = m_cellPositions[i].x - _x, dy = m_cellPositions[i].y - _y;
+			if (dx * dx + dy * dy <= radiusSq) _oPoints.push_back(m_cellPoints[i]);
+		}
+	}
+
+	return _oPoints.size() - before;
+}
+
+bool ScreenPointIndex::Changed(DirectX::FXMMATRIX _toClip, DirectX::XMFLOAT2 _viewport, const void* _points, size_t _count) const {
+	DirectX::XMFLOAT4X4 transform;
+	DirectX::XMStoreFloat4x4(&transform, _toClip);
+
+	return !m_valid || _points != m_lastPoints || _count != m_lastCount || memcmp(&transform, &m_lastTransform, sizeof(transform)) != 0 ||
+		_viewport.x != m_lastViewport.x || _viewport.y != m_lastViewport.y;
+}
+
+void ScreenPointIndex::Build(DirectX::FXMMATRIX _toClip, DirectX::XMFLOAT2 _viewport, const uint8_t* _points, size_t _count, size_t _stride, bool _planar) {
+	DirectX::XMStoreFloat4x4(&m_lastTransform, _toClip);
+	m_lastViewport = _viewport;
+	m_lastPoints = _points;
+	m_lastCount = _count;
+	m_valid = true;
+
+	m_columns = _viewport.x > 0.0f ? static_cast <uint32_t> (std::ceil(_viewport.x / m_cellSize)) : 0;
+	m_rows = _viewport.y > 0.0f ? static_cast <uint32_t> (std::ceil(_viewport.y / m_cellSize)) : 0;
+	m_cellStarts.assign(static_cast <size_t> (m_columns) * m_rows + 1, 0);
+	m_cellPoints.clear();
+	m_cellPositions.clear();
+	if (m_columns == 0 || m_rows == 0 || _count == 0) return;
+
+	m_cellOf.resize(_count);
+	m_positions.resize(_count);
+
+	// every matrix element splatted, the four lanes hold four points
+	const DirectX::XMFLOAT4X4& m = m_lastTransform;
+	DirectX::XMVECTOR m11 = DirectX::XMVectorReplicate(m._11), m21 = DirectX::XMVectorReplicate(m._21), m31 = DirectX::XMVectorReplicate(m._31), m41 = DirectX::XMVectorReplicate(m._41);
+	DirectX::XMVECTOR m12 = DirectX::XMVectorReplicate(m._12), m22 = DirectX::XMVectorReplicate(m._22), m32 = DirectX::XMVectorReplicate(m._32), m42 = DirectX::XMVectorReplicate(m._42);
+	DirectX::XMVECTOR m14 = DirectX::XMVectorReplicate(m._14), m24 = DirectX::XMVectorReplicate(m._24), m34 = DirectX::XMVectorReplicate(m._34), m44 = DirectX::XMVectorReplicate(m._44);
+
+	// ndc to pixels, y pointing down
+	DirectX::XMVECTOR halfWidth = DirectX::XMVectorReplicate(0.5f * _viewport.x), halfHeight = DirectX::XMVectorReplicate(-0.5f * _viewport.y);
+	DirectX::XMVECTOR centerX = DirectX::XMVectorReplicate(0.5f * _viewport.x), centerY = DirectX::XMVectorReplicate(0.5f * _viewport.y);
+
+	float cellScale = 1.0f / m_cellSize;
+	ParallelFor(0, _count, [&](size_t _first, size_t _last) {
+		for (size_t i = _first; i < _last; i += 4) {
+			size_t lanes = std::min(_last - i, static_cast <size_t> (4));
+
+			float x[4] = {}, y[4] = {}, z[4] = {};
+			for (size_t k = 0; k < lanes; k++) {
+				const float* p = reinterpret_cast <const float*> (_points + (i + k) * _stride);
+				x[k] = p[0];
+				y[k] = p[1];
+				z[k] = _planar ? 0.0f : p[2];
+			}
+
+			DirectX::XMVECTOR px = DirectX::XMLoadFloat4(reinterpret_cast <const DirectX::XMFLOAT4*> (x));
+			DirectX::XMVECTOR py = DirectX::XMLoadFloat4(reinterpret_cast <const DirectX::XMFLOAT4*> (y));
+			DirectX::XMVECTOR pz = DirectX::XMLoadFloat4(reinterpret_cast <const DirectX::XMFLOAT4*> (z));
+
+			DirectX::XMVECTOR clipX = DirectX::XMVectorMultiplyAdd(pz, m31, DirectX::XMVectorMultiplyAdd(py, m21, DirectX::XMVectorMultiplyAdd(px, m11, m41)));
+			DirectX::XMVECTOR clipY = DirectX::XMVectorMultiplyAdd(pz, m32, DirectX::XMVectorMultiplyAdd(py, m22, DirectX::XMVectorMultiplyAdd(px, m12, m42)));
+			DirectX::XMVECTOR clipW = DirectX::XMVectorMultiplyAdd(pz, m34, DirectX::XMVectorMultiplyAdd(py, m24, DirectX::XMVectorMultiplyAdd(px, m14, m44)));
+
+			DirectX::XMVECTOR invW = DirectX::XMVectorReciprocal(clipW);
+			DirectX::XMFLOAT4 sx, sy, w;
+			DirectX::XMStoreFloat4(&sx, DirectX::XMVectorMultiplyAdd(DirectX::XMVectorMultiply(clipX, invW), halfWidth, centerX));
+			DirectX::XMStoreFloat4(&sy, DirectX::XMVectorMultiplyAdd(DirectX::XMVectorMultiply(clipY, invW), halfHeight, centerY));
+			DirectX::XMStoreFloat4(&w, clipW);
+
+			const float* screenX = &sx.x, * screenY = &sy.x, * clipWs = &w.x;
+			for (size_t k = 0; k < lanes; k++) {
+				m_positions[i + k] = { screenX[k], screenY[k] };
+
+				// NaNs from degenerate points fail these tests as well
+				bool visible = clipWs[k] > 0.0f && screenX[k] >= 0.0f && screenX[k] < _viewport.x && screenY[k] >= 0.0f && screenY[k] < _viewport.y;
+				if (!visible) {
+					m_cellOf[i + k] = s_nullPoint;
+					continue;
+				}
+
+				uint32_t column = std::min(static_cast <uint32_t> (screenX[k] * cellScale), m_columns - 1);
+				uint32_t row = std::min(static_cast <uint32_t> (screenY[k] * cellScale), m_rows - 1);
+				m_cellOf[i + k] = row * m_columns + column;
+			}
+		}
+	}, s_minBlock);
+
+	// counting sort by cell, points keep their order within a cell
+	for (size_t i = 0; i < _count; i++) {
+		if (m_cellOf[i] != s_nullPoint) m_cellStarts[m_cellOf[i] + 1]++;
+	}
+	for (size_t c = 1; c < m_cellStarts.size(); c++) m_cellStarts[c] += m_cellStarts[c - 1];
+
+	m_cellPoints.resize(m_cellStarts.back());
+	m_cellPositions.resize(m_cellStarts.back());
+	std::vector <uint32_t> next(m_cellStarts.begin(), m_cellStarts.end() - 1);
+	for (size_t i = 0; i < _count; i++) {
+		if (m_cellOf[i] == s_nullPoint) continue;
+
+		uint32_t slot = next[m_cellOf[i]]++;
+		m_cellPoints[slot] = static_cast <uint32_t> (i);
+		m_cellPositions[slot] = m_positions[i];
+	}
+}
+
+bool ScreenPointIndex::GetCellRange(float _x, float _y, float _radius, uint32_t& _oX0, uint32_t& _oY0, uint32_t& _oX1, uint32_t& _oY1) const {
+	if (m_columns == 0 || m_rows == 0 || !(_radius >= 0.0f)) return false;
+
+	float cellScale = 1.0f / m_cellSize;
+	float x0 = std::floor((_x - _radius) * cellScale), x1 = std::floor((_x + _radius) * cellScale);
+	float y0 = std::floor((_y - _radius) * cellScale), y1 = std::floor((_y + _radius) * cellScale);
+	if (x1 < 0.0f || y1 < 0.0f || x0 >= static_cast <float> (m_columns) || y0 >= static_cast <float> (m_rows)) return false;
+
+	_oX0 = static_cast <uint32_t> (std::max(x0, 0.0f));
+	_oY0 = static_cast <uint32_t> (std::max(y0, 0.0f));
+	_oX1 = static_cast <uint32_t> (std::min(x1, static_cast <float> (m_columns - 1)));
+	_oY1 = static_cast <uint32_t> (std::min(y1, static_cast <float> (m_rows - 1)));
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,364 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Elements/SeriesPyramid.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Cass;
+
+namespace {
+	const char s_magic[4] = { 'C', 'S', 'P', 'Y' };
+	const uint32_t s_version = 1;
+	const uint32_t s_maxLevels = 64;
+
+	// bytes collected per output before they go to the file
+	const size_t s_bufferSize = 1 << 20;
+
+	/*
+	* start of the file, the samples follow right after it and the summary levels after them, finest first
+	*/
+	struct FILE_HEADER {
+		char magic[4];
+		uint32_t version;
+		uint32_t fanout;
+		uint32_t levelCount;
+		double start, step;
+		uint64_t sampleCount;
+		uint64_t offsets[s_maxLevels];
+		uint64_t counts[s_maxLevels];
+	};
+
+	size_t RecordSize(size_t _level) {
+		return _level == 0 ? sizeof(float) : sizeof(SeriesPyramid::Bucket);
+	}
+}
+
+//
+// ---------- class SeriesPyramid
+//
+
+SeriesPyramid::SeriesPyramid() {
+	m_start = 0.0;
+	m_step = 1.0;
+	m_sampleCount = 0;
+	m_fanout = 0;
+}
+
+HRESULT SeriesPyramid::Open(LPCWSTR _fileName) {
+	m_levels.clear();
+	m_sampleCount = 0;
+
+	HRESULT hr = m_file.Open(_fileName);
+	if (FAILED(hr)) return hr;
+
+	auto corrupt = [this]() {
+		m_file.Close();
+		m_levels.clear();
+		return HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT);
+	};
+
+	if (m_file.GetSize() < sizeof(FILE_HEADER)) return corrupt();
+
+	FILE_HEADER header;
+	memcpy(&header, m_file.GetData(), sizeof(header));
+	if (memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 || header.version != s_version) return corrupt();
+	if (header.fanout < 2 || header.levelCount == 0 || header.levelCount > s_maxLevels) return corrupt();
+
+	// every level has to be where the header says and exactly as long as the level below implies
+	uint64_t count = header.sampleCount, samples = 1;
+	for (uint32_t level = 0; level < header.levelCount; level++) {
+		uint64_t offset = header.offsets[level];
+		if (header.counts[level] != count || offset % sizeof(float) != 0 || offset > m_file.GetSize()) return corrupt();
+		if ((m_file.GetSize() - offset) / RecordSize(level) < count) return corrupt();
+
+		m_levels.push_back({ offset, count, samples });
+
+		count = (count + header.fanout - 1) / header.fanout;
+		samples = samples > UINT64_MAX / header.fanout ? UINT64_MAX : samples * header.fanout;
+	}
+	if (m_levels.back().count > 1) return corrupt();
+
+	m_start = header.start;
+	m_step = header.step;
+	m_sampleCount = header.sampleCount;
+	m_fanout = header.fanout;
+
+	return S_OK;
+}
+
+const float* SeriesPyramid::GetSamples() const {
+	return reinterpret_cast <const float*> (m_file.GetData() + m_levels[0].offset);
+}
+
+const SeriesPyramid::Bucket* SeriesPyramid::GetBuckets(uint32_t _level) const {
+	return reinterpret_cast <const Bucket*> (m_file.GetData() + m_levels[_level].offset);
+}
+
+uint32_t SeriesPyramid::SelectLevel(double _samplesPerPixel) const {
+	uint32_t level = 0;
+	while (level + 1 < m_levels.size() && static_cast <double> (m_levels[level + 1].samples) <= _samplesPerPixel) level++;
+
+	return level;
+}
+
+uint32_t SeriesPyramid::Query(double _t0, double _t1, uint32_t _pixelWidth, std::vector <Bucket>& _oBuckets, uint64_t& _oFirst) const {
+	_oBuckets.clear();
+	_oFirst = 0;
+	if (m_sampleCount == 0) return 0;
+
+	if (_t1 < _t0) std::swap(_t0, _t1);
+
+	// clamped while still in floating point, a range far outside the series would overflow the indices
+	double last = static_cast <double> (m_sampleCount - 1);
+	double first = std::floor((_t0 - m_start) / m_step), end = std::ceil((_t1 - m_start) / m_step);
+	if (m_step < 0.0) std::swap(first, end);
+
+	uint64_t i0 = static_cast <uint64_t> (std::clamp(first, 0.0, last));
+	uint64_t i1 = static_cast <uint64_t> (std::clamp(end, 0.0, last)) + 1;
+
+	uint32_t level = SelectLevel(static_cast <double> (i1 - i0) / std::max(1u, _pixelWidth));
+	const Level& source = m_levels[level];
+
+	// one bucket past each end so the line leaves the screen instead of stopping short
+	uint64_t b0 = i0 / source.samples, b1 = (i1 - 1) / source.samples + 1;
+	b0 = b0 > 0 ? b0 - 1 : 0;
+	b1 = std::min(b1 + 1, source.count);
+
+	_oFirst = b0 * source.samples;
+	_oBuckets.resize(static_cast <size_t> (b1 - b0));
+
+	if (level == 0) {
+		const float* samples = GetSamples() + b0;
+		for (size_t i = 0; i < _oBuckets.size(); i++) _oBuckets[i] = { samples[i], samples[i], samples[i] };
+	}
+	else {
+		memcpy(_oBuckets.data(), GetBuckets(level) + b0, _oBuckets.size() * sizeof(Bucket));
+	}
+
+	return level;
+}
+
+//
+// ---------- class SeriesPyramidWriter
+//
+
+SeriesPyramidWriter::SeriesPyramidWriter() {
+	m_start = 0.0;
+	m_step = 1.0;
+	m_fanout = 0;
+	m_sampleCount = 0;
+}
+
+SeriesPyramidWriter::~SeriesPyramidWriter() {
+	Close();
+}
+
+HRESULT SeriesPyramidWriter::Create(LPCWSTR _fileName, double _start, double _step, uint32_t _fanout) {
+	Close();
+	if (_fanout < 2) return E_INVALIDARG;
+
+	m_fileName = _fileName;
+	m_start = _start;
+	m_step = _step;
+	m_fanout = _fanout;
+	m_sampleCount = 0;
+
+	HANDLE file = CreateFileW(_fileName, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return HRESULT_FROM_WIN32(GetLastError());
+
+	m_levels.push_back({ { file, {} }, 0, 0.0f, 0.0f, 0.0, 0, 0 });
+	m_levels[0].output.buffer.reserve(s_bufferSize);
+
+	// the header is only known at the end, an unfinished file fails to open instead of reading garbage
+	FILE_HEADER header = {};
+	return Write(m_levels[0].output, &header, sizeof(header));
+}
+
+HRESULT SeriesPyramidWriter::Append(const float* _values, size_t _count) {
+	if (m_levels.empty()) return E_UNEXPECTED;
+
+	HRESULT hr = Write(m_levels[0].output, _values, _count * sizeof(float));
+	if (FAILED(hr)) return hr;
+
+	for (size_t i = 0; i < _count; i++) {
+		hr = Push(1, _values[i], _values[i], _values[i], 1);
+		if (FAILED(hr)) return hr;
+	}
+
+	m_levels[0].count += _count;
+	m_sampleCount += _count;
+
+	return S_OK;
+}
+
+HRESULT SeriesPyramidWriter::Finish() {
+	if (m_levels.empty()) return E_UNEXPECTED;
+
+	// closing the partial buckets bottom up, the level left with a single bucket is the top one
+	size_t levelCount = m_levels.size();
+	for (size_t level = 1; level < m_levels.size(); level++) {
+		if (m_levels[level].children > 0) {
+			HRESULT hr = Emit(level);
+			if (FAILED(hr)) return hr;
+		}
+		if (m_levels[level].count <= 1) {
+			levelCount = level + 1;
+			break;
+		}
+	}
+	if (levelCount > s_maxLevels) return HRESULT_FROM_WIN32(ERROR_FILE_TOO_LARGE);
+
+	FILE_HEADER header = {};
+	memcpy(header.magic, s_magic, sizeof(s_magic));
+	header.version = s_version;
+	header.fanout = m_fanout;
+	header.levelCount = static_cast <uint32_t> (levelCount);
+	header.start = m_start;
+	header.step = m_step;
+	header.sampleCount = m_sampleCount;
+
+	uint64_t offset = sizeof(FILE_HEADER);
+	for (size_t level = 0; level < levelCount; level++) {
+		header.offsets[level] = offset;
+		header.counts[level] = m_levels[level].count;
+		offset += m_levels[level].count * RecordSize(level);
+	}
+
+	// append the spooled levels behind the samples
+	Output& output = m_levels[0].output;
+	std::vector <uint8_t> chunk(s_bufferSize);
+	for (size_t level = 1; level < levelCount; level++) {
+		Output& spool = m_levels[level].output;
+
+		HRESULT hr = Flush(spool);
+		if (FAILED(hr)) return hr;
+
+		LARGE_INTEGER zero = {};
+		if (!SetFilePointerEx(spool.file, zero, nullptr, FILE_BEGIN)) return HRESULT_FROM_WIN32(GetLastError());
+
+		for (uint64_t left = m_levels[level].count * sizeof(SeriesPyramid::Bucket); left > 0;) {
+			DWORD read = 0;
+			DWORD size = static_cast <DWORD> (std::min <uint64_t> (left, chunk.size()));
+			if (!ReadFile(spool.file, chunk.data(), size, &read, nullptr)) return HRESULT_FROM_WIN32(GetLastError());
+			if (read == 0) return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+
+			hr = Write(output, chunk.data(), read);
+			if (FAILED(hr)) return hr;
+			left -= read;
+		}
+	}
+
+	HRESULT hr = Flush(output);
+	if (FAILED(hr)) return hr;
+
+	LARGE_INTEGER zero = {};
+	if (!SetFilePointerEx(output.file, zero, nullptr, FILE_BEGIN)) return HRESULT_FROM_WIN32(GetLastError());
+
+	hr = Write(output, &header, sizeof(header));
+	if (FAILED(hr)) return hr;
+	hr = Flush(output);
+	if (FAILED(hr)) return hr;
+
+	Close();
+	return S_OK;
+}
+
+HRESULT SeriesPyramidWriter::Write(Output& _output, const void* _data, size_t _size) {
+	if (_output.buffer.size() + _size > s_bufferSize) {
+		HRESULT hr = Flush(_output);
+		if (FAILED(hr)) return hr;
+	}
+
+	// large blocks skip the buffer
+	if (_size >= s_bufferSize) {
+		const uint8_t* data = static_cast <const uint8_t*> (_data);
+		while (_size > 0) {
+			DWORD written = 0;
+			DWORD size = static_cast <DWORD> (std::min <size_t> (_size, s_bufferSize));
+			if (!WriteFile(_output.file, data, size, &written, nullptr)) return HRESULT_FROM_WIN32(GetLastError());
+
+			data += written;
+			_size -= written;
+		}
+		return S_OK;
+	}
+
+	const uint8_t* data = static_cast <const uint8_t*> (_data);
+	_output.buffer.insert(_output.buffer.end(), data, data + _size);
+	return S_OK;
+}
+
+HRESULT SeriesPyramidWriter::Flush(Output& _output) {
+	size_t done = 0;
+	while (done < _output.buffer.size()) {
+		DWORD written = 0;
+		DWORD size = static_cast <DWORD> (_output.buffer.size() - done);
+		if (!WriteFile(_output.file, _output.buffer.data() + done, size, &written, nullptr)) return HRESULT_FROM_WIN32(GetLastError());
+
+		done += written;
+	}
+
+	_output.buffer.clear();
+	return S_OK;
+}
+
+HRESULT SeriesPyramidWriter::Push(size_t _level, float _min, float _max, double _sum, uint64_t _samples) {
+	if (_level == m_levels.size()) {
+		// spooled next to the output, the system removes it once the handle is closed
+		std::wstring name = m_fileName + L"." + std::to_wstring(_level) + L".tmp";
+		HANDLE file = CreateFileW(
+			name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+			FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr
+		);
+		if (file == INVALID_HANDLE_VALUE) return HRESULT_FROM_WIN32(GetLastError());
+
+		m_levels.push_back({ { file, {} }, 0, 0.0f, 0.0f, 0.0, 0, 0 });
+	}
+
+	Level& level = m_levels[_level];
+	if (level.children == 0) {
+		level.min = _min;
+		level.max = _max;
+	}
+	else {
+		level.min = std::min(level.min, _min);
+		level.max = std::max(level.max, _max);
+	}
+	level.sum += _sum;
+	level.samples += _samples;
+
+	return ++level.children == m_fanout ? Emit(_level) : S_OK;
+}
+
+HRESULT SeriesPyramidWriter::Emit(size_t _level) {
+	Level& level = m_levels[_level];
+
+	float min = level.min, max = level.max;
+	double sum = level.sum;
+	uint64_t samples = level.samples;
+
+	SeriesPyramid::Bucket bucket = { min, max, static_cast <float> (sum / static_cast <double> (samples)) };
+	HRESULT hr = Write(level.output, &bucket, sizeof(bucket));
+	if (FAILED(hr)) return hr;
+
+	level.count++;
+	level.sum = 0.0;
+	level.samples = 0;
+	level.children = 0;
+
+	// the level above may be created here, which moves the levels
+	return Push(_level + 1, min, max, sum, samples);
+}
+
+void SeriesPyramidWriter::Close() {
+	for (Level& level : m_levels) {
+		if (level.output.file != INVALID_HANDLE_VALUE) CloseHandle(level.output.file);
+	}
+	m_levels.clear();
+}
\ No newline at end of file
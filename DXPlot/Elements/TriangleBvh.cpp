@@ -0,0 +1,399 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Elements/TriangleBvh.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+using namespace Cass;
+
+namespace {
+	const uint32_t s_binCount = 16;
+
+	// ranges up to the first size always become leaves, up to the second unless the heuristic finds a cheaper split
+	const uint32_t s_minLeafSize = 4;
+	const uint32_t s_maxLeafSize = 8;
+
+	// keeps the traversal stack bounded on degenerate input
+	const uint32_t s_maxDepth = 60;
+
+	// ranges binned on several threads, and the smallest subtree handed to a thread of its own
+	const size_t s_parallelBinning = 1 << 16;
+	const size_t s_minTask = 1 << 12;
+
+	struct Box {
+		DirectX::XMFLOAT3 lb, ub;
+	};
+
+	struct Bin {
+		Box box;
+		uint32_t count;
+	};
+
+	Box EmptyBox() {
+		float fMax = std::numeric_limits <float>::max(), fMin = std::numeric_limits <float>::lowest();
+		return { { fMax, fMax, fMax }, { fMin, fMin, fMin } };
+	}
+
+	void Grow(Box& _box, const DirectX::XMFLOAT3& _lb, const DirectX::XMFLOAT3& _ub) {
+		_box.lb = { std::min(_box.lb.x, _lb.x), std::min(_box.lb.y, _lb.y), std::min(_box.lb.z, _lb.z) };
+		_box.ub = { std::max(_box.ub.x, _ub.x), std::max(_box.ub.y, _ub.y), std::max(_box.ub.z, _ub.z) };
+	}
+
+	void Grow(Box& _box, const Box& _other) { Grow(_box, _other.lb, _other.ub); }
+	void Grow(Box& _box, const DirectX::XMFLOAT3& _point) { Grow(_box, _point, _point); }
+
+	/**
+	* @brief Half the surface area, the heuristic only compares areas
+	*/
+	float Area(const Box& _box) {
+		float x = _box.ub.x - _box.lb.x, y = _box.ub.y - _box.lb.y, z = _box.ub.z - _box.lb.z;
+		if (x < 0.0f) return 0.0f;
+
+		return x * y + y * z + z * x;
+	}
+
+	float Centroid(const Box& _box, int _axis) {
+		return 0.5f * ((&_box.lb.x)[_axis] + (&_box.ub.x)[_axis]);
+	}
+
+	bool Overlaps(const DirectX::XMFLOAT3& _lb0, const DirectX::XMFLOAT3& _ub0, const DirectX::XMFLOAT3& _lb1, const DirectX::XMFLOAT3& _ub1) {
+		return _lb0.x <= _ub1.x && _lb1.x <= _ub0.x && _lb0.y <= _ub1.y && _lb1.y <= _ub0.y && _lb0.z <= _ub1.z && _lb1.z <= _ub0.z;
+	}
+
+	/**
+	* @brief Split the leaf _node in two along the cheapest of the binned planes, children are appended to _nodes
+	* @return false if the node stays a leaf
+	*/
+	bool Split(std::vector <detail::BVH_NODE>& _nodes, size_t _node, uint32_t* _triangles, const Box* _boxes, uint32_t _depth, bool _parallel) {
+		detail::BVH_NODE node = _nodes[_node];
+		if (node.count <= s_minLeafSize || _depth >= s_maxDepth) return false;
+
+		uint32_t* first = _triangles + node.first;
+		std::mutex mutex;
+		auto run = [&](auto&& _func) {
+			if (_parallel) ParallelFor(0, node.count, _func, s_parallelBinning / 4);
+			else _func(0, node.count);
+		};
+
+		// bins span the centroids rather than the triangles
+		Box centroids = EmptyBox();
+		run([&](size_t _begin, size_t _end) {
+			Box local = EmptyBox();
+			for (size_t i = _begin; i < _end; i++) {
+				const Box& box = _boxes[first[i]];
+				Grow(local, DirectX::XMFLOAT3 { Centroid(box, 0), Centroid(box, 1), Centroid(box, 2) });
+			}
+
+			std::lock_guard <std::mutex> lock(mutex);
+			Grow(centroids, local);
+		});
+
+		// bin along the axis the centroids spread the most
+		float extents[3] = { centroids.ub.x - centroids.lb.x, centroids.ub.y - centroids.lb.y, centroids.ub.z - centroids.lb.z };
+		int axis = extents[0] >= extents[1] ? (extents[0] >= extents[2] ? 0 : 2) : (extents[1] >= extents[2] ? 1 : 2);
+		float lo = (&centroids.lb.x)[axis], scale = extents[axis] > 0.0f ? s_binCount / extents[axis] : 0.0f;
+		auto binOf = [&](const Box& _box) {
+			return std::min(s_binCount - 1, static_cast <uint32_t> ((Centroid(_box, axis) - lo) * scale));
+		};
+
+		Bin bins[s_binCount];
+		for (uint32_t i = 0; i < s_binCount; i++) bins[i] = { EmptyBox(), 0 };
+		if (scale > 0.0f) {
+			run([&](size_t _begin, size_t _end) {
+				Bin local[s_binCount];
+				for (uint32_t i = 0; i < s_binCount; i++) local[i] = { EmptyBox(), 0 };
+
+				for (size_t i = _begin; i < _end; i++) {
+					const Box& box = _boxes[first[i]];
+					Bin& bin = local[binOf(box)];
+					Grow(bin.box, box);
+					bin.count++;
+				}
+
+				std::lock_guard <std::mutex> lock(mutex);
+				for (uint32_t i = 0; i < s_binCount; i++) {
+					Grow(bins[i].box, local[i].box);
+					bins[i].count += local[i].count;
+				}
+			});
+		}
+
+		// sweep the planes between the bins from both sides
+		float bestCost = std::numeric_limits <float>::max();
+		uint32_t bestSplit = 0;
+		if (scale > 0.0f) {
+			float leftArea[s_binCount - 1];
+			uint32_t leftCount[s_binCount - 1];
+			Box box = EmptyBox();
+			uint32_t sum = 0;
+			for (uint32_t i = 0; i + 1 < s_binCount; i++) {
+				Grow(box, bins[i].box);
+				sum += bins[i].count;
+				leftArea[i] = Area(box);
+				leftCount[i] = sum;
+			}
+
+			box = EmptyBox();
+			sum = 0;
+			for (uint32_t i = s_binCount - 1; i > 0; i--) {
+				Grow(box, bins[i].box);
+				sum += bins[i].count;
+				if (leftCount[i - 1] == 0 || sum == 0) continue;
+
+				float cost = leftCount[i - 1] * leftArea[i - 1] + sum * Area(box);
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestSplit = i;
+				}
+			}
+		}
+
+		Box nodeBox = { node.lb, node.ub };
+		if ((bestSplit == 0 || bestCost >= node.count * Area(nodeBox)) && node.count <= s_maxLeafSize) return false;
+
+		uint32_t leftCount;
+		Box leftBox = EmptyBox(), rightBox = EmptyBox();
+		if (bestSplit > 0) {
+			leftCount = static_cast <uint32_t> (std::partition(first, first + node.count, [&](uint32_t _triangle) {
+				return binOf(_boxes[_triangle]) < bestSplit;
+			}) - first);
+
+			for (uint32_t i = 0; i < s_binCount; i++) Grow(i < bestSplit ? leftBox : rightBox, bins[i].box);
+		}
+		else {
+			// every centroid coincides, any halving is as good as another
+			leftCount = node.count / 2;
+			for (uint32_t i = 0; i < node.count; i++) Grow(i < leftCount ? leftBox : rightBox, _boxes[first[i]]);
+		}
+
+		uint32_t left = static_cast <uint32_t> (_nodes.size());
+		_nodes.push_back({ leftBox.lb, node.first, leftBox.ub, leftCount });
+		_nodes.push_back({ rightBox.lb, node.first + leftCount, rightBox.ub, node.count - leftCount });
+		_nodes[_node].first = left;
+		_nodes[_node].count = 0;
+
+		return true;
+	}
+
+	void BuildSubtree(std::vector <detail::BVH_NODE>& _nodes, size_t _root, uint32_t _depth, uint32_t* _triangles, const Box* _boxes) {
+		std::vector <std::pair <size_t, uint32_t>> stack = { { _root, _depth } };
+		while (!stack.empty()) {
+			auto [node, depth] = stack.back();
+			stack.pop_back();
+
+			if (!Split(_nodes, node, _triangles, _boxes, depth, false)) continue;
+			stack.push_back({ _nodes[node].first, depth + 1 });
+			stack.push_back({ _nodes[node].first + 1U, depth + 1 });
+		}
+	}
+}
+
+//
+// ---------- class TriangleBvh
+//
+
+TriangleBvh::TriangleBvh(const Geometry& _geometry) {
+	size_t count = _geometry.triangleCount;
+	if (count == 0) return;
+	if (_geometry.positions == nullptr || _geometry.indices == nullptr) throw std::invalid_argument("Geometry without positions or indices");
+	if (count >= std::numeric_limits <uint32_t>::max()) throw std::invalid_argument("Too many triangles for 32 bit node references");
+
+	m_triangles.resize(count);
+	std::vector <Box> boxes(count);
+	Box root = EmptyBox();
+	std::mutex mutex;
+	ParallelFor(0, count, [&](size_t _begin, size_t _end) {
+		Box local = EmptyBox();
+		for (size_t i = _begin; i < _end; i++) {
+			Box box = EmptyBox();
+			for (size_t k = 0; k < 3; k++) Grow(box, _geometry.GetVertex(i, k));
+
+			m_triangles[i] = static_cast <uint32_t> (i);
+			boxes[i] = box;
+			Grow(local, box);
+		}
+
+		std::lock_guard <std::mutex> lock(mutex);
+		Grow(root, local);
+	}, s_minTask);
+
+	m_nodes.push_back({ root.lb, 0, root.ub, static_cast <uint32_t> (count) });
+
+	// the upper levels are split here with every thread binning, the ranges below the task size become independent subtrees
+	struct Task {
+		size_t node;
+		uint32_t depth;
+		std::vector <detail::BVH_NODE> nodes;
+	};
+	size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+	size_t taskSize = std::max(s_minTask, count / (threadCount * 8));
+
+	std::vector <Task> tasks;
+	std::vector <std::pair <size_t, uint32_t>> stack = { { 0, 0 } };
+	while (!stack.empty()) {
+		auto [node, depth] = stack.back();
+		stack.pop_back();
+
+		if (m_nodes[node].count <= taskSize) {
+			tasks.push_back({ node, depth, {} });
+			continue;
+		}
+
+		if (!Split(m_nodes, node, m_triangles.data(), boxes.data(), depth, m_nodes[node].count >= s_parallelBinning)) continue;
+		stack.push_back({ m_nodes[node].first, depth + 1 });
+		stack.push_back({ m_nodes[node].first + 1U, depth + 1 });
+	}
+
+	// largest subtrees first so the threads run out of work together
+	std::sort(tasks.begin(), tasks.end(), [&](const Task& _a, const Task& _b) {
+		return m_nodes[_a.node].count > m_nodes[_b.node].count;
+	});
+
+	std::atomic <size_t> next(0);
+	ParallelFor(0, std::min(threadCount, tasks.size()), [&](size_t, size_t) {
+		for (size_t i = next++; i < tasks.size(); i = next++) {
+			Task& task = tasks[i];
+			task.nodes.push_back(m_nodes[task.node]);
+			BuildSubtree(task.nodes, 0, task.depth, m_triangles.data(), boxes.data());
+		}
+	});
+
+	// the subtree root replaces its placeholder, the rest is appended and relinked
+	size_t total = m_nodes.size();
+	for (const Task& task : tasks) total += task.nodes.size() - 1;
+	m_nodes.reserve(total);
+
+	for (const Task& task : tasks) {
+		uint32_t base = static_cast <uint32_t> (m_nodes.size()) - 1U;
+		auto relink = [base](detail::BVH_NODE _node) {
+			if (_node.count == 0) _node.first += base;
+			return _node;
+		};
+
+		m_nodes[task.node] = relink(task.nodes[0]);
+		for (size_t i = 1; i < task.nodes.size(); i++) m_nodes.push_back(relink(task.nodes[i]));
+	}
+}
+
+void TriangleBvh::Refit(const Geometry& _geometry) {
+	if (_geometry.triangleCount != m_triangles.size()) throw std::invalid_argument("Geometry does not match the hierarchy");
+
+	ParallelFor(0, m_nodes.size(), [&](size_t _begin, size_t _end) {
+		for (size_t i = _begin; i < _end; i++) {
+			detail::BVH_NODE& node = m_nodes[i];
+			if (node.count == 0) continue;
+
+			Box box = EmptyBox();
+			for (uint32_t t = node.first; t < node.first + node.count; t++) {
+				for (size_t k = 0; k < 3; k++) Grow(box, _geometry.GetVertex(m_triangles[t], k));
+			}
+			node.lb = box.lb;
+			node.ub = box.ub;
+		}
+	}, s_minTask);
+
+	// children are always stored after their parent
+	for (size_t i = m_nodes.size(); i-- > 0;) {
+		detail::BVH_NODE& node = m_nodes[i];
+		if (node.count != 0) continue;
+
+		Box box = { m_nodes[node.first].lb, m_nodes[node.first].ub };
+		Grow(box, m_nodes[node.first + 1U].lb, m_nodes[node.first + 1U].ub);
+		node.lb = box.lb;
+		node.ub = box.ub;
+	}
+}
+
+bool TriangleBvh::Intersect(const Ray& _ray, const Geometry& _geometry, float& _oDistance, uint32_t& _oTriangle) const {
+	float tNear, tFar;
+	if (m_nodes.empty() || !_ray.IntersectBox(m_nodes[0].lb, m_nodes[0].ub, tNear, tFar)) return false;
+
+	struct Entry {
+		uint32_t node;
+		float distance;
+	};
+	Entry stack[s_maxDepth + 4];
+	size_t depth = 0;
+
+	float closest = std::numeric_limits <float>::max();
+	uint32_t node = 0;
+	bool hit = false;
+	for (;;) {
+		const detail::BVH_NODE& current = m_nodes[node];
+		if (current.count != 0) {
+			for (uint32_t i = current.first; i < current.first + current.count; i++) {
+				uint32_t triangle = m_triangles[i];
+				float t;
+				if (_ray.IntersectTriangle(_geometry.GetVertex(triangle, 0), _geometry.GetVertex(triangle, 1), _geometry.GetVertex(triangle, 2), t) && t < closest) {
+					closest = t;
+					_oTriangle = triangle;
+					hit = true;
+				}
+			}
+		}
+		else {
+			// nearer child first, the other one waits on the stack with its entry distance
+			uint32_t a = current.first, b = current.first + 1U;
+			float nearA, nearB;
+			bool hitA = _ray.IntersectBox(m_nodes[a].lb, m_nodes[a].ub, nearA, tFar) && nearA < closest;
+			bool hitB = _ray.IntersectBox(m_nodes[b].lb, m_nodes[b].ub, nearB, tFar) && nearB < closest;
+
+			if (hitA && hitB) {
+				if (nearB < nearA) {
+					std::swap(a, b);
+					std::swap(nearA, nearB);
+				}
+				stack[depth++] = { b, nearB };
+				node = a;
+				continue;
+			}
+			if (hitA || hitB) {
+				node = hitA ? a : b;
+				continue;
+			}
+		}
+
+		// skip the postponed nodes starting beyond the closest hit found since
+		while (depth > 0 && stack[depth - 1].distance >= closest) depth--;
+		if (depth == 0) break;
+		node = stack[--depth].node;
+	}
+
+	if (hit) _oDistance = closest;
+	return hit;
+}
+
+void TriangleBvh::Query(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, const Geometry& _geometry, std::vector <uint32_t>& _oTriangles) const {
+	if (m_nodes.empty()) return;
+
+	uint32_t stack[s_maxDepth + 4];
+	size_t depth = 0;
+	stack[depth++] = 0;
+
+	while (depth > 0) {
+		const detail::BVH_NODE& node = m_nodes[stack[--depth]];
+		if (!Overlaps(node.lb, node.ub, _lb, _ub)) continue;
+
+		if (node.count == 0) {
+			stack[depth++] = node.first;
+			stack[depth++] = node.first + 1U;
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			uint32_t triangle = m_triangles[i];
+			Box box = EmptyBox();
+			for (size_t k = 0; k < 3; k++) Grow(box, _geometry.GetVertex(triangle, k));
+
+			if (Overlaps(box.lb, box.ub, _lb, _ub)) _oTriangles.push_back(triangle);
+		}
+	}
+}
\ No newline at end of file
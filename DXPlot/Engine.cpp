@@ -1,46 +1,42 @@
 #include <Engine.hpp>
+#include <Device/Mouse.hpp>
 
 #include <util.hpp>
 #include <DirectXMath.h>
 
-#include <random>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 using namespace Application;
 
 Object::Object() {
 	m_name = "";
-	m_id = 0;
+	m_handle = D3DScene::s_nullObject;
 }
 
 Object::Object(const std::string& _name) {
 	m_name = _name;
-
-	static std::random_device rd;
-	static std::mt19937_64 gen(rd());
-	std::uniform_int_distribution<uint64_t> distrib(0, std::numeric_limits<uint64_t>::max());
-
-	m_id = distrib(gen);
+	m_handle = D3DScene::s_nullObject;
 }
 
-MeshObject::MeshObject() : culling(true) {}
-MeshObject::MeshObject(const std::string& _name) : Object(_name), culling(true) {}
+MeshObject::MeshObject() : culling(true), shader(Cass::ResourcePool <Cass::Shader>::s_nullHandle) {}
+MeshObject::MeshObject(const std::string& _name) : Object(_name), culling(true), shader(Cass::ResourcePool <Cass::Shader>::s_nullHandle) {}
 
-EmptyObject::EmptyObject() {}
-EmptyObject::EmptyObject(const std::string& _name) : Object(_name) {}
+EmptyObject::EmptyObject() : shader(Cass::ResourcePool <Cass::Shader>::s_nullHandle) {}
+EmptyObject::EmptyObject(const std::string& _name) : Object(_name), shader(Cass::ResourcePool <Cass::Shader>::s_nullHandle) {}
 
 
 //
 // ---------- D3DScene
 //
 
-std::shared_ptr <Cass::SurfaceShader> D3DScene::s_defSurf = nullptr;
-std::shared_ptr <Cass::FlatShader> D3DScene::s_defFlat = nullptr;
-
 D3DScene::D3DScene() {
 	if (!DirectX::XMVerifyCPUSupport())
 		throw std::exception("DirectX 11 Math not supported by current CPU");
 
-	m_grid.push_back(EmptyObject("XYgrid0")); m_grid.push_back(EmptyObject("XYgrid1"));
+	m_grid[0] = EmptyObject("XYgrid0");
+	m_grid[1] = EmptyObject("XYgrid1");
 	m_axis = EmptyObject("Axis");
 
 	m_camera = Cass::Camera(DirectX::XMFLOAT3(0.0f, 0.0f, -10.0f));
@@ -49,6 +45,9 @@ D3DScene::D3DScene() {
 
 	m_msaa = true;
 	m_showGrid = true;
+
+	m_visibleCount = m_culledCount = 0;
+	m_defSurf = m_defFlat = Cass::ResourcePool <Cass::Shader>::s_nullHandle;
 }
 
 void D3DScene::CreateD3DViewport(Cass::Window _window, D3D_FEATURE_LEVEL _minFeatureLevel, bool _msaa) {
@@ -67,36 +66,35 @@ void D3DScene::CreateD3DViewport(Cass::Window _window, D3D_FEATURE_LEVEL _minFea
 	m_resources.CreateSizeDependentResource();
 	m_resources.SetViewport();
 
-	if (s_defSurf.get() == nullptr) {
+	if (!m_shaders.IsValid(m_defSurf)) {
 		std::shared_ptr <Cass::Texture> tex = std::make_shared <Cass::Texture> (D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_WRAP);
 		Cass::ThrowIfFailed(tex->CreateFromSolidColor(16, 16, 255, 255, 255, 255, m_resources.GetDevice(), m_resources.GetDeviceContext()));
+		m_textures.Add(tex, "default albedo", tex->GetByteSize());
 
-		s_defSurf = std::make_shared <Cass::SurfaceShader>(tex, DirectX::XMFLOAT4 { 0.8f, 0.8f, 0.8f, 1.0f });
-		Cass::ThrowIfFailed(s_defSurf->LoadFromFile(L"../shaders/defLitShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
-		
-		tex.reset();
+		auto defSurf = std::make_shared <Cass::SurfaceShader>(tex, DirectX::XMFLOAT4 { 0.8f, 0.8f, 0.8f, 1.0f });
+		Cass::ThrowIfFailed(defSurf->LoadFromFile(L"../shaders/defLitShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
+		m_defSurf = AddSceneShader(defSurf, "default surface");
 	}
-	if (s_defFlat.get() == nullptr) {
-		s_defFlat = std::make_shared <Cass::FlatShader>(DirectX::XMFLOAT4{ 1.0f, 1.0f, 1.0f, 1.0f });
-		Cass::ThrowIfFailed(s_defFlat->LoadFromFile(L"../shaders/flatColorShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
+	if (!m_shaders.IsValid(m_defFlat)) {
+		auto defFlat = std::make_shared <Cass::FlatShader>(DirectX::XMFLOAT4{ 1.0f, 1.0f, 1.0f, 1.0f });
+		Cass::ThrowIfFailed(defFlat->LoadFromFile(L"../shaders/flatColorShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
+		m_defFlat = AddSceneShader(defFlat, "default flat");
 	}
 
-	std::shared_ptr <Cass::FlatShader> gridShader1 = std::make_shared <Cass::FlatShader>();
-	std::shared_ptr <Cass::FlatShader> gridShader2 = std::make_shared <Cass::FlatShader>();
-	std::shared_ptr <Cass::FlatShader> axisShader = std::make_shared <Cass::FlatShader>();
+	// the overlay shaders are kept along with the default ones when the viewport is created again
+	for (EmptyObject* overlay : { &m_grid[0], &m_grid[1], &m_axis }) {
+		if (m_shaders.IsValid(overlay->shader)) continue;
 
-	Cass::ThrowIfFailed(gridShader1->LoadFromFile(L"../shaders/axisGridShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
-	Cass::ThrowIfFailed(gridShader2->LoadFromFile(L"../shaders/axisGridShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
-	Cass::ThrowIfFailed(axisShader->LoadFromFile(L"../shaders/axisGridShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
+		std::shared_ptr <Cass::FlatShader> shader = std::make_shared <Cass::FlatShader>();
+		Cass::ThrowIfFailed(shader->LoadFromFile(L"../shaders/axisGridShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
+		overlay->shader = AddSceneShader(shader, overlay->m_name);
+	}
 
 	m_camera.SetProjection(Cass::PROJECTION::PERSPECTIVE, static_cast <float> (width), static_cast <float> (height), 0.1f, 1000.0f, 70.0f);
 	m_grid[0].pEmpty = std::make_unique <Cass::Grid> (1000.0f, 1000.0f, 999, 999, 10, DirectX::XMFLOAT4 { 0.8f, 0.8f, 0.8f, 0.4f }, m_resources.GetDevice(), m_resources.GetDeviceContext());
-	m_grid[0].pShader = gridShader1;
 	m_grid[1].pEmpty = std::make_unique <Cass::Grid>(1000.0f, 1000.0f, 99, 99, 50, DirectX::XMFLOAT4{ 0.8f, 0.8f, 0.8f, 0.4f }, m_resources.GetDevice(), m_resources.GetDeviceContext());
-	m_grid[1].pShader = gridShader2;
 
 	m_axis.pEmpty = std::make_unique <Cass::Grid>(1000.0f, 1000.0f, 1, 1, 10, DirectX::XMFLOAT4 { 1.0f, 1.0f, 1.0f, 1.0f}, m_resources.GetDevice(), m_resources.GetDeviceContext());
-	m_axis.pShader = axisShader;
 	m_axis.pEmpty->Translate({ 0.0f, 0.0f, 0.005f });
 	
 	m_axis.pEmpty->SetColor(0, { 0.2f, 1.0f, 0.2f, 0.7f });
@@ -114,34 +112,57 @@ void D3DScene::Render(const float _clearColor[4], int _syncInterval, bool _msaa)
 
 	m_resources.Clear(_clearColor);
 
+	// everything drawn below reads the camera through this snapshot
+	m_frame = Cass::CameraFrame(m_camera);
+
+	// objects fed from other threads publish their data first, culling must see their current bounds
+	for (MeshObject& mesh : m_meshes) mesh.pMesh->Refresh();
+	for (EmptyObject& empty : m_emptys) empty.pEmpty->Refresh();
+
+	// only the objects whose world bounds reach into the view frustum are drawn
+	UpdateSpatialIndex();
+	m_visible.clear();
+	m_visibleCount = m_frame.GetFrustum().Cull(m_cullBoxes, m_visible);
+	m_culledCount = m_cullBoxes.GetSize() - m_visibleCount;
+
+	// sort the visible objects into the draw passes, each pass then walks a dense component array
+	m_drawMeshes.clear();
+	m_drawCulledMeshes.clear();
+	m_drawEmptys.clear();
+	for (uint32_t index : m_visible) {
+		const SceneEntry& entry = m_entries[index];
+		if (!entry.isMesh) m_drawEmptys.push_back(entry.component);
+		else if (m_meshes[entry.component].culling) m_drawCulledMeshes.push_back(entry.component);
+		else m_drawMeshes.push_back(entry.component);
+	}
+
 	// draw meshes without culling
 	if (m_msaa && _msaa) m_resources.SetRenderTarget_msaa(false);
 	else m_resources.SetRenderTarget_no_msaa(false);
-	for (auto& mesh : m_vec_mesh) {
-		if (!mesh->culling)
-			mesh->pMesh->Render(m_camera, *mesh->pShader.get());
+	for (uint32_t index : m_drawMeshes) {
+		if (Cass::Shader* shader = m_shaders.Get(m_meshes[index].shader)) m_meshes[index].pMesh->Render(m_frame, *shader);
 	}
 
 	// draw meshes with culling
 	if (m_msaa && _msaa) m_resources.SetRenderTarget_msaa();
 	else m_resources.SetRenderTarget_no_msaa();
-	for (auto& mesh : m_vec_mesh) {
-		if (mesh->culling)
-			mesh->pMesh->Render(m_camera, *mesh->pShader.get());
+	for (uint32_t index : m_drawCulledMeshes) {
+		if (Cass::Shader* shader = m_shaders.Get(m_meshes[index].shader)) m_meshes[index].pMesh->Render(m_frame, *shader);
 	}
 
 	// draw emptys
-	for (auto& empty : m_vec_empty) {
-		empty->pEmpty->Render(m_camera, *empty->pShader.get());
+	for (uint32_t index : m_drawEmptys) {
+		if (Cass::Shader* shader = m_shaders.Get(m_emptys[index].shader)) m_emptys[index].pEmpty->Render(m_frame, *shader);
 	}
 	if (m_msaa && _msaa) m_resources.SetRenderTarget_msaa(true, true, true);
 	if (m_showGrid) {
-		m_grid[0].pShader->m_color.w = std::min(m_camera.GetScale().x / 2.0f, 1.0f);
+		Cass::Shader* gridShader = m_shaders.Get(m_grid[0].shader);
+		gridShader->m_color.w = std::min(m_frame.GetScale().x / 2.0f, 1.0f);
 
-		m_grid[0].pEmpty->Render(m_camera, *m_grid[0].pShader);
-		m_grid[1].pEmpty->Render(m_camera, *m_grid[1].pShader);
+		m_grid[0].pEmpty->Render(m_frame, *gridShader);
+		m_grid[1].pEmpty->Render(m_frame, *m_shaders.Get(m_grid[1].shader));
 		
-		m_axis.pEmpty->Render(m_camera, *m_axis.pShader);
+		m_axis.pEmpty->Render(m_frame, *m_shaders.Get(m_axis.shader));
 	}
 
 	// resolve onto non msaa render target, if msaa is enabled
@@ -151,81 +172,616 @@ void D3DScene::Render(const float _clearColor[4], int _syncInterval, bool _msaa)
 	}
 
 	m_resources.GetSwapChain()->Present(_syncInterval, NULL);
+
+	// whatever was released up to this frame goes once the GPU is through the frames that may still draw with it
+	m_resources.EndFrame();
+	uint64_t completed = m_resources.GetCompletedFrames();
+	m_shaders.Collect(completed);
+	m_textures.Collect(completed);
+	m_retired.Collect(completed);
 }
 
 void D3DScene::ResizeContext(int _width, int _height) {
 	m_resources.WindowSizeChanged(_width, _height);
 	m_resources.SetViewport();
-	m_camera.SetProjection(Cass::PROJECTION::PERSPECTIVE, static_cast <float> (_width), static_cast <float> (_height), 0.1f, 1000.0f, 70.0f);
+
+	// pixel aware objects measure against the camera, keep it in step with the viewport actually set
+	D3D11_VIEWPORT viewport = m_resources.GetViewport();
+	m_camera.SetProjection(Cass::PROJECTION::PERSPECTIVE, viewport.Width, viewport.Height, 0.1f, 1000.0f, 70.0f);
 }
 
 // ---------- Resource Creation
 
-void D3DScene::AddPolygon(const std::string& _name, float _radius, uint32_t _degree, Cass::SHADING _shading, bool _culling) {
+Application::ObjectHandle D3DScene::AddPolygon(const std::string& _name, float _radius, uint32_t _degree, Cass::SHADING _shading, bool _culling) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::make_unique <Cass::RegularPolygon> (_radius, _degree, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
+	mesh.shader = m_defSurf;
+	mesh.culling = _culling;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddCuboid(const std::string& _name, float _width, float _height, float _depth, Cass::SHADING _shading, bool _culling) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::make_unique <Cass::Cuboid> (_width, _height, _depth, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
+	mesh.shader = m_defSurf;
+	mesh.culling = _culling;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddSphere(const std::string& _name, float _radius, uint32_t _resX, uint32_t _resY, Cass::SHADING _shading, bool _culling) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::make_unique <Cass::Sphere> (_radius, _resX, _resY, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
+	mesh.shader = m_defSurf;
+	mesh.culling = _culling;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddPlane(const std::string& _name, float _width, float _length, uint32_t _resX, uint32_t _resY, Cass::SHADING _shading, bool _culling) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::make_unique <Cass::Plane> (_width, _length, _resX, _resY, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
+	mesh.shader = m_defSurf;
+	mesh.culling = _culling;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddProgressivePlane(
+	const std::string& _name, Cass::ProgressivePlane::Function _func, float _width, float _length,
+	uint32_t _resX, uint32_t _resY, Cass::SHADING _shading, bool _culling) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::make_unique <Cass::ProgressivePlane> (_func, _width, _length, _resX, _resY, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
+	mesh.shader = m_defSurf;
+	mesh.culling = _culling;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddAnimatedPlane(
+	const std::string& _name, Cass::AnimatedPlane::Function _func, float _width, float _length,
+	uint32_t _resX, uint32_t _resY, bool _culling) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::make_unique <Cass::AnimatedPlane> (_func, _width, _length, _resX, _resY, m_resources.GetDevice(), m_resources.GetDeviceContext());
+	mesh.shader = m_defSurf;
+	mesh.culling = _culling;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddDomainColoring(
+	const std::string& _name, Cass::DomainColoring::Kernel _kernel, DirectX::XMFLOAT2 _center,
+	float _extent, DirectX::XMUINT2 _resolution, float _width) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	auto plot = std::make_unique <Cass::DomainColoring> (_kernel, _center, _extent, _resolution, _width, m_resources.GetDevice(), m_resources.GetDeviceContext());
+
+	// the plot owns its texture, so it gets a shader of its own
+	auto shader = std::make_shared <Cass::SurfaceShader> (plot->GetTexture(), DirectX::XMFLOAT4 { 1.0f, 1.0f, 1.0f, 1.0f });
+	Cass::ThrowIfFailed(shader->LoadFromFile(L"../shaders/defLitShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::move(plot);
+	mesh.shader = AddShader(shader, _name);
+	mesh.culling = false;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddParametricSurface(
+	const std::string& _name, Cass::ParametricSurface::Function _func,
+	DirectX::XMFLOAT2 _rangeU, DirectX::XMFLOAT2 _rangeV, uint32_t _resU, uint32_t _resV,
+	Cass::WRAP _wrapU, Cass::WRAP _wrapV, Cass::SHADING _shading, bool _culling) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::make_unique <Cass::ParametricSurface> (_func, _rangeU, _rangeV, _resU, _resV, _wrapU, _wrapV, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
+	mesh.shader = m_defSurf;
+	mesh.culling = _culling;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddIsoSurface(
+	const std::string& _name, Cass::IsoSurface::Function _func,
+	DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, DirectX::XMUINT3 _res, float _isoValue, bool _culling) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::make_unique <Cass::IsoSurface> (_func, _lb, _ub, _res, _isoValue, m_resources.GetDevice(), m_resources.GetDeviceContext());
+	mesh.shader = m_defSurf;
+	mesh.culling = _culling;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddIsoSurface(
+	const std::string& _name, std::vector <float> _samples,
+	DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, DirectX::XMUINT3 _res, float _isoValue, bool _culling) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	MeshObject mesh(_name);
+	mesh.pMesh = std::make_unique <Cass::IsoSurface> (std::move(_samples), _lb, _ub, _res, _isoValue, m_resources.GetDevice(), m_resources.GetDeviceContext());
+	mesh.shader = m_defSurf;
+	mesh.culling = _culling;
+	return Insert(std::move(mesh));
+}
+
+Application::ObjectHandle Application::D3DScene::AddContours(
+	const std::string& _name, Cass::Contours::Function _func,
+	DirectX::XMFLOAT2 _rangeX, DirectX::XMFLOAT2 _rangeY, std::vector <float> _levels,
+	DirectX::XMUINT2 _res, DirectX::XMFLOAT4 _color) {
 	if (m_resources.GetDevice() == nullptr) {
 		throw std::invalid_argument("Device invalid or not created");
 	}
 
-	std::unique_ptr<MeshObject> mesh = std::make_unique<MeshObject>(_name);
-	mesh->pMesh = std::make_unique <Cass::RegularPolygon> (_radius, _degree, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
-	mesh->pShader = s_defSurf;
-	mesh->culling = _culling;
-	m_vec_mesh.push_back(std::move(mesh));
+	EmptyObject empty(_name);
+	empty.pEmpty = std::make_unique <Cass::Contours> (_func, _rangeX, _rangeY, _res, std::move(_levels), _color, m_resources.GetDevice(), m_resources.GetDeviceContext());
+	empty.shader = m_defFlat;
+	return Insert(std::move(empty));
 }
 
-void Application::D3DScene::AddCuboid(const std::string& _name, float _width, float _height, float _depth, Cass::SHADING _shading, bool _culling) {
+Application::ObjectHandle Application::D3DScene::AddContours(const std::string& _name, ObjectHandle _plane, std::vector <float> _levels, DirectX::XMFLOAT4 _color) {
 	if (m_resources.GetDevice() == nullptr) {
 		throw std::invalid_argument("Device invalid or not created");
 	}
 
-	std::unique_ptr<MeshObject> mesh = std::make_unique<MeshObject>(_name);
-	mesh->pMesh = std::make_unique <Cass::Cuboid> (_width, _height, _depth, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
-	mesh->pShader = s_defSurf;
-	mesh->culling = _culling;
-	m_vec_mesh.push_back(std::move(mesh));
+	MeshObject* mesh = GetMesh(_plane);
+	Cass::Plane* plane = mesh ? dynamic_cast <Cass::Plane*> (mesh->pMesh.get()) : nullptr;
+	if (plane == nullptr) {
+		throw std::invalid_argument("Contours need a plane to trace");
+	}
+
+	EmptyObject empty(_name);
+	empty.pEmpty = std::make_unique <Cass::Contours> (*plane, std::move(_levels), _color, m_resources.GetDevice(), m_resources.GetDeviceContext());
+	empty.shader = m_defFlat;
+	return Insert(std::move(empty));
+}
+
+Application::ObjectHandle Application::D3DScene::AddCurve(
+	const std::string& _name, Cass::Curve::Function _func, DirectX::XMFLOAT2 _range,
+	DirectX::XMFLOAT4 _color, float _pixelTolerance) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	EmptyObject empty(_name);
+	empty.pEmpty = std::make_unique <Cass::Curve> (_func, _range, _color, m_resources.GetDevice(), m_resources.GetDeviceContext(), _pixelTolerance);
+	empty.shader = m_defFlat;
+	return Insert(std::move(empty));
+}
+
+Application::ObjectHandle Application::D3DScene::AddGraph(
+	const std::string& _name, std::function <float(float)> _func, DirectX::XMFLOAT2 _rangeX,
+	DirectX::XMFLOAT4 _color, float _pixelTolerance) {
+	return AddCurve(_name, Cass::Curve::Explicit(_func), _rangeX, _color, _pixelTolerance);
+}
+
+Application::ObjectHandle Application::D3DScene::AddPointCloud(
+	const std::string& _name, std::vector <DirectX::XMFLOAT3> _points, const std::vector <DirectX::XMFLOAT4>& _colors,
+	DirectX::XMFLOAT4 _color, float _pointSize) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	// the point size is per plot, so each one gets a shader of its own
+	auto shader = std::make_shared <Cass::PointShader> (_color, _pointSize);
+	Cass::ThrowIfFailed(shader->LoadFromFile(L"../shaders/pointShader.hlsl", m_resources.GetDevice(), m_resources.GetDeviceContext()));
+
+	EmptyObject empty(_name);
+	empty.pEmpty = std::make_unique <Cass::PointCloud> (std::move(_points), _colors, m_resources.GetDevice(), m_resources.GetDeviceContext());
+	empty.shader = AddShader(shader, _name);
+	return Insert(std::move(empty));
+}
+
+Application::ObjectHandle Application::D3DScene::AddSeries(const std::string& _name, std::vector <DirectX::XMFLOAT2> _points, DirectX::XMFLOAT4 _color) {
+	if (m_resources.GetDevice() == nullptr) {
+		throw std::invalid_argument("Device invalid or not created");
+	}
+
+	EmptyObject empty(_name);
+	empty.pEmpty = std::make_unique <Cass::DecimatedSeries> (std::move(_points), _color, m_resources.GetDevice(), m_resources.GetDeviceContext());
+	empty.shader = m_defFlat;
+	return Insert(std::move(empty));
 }
 
-void Application::D3DScene::AddSphere(const std::string& _name, float _radius, uint32_t _resX, uint32_t _resY, Cass::SHADING _shading, bool _culling) {
+Application::ObjectHandle Application::D3DScene::AddArchiveSeries(const std::string& _name, LPCWSTR _fileName, DirectX::XMFLOAT4 _color) {
 	if (m_resources.GetDevice() == nullptr) {
 		throw std::invalid_argument("Device invalid or not created");
 	}
 
-	std::unique_ptr<MeshObject> mesh = std::make_unique<MeshObject>(_name);
-	mesh->pMesh = std::make_unique <Cass::Sphere> (_radius, _resX, _resY, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
-	mesh->pShader = s_defSurf;
-	mesh->culling = _culling;
-	m_vec_mesh.push_back(std::move(mesh));
+	auto pyramid = std::make_shared <Cass::SeriesPyramid> ();
+	Cass::ThrowIfFailed(pyramid->Open(_fileName));
+
+	EmptyObject empty(_name);
+	empty.pEmpty = std::make_unique <Cass::ArchiveSeries> (std::move(pyramid), _color, m_resources.GetDevice(), m_resources.GetDeviceContext());
+	empty.shader = m_defFlat;
+	return Insert(std::move(empty));
 }
 
-void Application::D3DScene::AddPlane(const std::string& _name, float _width, float _length, uint32_t _resX, uint32_t _resY, Cass::SHADING _shading, bool _culling) {
+Application::ObjectHandle Application::D3DScene::AddStreamingPolyline(const std::string& _name, size_t _window, DirectX::XMFLOAT4 _color, size_t _capacity) {
 	if (m_resources.GetDevice() == nullptr) {
 		throw std::invalid_argument("Device invalid or not created");
 	}
 
-	std::unique_ptr<MeshObject> mesh = std::make_unique<MeshObject>(_name);
-	mesh->pMesh = std::make_unique <Cass::Plane> (_width, _length, _resX, _resY, m_resources.GetDevice(), m_resources.GetDeviceContext(), _shading);
-	mesh->pShader = s_defSurf;
-	mesh->culling = _culling;
-	m_vec_mesh.push_back(std::move(mesh));
+	EmptyObject empty(_name);
+	empty.pEmpty = std::make_unique <Cass::StreamingPolyline> (_window, _color, m_resources.GetDevice(), m_resources.GetDeviceContext(), _capacity);
+	empty.shader = m_defFlat;
+	return Insert(std::move(empty));
 }
 
-void Application::D3DScene::AddTexture(D3D11_FILTER _filter, D3D11_TEXTURE_ADDRESS_MODE _mode, LPCWSTR _filename) {
-	if (!m_resources.GetDevice() || !m_resources.GetDeviceContext()) return;
+Application::TextureHandle Application::D3DScene::AddTexture(D3D11_FILTER _filter, D3D11_TEXTURE_ADDRESS_MODE _mode, LPCWSTR _filename) {
+	if (!m_resources.GetDevice() || !m_resources.GetDeviceContext()) return Cass::ResourcePool <Cass::Texture>::s_nullHandle;
 
 	auto texture = std::make_shared<Cass::Texture>(_filter, _mode);
 	Cass::ThrowIfFailed(texture->LoadFromFile(_filename, m_resources.GetDevice(), m_resources.GetDeviceContext()));
-	
-	m_textures.push_back(texture);
+
+	// the debug listing only needs a readable name, anything outside ASCII becomes '?'
+	std::string name;
+	for (const wchar_t* c = _filename; *c; c++) name.push_back(*c < 128 ? static_cast <char> (*c) : '?');
+
+	return m_textures.Add(texture, name, texture->GetByteSize());
 }
 
-void Application::D3DScene::AddTexture(D3D11_FILTER _filter, D3D11_TEXTURE_ADDRESS_MODE _mode, uint32_t _width, uint32_t _height, const std::vector <uint8_t>& _colorData) {
+Application::TextureHandle Application::D3DScene::AddTexture(D3D11_FILTER _filter, D3D11_TEXTURE_ADDRESS_MODE _mode, uint32_t _width, uint32_t _height, const std::vector <uint8_t>& _colorData) {
+	if (!m_resources.GetDevice() || !m_resources.GetDeviceContext()) return Cass::ResourcePool <Cass::Texture>::s_nullHandle;
+
+	auto texture = std::make_shared<Cass::Texture>(_filter, _mode);
+	Cass::ThrowIfFailed(texture->LoadFromMemory(_width, _height, _colorData, m_resources.GetDevice(), m_resources.GetDeviceContext()));
+
+	return m_textures.Add(texture, "memory " + std::to_string(_width) + "x" + std::to_string(_height), texture->GetByteSize());
+}
 
+bool Application::D3DScene::RemoveTexture(TextureHandle _handle) {
+	return m_textures.Release(_handle, m_resources.GetFrameIndex());
 }
 
 // --------- Overlays
 
 void Application::D3DScene::ToggleBoundingBox(bool _value) {
-	for (auto& x : m_vec_mesh) {
-		x->pMesh->ShowBounds(_value);
+	for (auto& mesh : m_meshes) {
+		mesh.pMesh->ShowBounds(_value);
+	}
+}
+
+// --------- Debugging
+
+void Application::D3DScene::LogResources() const {
+	size_t meshBytes = 0, emptyBytes = 0;
+	for (const MeshObject& mesh : m_meshes) meshBytes += mesh.pMesh->GetByteSize();
+	for (const EmptyObject& empty : m_emptys) emptyBytes += empty.pEmpty->GetByteSize();
+
+	// DebugLog reads %u as 64 bit and has no width or length modifiers, so every count goes through uint64_t
+	Cass::DebugLog("Resources: %u shaders %u bytes, %u textures %u bytes, %u meshes %u bytes, %u emptys %u bytes, %u waiting for the GPU\n",
+		static_cast <uint64_t> (m_shaders.GetCount()), static_cast <uint64_t> (m_shaders.GetByteSize()),
+		static_cast <uint64_t> (m_textures.GetCount()), static_cast <uint64_t> (m_textures.GetByteSize()),
+		static_cast <uint64_t> (m_meshes.size()), static_cast <uint64_t> (meshBytes),
+		static_cast <uint64_t> (m_emptys.size()), static_cast <uint64_t> (emptyBytes),
+		static_cast <uint64_t> (m_shaders.GetRetiredCount() + m_textures.GetRetiredCount() + m_retired.GetSize()));
+
+	auto log = [](const char* _kind, uint32_t _index, uint32_t _generation, const std::string& _name, size_t _byteSize) {
+		Cass::DebugLog("  %s %u:%u %s, %u bytes\n", _kind, static_cast <uint64_t> (_index), static_cast <uint64_t> (_generation), _name.c_str(), static_cast <uint64_t> (_byteSize));
+	};
+	m_shaders.ForEach([&](ShaderHandle _handle, const std::string& _name, size_t _byteSize, const Cass::Shader&) {
+		log("shader", _handle.index, _handle.generation, _name, _byteSize);
+	});
+	m_textures.ForEach([&](TextureHandle _handle, const std::string& _name, size_t _byteSize, const Cass::Texture&) {
+		log("texture", _handle.index, _handle.generation, _name, _byteSize);
+	});
+	for (const MeshObject& mesh : m_meshes) {
+		log("mesh", mesh.m_handle.index, mesh.m_handle.generation, mesh.m_name, mesh.pMesh->GetByteSize());
+	}
+	for (const EmptyObject& empty : m_emptys) {
+		log("empty", empty.m_handle.index, empty.m_handle.generation, empty.m_name, empty.pEmpty->GetByteSize());
+	}
+}
+
+// --------- Object storage
+
+Application::MeshObject* Application::D3DScene::GetMesh(ObjectHandle _handle) {
+	SceneEntry* entry = FindEntry(_handle);
+	return entry && entry->isMesh ? &m_meshes[entry->component] : nullptr;
+}
+
+Application::EmptyObject* Application::D3DScene::GetEmpty(ObjectHandle _handle) {
+	SceneEntry* entry = FindEntry(_handle);
+	return entry && !entry->isMesh ? &m_emptys[entry->component] : nullptr;
+}
+
+Application::ObjectHandle Application::D3DScene::Insert(MeshObject&& _mesh) {
+	Cass::Transform* transform = _mesh.pMesh.get();
+	m_shaders.AddUse(_mesh.shader);
+	m_meshes.push_back(std::move(_mesh));
+	m_meshes.back().m_handle = AddEntry(transform, true, m_meshes.size() - 1);
+
+	return m_meshes.back().m_handle;
+}
+
+Application::ObjectHandle Application::D3DScene::Insert(EmptyObject&& _empty) {
+	Cass::Transform* transform = _empty.pEmpty.get();
+	m_shaders.AddUse(_empty.shader);
+	m_emptys.push_back(std::move(_empty));
+	m_emptys.back().m_handle = AddEntry(transform, false, m_emptys.size() - 1);
+
+	return m_emptys.back().m_handle;
+}
+
+Application::ObjectHandle Application::D3DScene::AddEntry(Cass::Transform* _transform, bool _isMesh, size_t _component) {
+	uint32_t index;
+	if (!m_freeHandles.empty()) {
+		index = m_freeHandles.back();
+		m_freeHandles.pop_back();
+	}
+	else {
+		index = static_cast <uint32_t> (m_handles.size());
+		m_handles.push_back({ s_nullEntry, 0 });
+	}
+	m_handles[index].entry = static_cast <uint32_t> (m_entries.size());
+
+	SceneEntry entry = {
+		{ index, m_handles[index].generation }, _transform, static_cast <uint32_t> (_component), _isMesh,
+		Cass::AabbTree::s_nullProxy, {}, {}, Cass::SceneGraph::s_nullNode
+	};
+	_transform->GetWorldBounds(entry.lb, entry.ub);
+	entry.proxy = m_spatialIndex.Insert(entry.lb, entry.ub, index);
+	m_cullBoxes.Push(entry.lb, entry.ub);
+
+	// later changes of the transform or the bounds queue the object for the next update
+	_transform->WatchChanges(&m_movedObjects, index);
+	m_entries.push_back(entry);
+
+	return entry.handle;
+}
+
+Application::D3DScene::SceneEntry* Application::D3DScene::FindEntry(ObjectHandle _handle) {
+	if (!IsValid(_handle)) return nullptr;
+	return &m_entries[m_handles[_handle.index].entry];
+}
+
+bool Application::D3DScene::Remove(ObjectHandle _handle) {
+	SceneEntry* found = FindEntry(_handle);
+	if (found == nullptr) return false;
+
+	SceneEntry entry = *found;
+	uint32_t index = m_handles[_handle.index].entry;
+
+	// children are detached first, the update after this passes them an identity parent
+	if (entry.node != Cass::SceneGraph::s_nullNode) {
+		for (uint32_t attached : m_attached) {
+			uint32_t node = m_entries[m_handles[attached].entry].node;
+			if (m_hierarchy.GetParent(node) == entry.node) m_hierarchy.SetParent(node, Cass::SceneGraph::s_nullNode);
+		}
+		m_hierarchy.RemoveNode(entry.node);
+		m_attached.erase(std::find(m_attached.begin(), m_attached.end(), _handle.index));
+	}
+
+	m_spatialIndex.Remove(entry.proxy);
+	entry.transform->WatchChanges(nullptr, 0);
+
+	// the last entry and component fill the gaps
+	size_t last = m_entries.size() - 1;
+	if (index != last) {
+		m_entries[index] = m_entries[last];
+		m_handles[m_entries[index].handle.index].entry = index;
+		m_cullBoxes.Set(index, m_entries[index].lb, m_entries[index].ub);
+	}
+	m_entries.pop_back();
+	m_cullBoxes.Resize(last);
+
+	// the GPU may still be drawing the object, its data is only destroyed once the frame is done
+	uint64_t frame = m_resources.GetFrameIndex();
+	ShaderHandle shader;
+	auto removeComponent = [&](auto& _components) {
+		shader = _components[entry.component].shader;
+		if (entry.component + 1 != _components.size()) {
+			_components[entry.component] = std::move(_components.back());
+			m_entries[m_handles[_components[entry.component].m_handle.index].entry].component = entry.component;
+		}
+		_components.pop_back();
+	};
+	if (entry.isMesh) {
+		m_retired.Retire(std::shared_ptr <Cass::Mesh> (std::move(m_meshes[entry.component].pMesh)), frame);
+		removeComponent(m_meshes);
+	}
+	else {
+		m_retired.Retire(std::shared_ptr <Cass::Empty> (std::move(m_emptys[entry.component].pEmpty)), frame);
+		removeComponent(m_emptys);
+	}
+	if (m_shaders.RemoveUse(shader) == 0) m_shaders.Release(shader, frame);
+
+	m_handles[_handle.index].entry = s_nullEntry;
+	m_handles[_handle.index].generation++;
+	m_freeHandles.push_back(_handle.index);
+
+	return true;
+}
+
+Application::ShaderHandle Application::D3DScene::AddSceneShader(std::shared_ptr <Cass::Shader> _shader, const std::string& _name) {
+	ShaderHandle handle = AddShader(std::move(_shader), _name);
+	m_shaders.AddUse(handle);
+	return handle;
+}
+
+Application::ShaderHandle Application::D3DScene::AddShader(std::shared_ptr <Cass::Shader> _shader, const std::string& _name) {
+	size_t byteSize = _shader->GetByteSize();
+	return m_shaders.Add(std::move(_shader), _name, byteSize);
+}
+
+// --------- Spatial queries
+
+void Application::D3DScene::UpdateSpatialIndex() {
+	UpdateHierarchy();
+
+	// a transform reports its first change only, rearm it when taking the object off the queue
+	// the hierarchy may have added the descendants of moved objects
+	for (uint64_t index : m_movedObjects) {
+		uint32_t entryIndex = m_handles[index].entry;
+		if (entryIndex == s_nullEntry) continue;
+
+		SceneEntry& entry = m_entries[entryIndex];
+		entry.transform->GetWorldBounds(entry.lb, entry.ub);
+		m_spatialIndex.Move(entry.proxy, entry.lb, entry.ub);
+		m_cullBoxes.Set(entryIndex, entry.lb, entry.ub);
+
+		entry.transform->WatchChanges(&m_movedObjects, index);
+	}
+	m_movedObjects.clear();
+}
+
+void Application::D3DScene::UpdateHierarchy() {
+	if (m_attached.empty()) return;
+
+	// the objects keep their own transform as the local one of their node, only the ones that reported a change are read
+	for (uint64_t index : m_movedObjects) {
+		uint32_t entryIndex = m_handles[index].entry;
+		if (entryIndex == s_nullEntry || m_entries[entryIndex].node == Cass::SceneGraph::s_nullNode) continue;
+
+		SetLocal(m_entries[entryIndex]);
+	}
+	if (m_hierarchy.Update() == 0) return;
+
+	for (uint32_t index : m_attached) {
+		const SceneEntry& entry = m_entries[m_handles[index].entry];
+		if (!m_hierarchy.IsUpdated(entry.node)) continue;
+
+		uint32_t parent = m_hierarchy.GetParent(entry.node);
+		entry.transform->SetParentTransformation(parent == Cass::SceneGraph::s_nullNode ? DirectX::XMMatrixIdentity() : m_hierarchy.GetWorld(parent));
+	}
+}
+
+void Application::D3DScene::SetLocal(const SceneEntry& _entry) {
+	m_hierarchy.SetLocal(_entry.node, _entry.transform->GetPosition(), _entry.transform->GetRotationQuat(), _entry.transform->GetScale());
+}
+
+Application::ObjectHandle Application::D3DScene::Pick(float _x, float _y, float& _oDistance) {
+	return Pick(m_frame.GetRay(_x, _y), _oDistance);
+}
+
+Application::ObjectHandle Application::D3DScene::Pick(const Cass::Ray& _ray, float& _oDistance) {
+	UpdateSpatialIndex();
+
+	uint32_t proxy = m_spatialIndex.RayCast(_ray, [&](uint32_t _proxy, float& _oHit) {
+		const SceneEntry& entry = m_entries[m_handles[m_spatialIndex.GetUserData(_proxy)].entry];
+		if (entry.isMesh) return m_meshes[entry.component].pMesh->Intersect(_ray, _oHit);
+
+		float tNear, tFar;
+		if (!_ray.IntersectBox(entry.lb, entry.ub, tNear, tFar)) return false;
+		_oHit = std::max(tNear, 0.0f);
+		return true;
+	}, _oDistance);
+
+	if (proxy == Cass::AabbTree::s_nullProxy) return s_nullObject;
+	return m_entries[m_handles[m_spatialIndex.GetUserData(proxy)].entry].handle;
+}
+
+void Application::D3DScene::QueryBox(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, std::vector <ObjectHandle>& _oObjects) {
+	UpdateSpatialIndex();
+
+	// the index holds enlarged bounds, the exact ones decide
+	std::vector <uint32_t> proxies;
+	m_spatialIndex.Query(_lb, _ub, proxies);
+	for (uint32_t proxy : proxies) {
+		const SceneEntry& entry = m_entries[m_handles[m_spatialIndex.GetUserData(proxy)].entry];
+		if (entry.lb.x <= _ub.x && _lb.x <= entry.ub.x && entry.lb.y <= _ub.y && _lb.y <= entry.ub.y && entry.lb.z <= _ub.z && _lb.z <= entry.ub.z) {
+			_oObjects.push_back(entry.handle);
+		}
+	}
+}
+
+Application::ObjectHandle Application::D3DScene::Nearest(DirectX::XMFLOAT3 _point, float& _oDistance) {
+	UpdateSpatialIndex();
+
+	uint32_t proxy = m_spatialIndex.Nearest(_point, [&](uint32_t _proxy) {
+		const SceneEntry& entry = m_entries[m_handles[m_spatialIndex.GetUserData(_proxy)].entry];
+		float x = std::max(std::max(entry.lb.x - _point.x, _point.x - entry.ub.x), 0.0f);
+		float y = std::max(std::max(entry.lb.y - _point.y, _point.y - entry.ub.y), 0.0f);
+		float z = std::max(std::max(entry.lb.z - _point.z, _point.z - entry.ub.z), 0.0f);
+
+		return std::sqrt(x * x + y * y + z * z);
+	}, _oDistance);
+
+	if (proxy == Cass::AabbTree::s_nullProxy) return s_nullObject;
+	return m_entries[m_handles[m_spatialIndex.GetUserData(proxy)].entry].handle;
+}
+
+Application::ObjectHandle Application::D3DScene::HoverPoint(float _x, float _y, float _radius, DirectX::XMFLOAT3& _oPoint, float& _oDistance) {
+	UpdateSpatialIndex();
+
+	ObjectHandle nearest = s_nullObject;
+	for (const SceneEntry& entry : m_entries) {
+		if (entry.isMesh || !m_frame.GetFrustum().Intersects(entry.lb, entry.ub)) continue;
+
+		// each object only looks within the best distance so far
+		DirectX::XMFLOAT3 point;
+		float distance;
+		float radius = nearest == s_nullObject ? _radius : _oDistance;
+		if (!m_emptys[entry.component].pEmpty->FindPoint(m_frame, _x, _y, radius, point, distance)) continue;
+		if (nearest != s_nullObject && distance >= _oDistance) continue;
+
+		nearest = entry.handle;
+		_oPoint = point;
+		_oDistance = distance;
+	}
+
+	return nearest;
+}
+
+Application::ObjectHandle Application::D3DScene::HoverPoint(float _radius, DirectX::XMFLOAT3& _oPoint, float& _oDistance) {
+	// the mouse position is kept in screen coordinates
+	POINT cursor = { Cass::Mouse::posX, Cass::Mouse::posY };
+	if (!ScreenToClient(m_resources.GetWindow(), &cursor)) return s_nullObject;
+
+	return HoverPoint(static_cast <float> (cursor.x), static_cast <float> (cursor.y), _radius, _oPoint, _oDistance);
+}
+
+// --------- Hierarchy
+
+void Application::D3DScene::Attach(ObjectHandle _child, ObjectHandle _parent) {
+	UpdateSpatialIndex();
+
+	SceneEntry* child = FindEntry(_child);
+	SceneEntry* parent = _parent == s_nullObject ? nullptr : FindEntry(_parent);
+	if (child == nullptr || (_parent != s_nullObject && parent == nullptr)) {
+		throw std::invalid_argument("Object is not part of the scene");
+	}
+
+	auto node = [&](SceneEntry* _entry) {
+		if (_entry->node == Cass::SceneGraph::s_nullNode) {
+			_entry->node = m_hierarchy.AddNode();
+			m_attached.push_back(_entry->handle.index);
+			SetLocal(*_entry);
+		}
+		return _entry->node;
+	};
+
+	if (parent) {
+		m_hierarchy.SetParent(node(child), node(parent));
+	}
+	else if (child->node != Cass::SceneGraph::s_nullNode) {
+		m_hierarchy.SetParent(child->node, Cass::SceneGraph::s_nullNode);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Object/AnimatedPlane.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace Cass;
+
+//
+// ---------- class AnimatedPlane
+//
+
+AnimatedPlane::AnimatedPlane(
+	Function _func, float _width, float _length, uint32_t _resX, uint32_t _resY,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) : Plane(_width, _length, _resX, _resY, _pDevice, _pContext, SHADING::SMOOTH) {
+
+	if (!_func) {
+		throw std::invalid_argument("Animated plane needs a function to sample");
+	}
+
+	m_func = _func;
+	m_playing = true;
+	m_busy = false;
+	m_speed = 1.0f;
+	m_time = 0.0f;
+	m_dispatchedTime = 0.0f;
+	m_frameTime = std::numeric_limits <float>::quiet_NaN();
+	m_lastRefresh = std::chrono::steady_clock::now();
+
+	// the back buffer shares x, y and uv with the front buffer, workers only touch heights and normals
+	m_backData = std::unique_ptr <detail::MESH_VERTEX_DATA[]>(new detail::MESH_VERTEX_DATA[m_vertCount]);
+	std::copy(m_vertexData.get(), m_vertexData.get() + m_vertCount, m_backData.get());
+	m_heights.resize(m_vertCount);
+	m_backReady = false;
+
+	m_ticket = 0;
+	m_phase = 0;
+	m_arrived = 0;
+	m_finished = 0;
+	m_workerTime = 0.0f;
+	m_stop = false;
+
+	// leave a core to the render thread, hardware_concurrency may return 0 when it can't tell
+	unsigned hc = std::thread::hardware_concurrency();
+	m_workerCount = hc > 1 ? hc - 1 : 1;
+	m_workerRange.resize(m_workerCount);
+	for (uint32_t i = 0; i < m_workerCount; i++) {
+		m_workers.emplace_back(&AnimatedPlane::WorkerLoop, this, i);
+	}
+}
+
+AnimatedPlane::~AnimatedPlane() {
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_start.notify_all();
+	m_phaseDone.notify_all();
+
+	for (auto& worker : m_workers) worker.join();
+}
+
+void AnimatedPlane::Refresh() {
+	auto now = std::chrono::steady_clock::now();
+	if (m_playing) m_time += m_speed * std::chrono::duration <float>(now - m_lastRefresh).count();
+	m_lastRefresh = now;
+
+	if (m_busy && m_backReady.load(std::memory_order_acquire)) {
+		Present();
+		m_busy = false;
+	}
+
+	// the workers always run one frame ahead, a paused animation goes idle once its frame is shown
+	if (!m_busy && !(m_time == m_frameTime)) Dispatch(m_time);
+}
+
+void AnimatedPlane::Dispatch(float _time) {
+	m_busy = true;
+	m_dispatchedTime = _time;
+
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_workerTime = _time;
+		m_ticket++;
+	}
+	m_start.notify_all();
+}
+
+void AnimatedPlane::Present() {
+	m_backReady.store(false, std::memory_order_relaxed);
+	m_vertexData.swap(m_backData);
+	m_frameTime = m_dispatchedTime;
+
+	D3D11_MAPPED_SUBRESOURCE ms;
+	ThrowIfFailed(m_deviceContext->Map(m_vBuffer.Get(), NULL, D3D11_MAP_WRITE_DISCARD, NULL, &ms));
+	memcpy(ms.pData, m_vertexData.get(), sizeof(detail::MESH_VERTEX_DATA) * m_vertCount);
+	m_deviceContext->Unmap(m_vBuffer.Get(), NULL);
+
+	// the workers reduced the height range, x and y never change
+	DirectX::XMFLOAT2 dims = GetDimensions();
+	float lo = std::numeric_limits <float>::max(), hi = std::numeric_limits <float>::lowest();
+	for (const DirectX::XMFLOAT2& range : m_workerRange) {
+		lo = std::min(lo, range.x);
+		hi = std::max(hi, range.y);
+	}
+	SetBounds({ -dims.x / 2, -dims.y / 2, lo }, { dims.x / 2, dims.y / 2, hi });
+	m_deformed = lo != 0.0f || hi != 0.0f;
+	m_bvhStale = true;
+}
+
+void AnimatedPlane::ArriveAndWait() {
+	std::unique_lock <std::mutex> lock(m_mutex);
+
+	uint64_t phase = m_phase;
+	if (++m_arrived == m_workerCount) {
+		m_arrived = 0;
+		m_phase++;
+		lock.unlock();
+		m_phaseDone.notify_all();
+		return;
+	}
+
+	m_phaseDone.wait(lock, [&]() { return m_phase != phase || m_stop; });
+}
+
+void AnimatedPlane::WorkerLoop(uint32_t _index) {
+	DirectX::XMUINT2 size = GetGridSize();
+	DirectX::XMFLOAT2 dims = GetDimensions();
+	size_t width = size.x, height = size.y;
+	float offsetX = dims.x / (width - 1U), offsetY = dims.y / (height - 1U);
+
+	size_t rowBegin = height * _index / m_workerCount, rowEnd = height * (_index + 1U) / m_workerCount;
+
+	uint64_t seen = 0;
+	for (;;) {
+		float time;
+		{
+			std::unique_lock <std::mutex> lock(m_mutex);
+			m_start.wait(lock, [&]() { return m_stop || m_ticket != seen; });
+			if (m_stop) return;
+
+			seen = m_ticket;
+			time = m_workerTime;
+		}
+
+		// heights first, the normals of the border rows need the neighbouring workers' heights
+		for (size_t i = rowBegin; i < rowEnd; i++) {
+			float y = dims.y / 2 - i * offsetY;
+			for (size_t j = 0; j < width; j++) {
+				m_heights[i * width + j] = m_func(-dims.x / 2 + j * offsetX, y, time);
+			}
+		}
+
+		ArriveAndWait();
+
+		float lo = std::numeric_limits <float>::max(), hi = std::numeric_limits <float>::lowest();
+		for (size_t i = rowBegin; i < rowEnd; i++) {
+			for (size_t j = 0; j < width; j++) {
+				size_t index = i * width + j;
+
+				m_backData[index].position.z = m_heights[index];
+				m_backData[index].normal = HeightNormal(m_heights.data(), width, height, i, j, offsetX, offsetY);
+				lo = std::min(lo, m_heights[index]);
+				hi = std::max(hi, m_heights[index]);
+			}
+		}
+		m_workerRange[_index] = { lo, hi };
+
+		std::lock_guard <std::mutex> lock(m_mutex);
+		if (++m_finished == m_workerCount) {
+			m_finished = 0;
+			m_backReady.store(true, std::memory_order_release);
+		}
+	}
+}
\ No newline at end of file
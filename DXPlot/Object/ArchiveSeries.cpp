@@ -0,0 +1,155 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Object/ArchiveSeries.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace Cass;
+
+//
+// ---------- class ArchiveSeries
+//
+
+ArchiveSeries::ArchiveSeries(std::shared_ptr <const SeriesPyramid> _pyramid, DirectX::XMFLOAT4 _color, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) :
+	Polyline(_color, _pDevice, _pContext), m_pyramid(std::move(_pyramid)) {
+
+	m_level = 0;
+	m_origin = m_pyramid->GetStart();
+	m_drawOrigin = 0.0;
+	m_drawTarget = { 0.0f, 0.0f, 0.0f };
+	m_drawVersion = UINT64_MAX;
+	m_lastT0 = m_lastT1 = 0.0;
+	m_lastWidth = 0;
+	m_dirty = true;
+
+	// the top level holds a single bucket over all samples, unless the archive has no level above the samples
+	float minY = 0.0f, maxY = 0.0f;
+	uint32_t top = m_pyramid->GetLevelCount() - 1;
+	if (top > 0 && m_pyramid->GetBucketCount(top) > 0) {
+		minY = m_pyramid->GetBuckets(top)[0].min;
+		maxY = m_pyramid->GetBuckets(top)[0].max;
+	}
+	else if (m_pyramid->GetSampleCount() > 0) {
+		minY = maxY = m_pyramid->GetSamples()[0];
+	}
+
+	double first = m_pyramid->GetStart();
+	double last = first + m_pyramid->GetStep() * static_cast <double> (std::max <uint64_t> (m_pyramid->GetSampleCount(), 1) - 1);
+	m_lb = { static_cast <float> (std::min(first, last)), minY, 0.0f };
+	m_ub = { static_cast <float> (std::max(first, last)), maxY, 0.0f };
+	SetBounds(m_lb, m_ub);
+}
+
+void ArchiveSeries::InitVertices() {
+	// nothing to query until the first frame
+	m_dirty = true;
+}
+
+void ArchiveSeries::Render(const CameraFrame& _frame, Shader& _shader) {
+	double first = m_pyramid->GetStart();
+	double last = first + m_pyramid->GetStep() * static_cast <double> (m_pyramid->GetSampleCount());
+
+	// world positions of present day times are beyond float resolution, so is a view matrix translating to them
+	// the series is drawn with the view relative to the camera target instead, where float still resolves single samples
+	CameraFrame frame = _frame.GetTargetRelative();
+
+	// a view reaching past the horizon covers the whole archive, otherwise the range comes back relative to the
+	// origin of the vertices drawn
+	UpdateDrawTransform(_frame.GetTarget());
+	float minX, maxX;
+	double t0 = first, t1 = last;
+	if (frame.GetPlaneRangeX(m_drawTransform, minX, maxX)) {
+		t0 = m_origin + minX;
+		t1 = m_origin + maxX;
+	}
+
+	uint32_t width = static_cast <uint32_t> (std::max(1.0f, _frame.GetViewportSize().x));
+	if (m_dirty || t0 != m_lastT0 || t1 != m_lastT1 || width != m_lastWidth) {
+		Update(t0, t1, width);
+
+		m_lastT0 = t0;
+		m_lastT1 = t1;
+		m_lastWidth = width;
+		m_dirty = false;
+	}
+
+	UpdateDrawTransform(_frame.GetTarget());
+	Draw(frame, _shader, m_drawTransform);
+}
+
+void ArchiveSeries::Update(double _t0, double _t1, uint32_t _pixelWidth) {
+	uint64_t firstSample;
+	m_level = m_pyramid->Query(_t0, _t1, _pixelWidth, m_buckets, firstSample);
+
+	double step = m_pyramid->GetStep();
+	uint64_t samples = m_pyramid->GetBucketSamples(m_level), sampleCount = m_pyramid->GetSampleCount();
+	if (!m_buckets.empty()) m_origin = m_pyramid->GetStart() + step * static_cast <double> (firstSample);
+
+	std::vector <DirectX::XMFLOAT3> strip;
+	strip.reserve(m_buckets.size() * 2);
+	for (size_t i = 0; i < m_buckets.size(); i++) {
+		const SeriesPyramid::Bucket& bucket = m_buckets[i];
+
+		// a bucket is drawn at the middle of the samples it holds, the last one may be short
+		uint64_t begin = firstSample + i * samples, end = std::min(begin + samples, sampleCount);
+		float x = static_cast <float> (step * (0.5 * static_cast <double> (begin + end - 1) - static_cast <double> (firstSample)));
+
+		if (m_level == 0) {
+			strip.push_back({ x, bucket.mean, 0.0f });
+			continue;
+		}
+
+		// alternating the direction keeps the joins between neighbouring buckets short
+		float a = i % 2 == 0 ? bucket.min : bucket.max, b = i % 2 == 0 ? bucket.max : bucket.min;
+		strip.push_back({ x, a, 0.0f });
+		strip.push_back({ x, b, 0.0f });
+	}
+
+	Clear();
+	AddStrip(strip.data(), strip.size());
+	Upload();
+	SetBounds(m_lb, m_ub);
+}
+
+void ArchiveSeries::UpdateDrawTransform(DirectX::XMFLOAT3 _target) {
+	bool sameTarget = m_drawTarget.x == _target.x && m_drawTarget.y == _target.y && m_drawTarget.z == _target.z;
+	if (m_drawVersion == GetVersion() && m_drawOrigin == m_origin && sameTarget) return;
+
+	m_drawTransform = static_cast <const Transform&> (*this);
+
+	// shifting p by the origin along x before scale * rotation * translation is the same as moving the translation by
+	// origin times the x row of scale * rotation
+	DirectX::XMFLOAT4 quaternion = GetRotationQuat();
+	DirectX::XMFLOAT4X4 rotation;
+	DirectX::XMStoreFloat4x4(&rotation, DirectX::XMMatrixRotationQuaternion(DirectX::XMLoadFloat4(&quaternion)));
+
+	double shift = m_origin * GetScale().x;
+	DirectX::XMFLOAT3 position = GetPosition();
+	double local[3] = {
+		position.x + shift * rotation._11,
+		position.y + shift * rotation._12,
+		position.z + shift * rotation._13
+	};
+
+	// that point through the parent and minus the target, all in double, becomes the translation of the parent drawn with
+	// only the difference, which is small while the view is near the series, is ever rounded to float
+	DirectX::XMFLOAT4X4 parent;
+	DirectX::XMStoreFloat4x4(&parent, GetParentTransformation());
+	const float target[3] = { _target.x, _target.y, _target.z };
+	for (int c = 0; c < 3; c++) {
+		double world = local[0] * parent.m[0][c] + local[1] * parent.m[1][c] + local[2] * parent.m[2][c] + parent.m[3][c];
+		parent.m[3][c] = static_cast <float> (world - target[c]);
+	}
+
+	m_drawTransform.SetPosition({ 0.0f, 0.0f, 0.0f });
+	m_drawTransform.SetParentTransformation(DirectX::XMLoadFloat4x4(&parent));
+
+	m_drawOrigin = m_origin;
+	m_drawTarget = _target;
+	m_drawVersion = GetVersion();
+}
\ No newline at end of file
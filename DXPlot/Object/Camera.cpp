@@ -10,6 +10,7 @@ using namespace Cass;
 Camera::Camera(DirectX::XMFLOAT3 _position) {
 	m_target = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
 	m_scale = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
+	m_viewport = DirectX::XMFLOAT2(0.0f, 0.0f);
 
 	m_viewMat = DirectX::XMMatrixTranslation(-_position.x, -_position.y, -_position.z);
 	m_projectionMat = DirectX::XMMatrixIdentity();
@@ -26,6 +27,8 @@ void Camera::SetProjection(PROJECTION _projection, float _width, float _height,
 	default:
 		return;
 	}
+
+	m_viewport = { _width, _height };
 }
 
 // getters
@@ -0,0 +1,133 @@
+#include <Object/CameraFrame.hpp>
+
+#include <cfloat>
+
+using namespace Cass;
+
+//
+// ---------- class CameraFrame
+//
+
+CameraFrame::CameraFrame() {
+	DirectX::XMMATRIX identity = DirectX::XMMatrixIdentity();
+	DirectX::XMStoreFloat4x4(&m_view, identity);
+	m_projection = m_viewProjection = m_inverseView = m_inverseViewProjection = m_view;
+	m_invertible = true;
+
+	m_scale = { 1.0f, 1.0f, 1.0f };
+	m_position = { 0.0f, 0.0f, 0.0f };
+	m_viewport = { 0.0f, 0.0f };
+
+	m_target = { 0.0f, 0.0f, 0.0f };
+	m_targetView = m_view;
+}
+
+CameraFrame::CameraFrame(const Camera& _camera) {
+	SetMatrices(_camera.GetViewMat(), _camera.GetProjectionMat());
+
+	m_scale = _camera.GetScale();
+	m_viewport = _camera.GetViewportSize();
+
+	m_target = _camera.GetTarget();
+	DirectX::XMStoreFloat4x4(&m_targetView, _camera.GetTargetViewMat());
+}
+
+CameraFrame CameraFrame::GetTargetRelative() const {
+	// taken from the camera as is, not by cancelling the translation out of m_view, so no rounding of the target is left in it
+	CameraFrame frame;
+	frame.SetMatrices(DirectX::XMLoadFloat4x4(&m_targetView), GetProjection());
+
+	frame.m_scale = m_scale;
+	frame.m_viewport = m_viewport;
+	frame.m_targetView = m_targetView;
+
+	return frame;
+}
+
+void CameraFrame::SetMatrices(DirectX::FXMMATRIX _view, DirectX::CXMMATRIX _projection) {
+	DirectX::XMMATRIX viewProjection = DirectX::XMMatrixMultiply(_view, _projection);
+	DirectX::XMMATRIX inverseView = DirectX::XMMatrixInverse(nullptr, _view);
+
+	DirectX::XMVECTOR det;
+	DirectX::XMMATRIX inverseViewProjection = DirectX::XMMatrixInverse(&det, viewProjection);
+	m_invertible = DirectX::XMVectorGetX(det) != 0.0f;
+
+	DirectX::XMStoreFloat4x4(&m_view, _view);
+	DirectX::XMStoreFloat4x4(&m_projection, _projection);
+	DirectX::XMStoreFloat4x4(&m_viewProjection, viewProjection);
+	DirectX::XMStoreFloat4x4(&m_inverseView, inverseView);
+	DirectX::XMStoreFloat4x4(&m_inverseViewProjection, inverseViewProjection);
+
+	m_frustum.Update(viewProjection);
+
+	// the eye sits at the view space origin, with row vectors that's the translation row of the inverse
+	DirectX::XMStoreFloat3(&m_position, inverseView.r[3]);
+}
+
+float CameraFrame::GetPixelSize(DirectX::XMFLOAT3 _point) const {
+	if (m_viewport.x <= 0.0f || m_viewport.y <= 0.0f) return 0.0f;
+
+	DirectX::XMFLOAT4 clip;
+	DirectX::XMStoreFloat4(&clip, DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&_point), GetViewProjection()));
+	if (clip.w <= 0.0f) return 0.0f;
+
+	// derivative of the screen position wrt the world position, d(ndc)/dp = (column - ndc * w column) / w
+	const DirectX::XMFLOAT4X4& m = m_viewProjection;
+
+	float ndcX = clip.x / clip.w, ndcY = clip.y / clip.w;
+	DirectX::XMFLOAT3 gradX = { m._11 - ndcX * m._14, m._21 - ndcX * m._24, m._31 - ndcX * m._34 };
+	DirectX::XMFLOAT3 gradY = { m._12 - ndcY * m._14, m._22 - ndcY * m._24, m._32 - ndcY * m._34 };
+
+	float pixelsX = 0.5f * m_viewport.x / clip.w * DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&gradX)));
+	float pixelsY = 0.5f * m_viewport.y / clip.w * DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&gradY)));
+	float pixels = pixelsX > pixelsY ? pixelsX : pixelsY;
+
+	return pixels > 0.0f ? 1.0f / pixels : 0.0f;
+}
+
+bool CameraFrame::GetPlaneRangeX(const Transform& _model, float& _oMinX, float& _oMaxX) const {
+	if (!m_invertible || DirectX::XMVectorGetX(DirectX::XMMatrixDeterminant(_model.GetTransformation())) == 0.0f) return false;
+
+	// inverse(model * viewProjection) from the two inverses already at hand
+	DirectX::XMMATRIX toLocal = DirectX::XMMatrixMultiply(GetInverseViewProjection(), _model.GetInverseTransformation());
+
+	_oMinX = FLT_MAX;
+	_oMaxX = -FLT_MAX;
+	for (float cx = -1.0f; cx <= 1.0f; cx += 2.0f) {
+		for (float cy = -1.0f; cy <= 1.0f; cy += 2.0f) {
+			DirectX::XMFLOAT3 nearPoint, farPoint;
+			DirectX::XMStoreFloat3(&nearPoint, DirectX::XMVector3TransformCoord(DirectX::XMVectorSet(cx, cy, 0.0f, 1.0f), toLocal));
+			DirectX::XMStoreFloat3(&farPoint, DirectX::XMVector3TransformCoord(DirectX::XMVectorSet(cx, cy, 1.0f, 1.0f), toLocal));
+
+			// the segment between the near and far plane has to cross z = 0
+			float dz = farPoint.z - nearPoint.z;
+			if (dz == 0.0f) return false;
+
+			float t = -nearPoint.z / dz;
+			if (t < 0.0f || t > 1.0f) return false;
+
+			float x = nearPoint.x + t * (farPoint.x - nearPoint.x);
+			_oMinX = x < _oMinX ? x : _oMinX;
+			_oMaxX = x > _oMaxX ? x : _oMaxX;
+		}
+	}
+
+	return true;
+}
+
+Ray CameraFrame::GetRay(float _x, float _y) const {
+	if (!m_invertible || m_viewport.x <= 0.0f || m_viewport.y <= 0.0f) return Ray(m_position, { 0.0f, 0.0f, 0.0f });
+
+	float ndcX = 2.0f * _x / m_viewport.x - 1.0f;
+	float ndcY = 1.0f - 2.0f * _y / m_viewport.y;
+
+	DirectX::XMMATRIX toWorld = GetInverseViewProjection();
+	DirectX::XMVECTOR nearPoint = DirectX::XMVector3TransformCoord(DirectX::XMVectorSet(ndcX, ndcY, 0.0f, 1.0f), toWorld);
+	DirectX::XMVECTOR farPoint = DirectX::XMVector3TransformCoord(DirectX::XMVectorSet(ndcX, ndcY, 1.0f, 1.0f), toWorld);
+
+	DirectX::XMFLOAT3 origin, dir;
+	DirectX::XMStoreFloat3(&origin, nearPoint);
+	DirectX::XMStoreFloat3(&dir, DirectX::XMVector3Normalize(DirectX::XMVectorSubtract(farPoint, nearPoint)));
+
+	return Ray(origin, dir);
+}
\ No newline at end of file
@@ -0,0 +1,278 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Object/Contours.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace Cass;
+
+namespace {
+	//
+	// ---------- marching squares case table
+	//
+
+	// cells are split into square tiles of this many cells, one tile per task
+	const uint32_t s_tileSize = 64;
+
+	struct CellCase {
+		// (entering edge, leaving edge) per segment
+		int8_t segments[2][2];
+		int8_t count;
+	};
+
+	struct CaseTable {
+		CellCase separated[16];
+
+		// saddles with the cell center inside, the two inside corners are joined
+		CellCase connected[16];
+	};
+
+	/**
+	* @brief Corners run counter clockwise (0, 0), (1, 0), (1, 1), (0, 1), edge k joins corner k and k + 1
+	*		 a segment enters the inside region where an outside corner is followed by an inside one and leaves at the end of the run,
+	*		 neighbouring cells walk their shared edge in opposite directions, so every segment ends where the next one starts
+	*/
+	CaseTable BuildCaseTable() {
+		CaseTable table;
+
+		for (int mask = 0; mask < 16; mask++) {
+			CellCase& cell = table.separated[mask];
+			cell.count = 0;
+
+			for (int k = 0; k < 4; k++) {
+				if ((mask >> k & 1) || !(mask >> ((k + 1) & 3) & 1)) continue;
+
+				int j = (k + 1) & 3;
+				while (mask >> ((j + 1) & 3) & 1) j = (j + 1) & 3;
+
+				cell.segments[cell.count][0] = static_cast <int8_t> (k);
+				cell.segments[cell.count][1] = static_cast <int8_t> (j);
+				cell.count++;
+			}
+
+			table.connected[mask] = cell;
+			if (cell.count == 2) {
+				std::swap(table.connected[mask].segments[0][1], table.connected[mask].segments[1][1]);
+			}
+		}
+
+		return table;
+	}
+
+	const CaseTable& GetCaseTable() {
+		static const CaseTable table = BuildCaseTable();
+		return table;
+	}
+
+	struct Segment {
+		uint32_t level;
+		uint64_t from, to;
+	};
+}
+
+//
+// ---------- class Contours
+//
+
+Contours::Contours(
+	Function _func, DirectX::XMFLOAT2 _rangeX, DirectX::XMFLOAT2 _rangeY, DirectX::XMUINT2 _res,
+	std::vector <float> _levels, DirectX::XMFLOAT4 _color,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) : Polyline(_color, _pDevice, _pContext) {
+
+	if (!_func) {
+		throw std::invalid_argument("Contours need a function to sample");
+	}
+
+	m_width = std::max(_res.x, 2U);
+	m_height = std::max(_res.y, 2U);
+	m_values.resize(static_cast <size_t> (m_width) * m_height);
+	m_positions.resize(m_values.size());
+
+	float stepX = (_rangeX.y - _rangeX.x) / (m_width - 1U);
+	float stepY = (_rangeY.y - _rangeY.x) / (m_height - 1U);
+	ParallelFor(0, m_height, [&](size_t _begin, size_t _end) {
+		for (size_t y = _begin; y < _end; y++) {
+			for (size_t x = 0; x < m_width; x++) {
+				size_t index = y * m_width + x;
+
+				m_positions[index] = { _rangeX.x + x * stepX, _rangeY.x + y * stepY, 0.0f };
+				m_values[index] = _func(m_positions[index].x, m_positions[index].y);
+			}
+		}
+	});
+
+	SetLevels(std::move(_levels));
+}
+
+Contours::Contours(
+	const Plane& _plane, std::vector <float> _levels, DirectX::XMFLOAT4 _color,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) : Polyline(_color, _pDevice, _pContext) {
+
+	DirectX::XMUINT2 size = _plane.GetGridSize();
+	m_width = size.x;
+	m_height = size.y;
+
+	DirectX::XMFLOAT2 dimensions = _plane.GetDimensions();
+	float offsetX = dimensions.x / (m_width - 1U), offsetY = dimensions.y / (m_height - 1U);
+
+	m_positions.resize(static_cast <size_t> (m_width) * m_height);
+	m_values.assign(m_positions.size(), 0.0f);
+	for (size_t i = 0; i < m_height; i++) {
+		for (size_t j = 0; j < m_width; j++) {
+			m_positions[i * m_width + j] = { -dimensions.x / 2 + j * offsetX, dimensions.y / 2 - i * offsetY, 0.0f };
+		}
+	}
+
+	// flat shaded planes don't share vertices between triangles, so the heights are gathered by grid position like Plane::SetHeights does
+	std::vector <DirectX::XMFLOAT3> vertices;
+	_plane.GetPositions(vertices);
+	for (const DirectX::XMFLOAT3& vertex : vertices) {
+		size_t row = static_cast <size_t> (std::lround((dimensions.y / 2 - vertex.y) / offsetY));
+		size_t column = static_cast <size_t> (std::lround((vertex.x + dimensions.x / 2) / offsetX));
+		size_t index = std::min <size_t> (row, m_height - 1U) * m_width + std::min <size_t> (column, m_width - 1U);
+
+		m_positions[index].z = vertex.z;
+		m_values[index] = vertex.z;
+	}
+
+	SetLevels(std::move(_levels));
+}
+
+void Contours::SetLevels(std::vector <float> _levels) {
+	std::sort(_levels.begin(), _levels.end());
+	_levels.erase(std::unique(_levels.begin(), _levels.end()), _levels.end());
+	m_levels = std::move(_levels);
+
+	InitVertices();
+}
+
+DirectX::XMFLOAT3 Contours::EdgePoint(uint64_t _key, float _level) const {
+	size_t a = static_cast <size_t> (_key >> 1);
+	size_t b = (_key & 1U) ? a + m_width : a + 1U;
+
+	float t = m_values[b] != m_values[a] ? (_level - m_values[a]) / (m_values[b] - m_values[a]) : 0.5f;
+
+	DirectX::XMFLOAT3 p;
+	DirectX::XMStoreFloat3(&p, DirectX::XMVectorLerp(DirectX::XMLoadFloat3(&m_positions[a]), DirectX::XMLoadFloat3(&m_positions[b]), t));
+	return p;
+}
+
+void Contours::InitVertices() {
+	Clear();
+
+	if (m_levels.empty() || m_values.size() < 4) {
+		Upload();
+		return;
+	}
+
+	const CaseTable& table = GetCaseTable();
+	const uint32_t cellsX = m_width - 1U, cellsY = m_height - 1U;
+	const uint32_t tilesX = (cellsX + s_tileSize - 1U) / s_tileSize, tilesY = (cellsY + s_tileSize - 1U) / s_tileSize;
+
+	// segments of every level crossing a tile
+	std::vector <std::vector <Segment>> tiles(static_cast <size_t> (tilesX) * tilesY);
+	ParallelFor(0, tiles.size(), [&](size_t _begin, size_t _end) {
+		for (size_t t = _begin; t < _end; t++) {
+			uint32_t x0 = static_cast <uint32_t> (t % tilesX) * s_tileSize, x1 = std::min(x0 + s_tileSize, cellsX);
+			uint32_t y0 = static_cast <uint32_t> (t / tilesX) * s_tileSize, y1 = std::min(y0 + s_tileSize, cellsY);
+
+			for (uint32_t y = y0; y < y1; y++) {
+				for (uint32_t x = x0; x < x1; x++) {
+					uint64_t index = static_cast <uint64_t> (y) * m_width + x;
+					float v[4] = { m_values[index], m_values[index + 1U], m_values[index + m_width + 1U], m_values[index + m_width] };
+					uint64_t edges[4] = { index << 1, (index + 1U) << 1 | 1U, (index + m_width) << 1, index << 1 | 1U };
+
+					// a level crosses the cell if some corner lies below it and another one doesn't
+					float lo = std::min(std::min(v[0], v[1]), std::min(v[2], v[3]));
+					float hi = std::max(std::max(v[0], v[1]), std::max(v[2], v[3]));
+					auto first = std::upper_bound(m_levels.begin(), m_levels.end(), lo);
+					auto last = std::upper_bound(first, m_levels.end(), hi);
+
+					for (auto level = first; level != last; level++) {
+						uint32_t mask = (v[0] < *level) | (v[1] < *level) << 1 | (v[2] < *level) << 2 | (v[3] < *level) << 3;
+						bool centerInside = 0.25f * (v[0] + v[1] + v[2] + v[3]) < *level;
+						const CellCase& cell = centerInside ? table.connected[mask] : table.separated[mask];
+
+						for (int8_t s = 0; s < cell.count; s++) {
+							tiles[t].push_back({
+								static_cast <uint32_t> (level - m_levels.begin()),
+								edges[cell.segments[s][0]], edges[cell.segments[s][1]]
+							});
+						}
+					}
+				}
+			}
+		}
+	});
+
+	// group the segments by level
+	std::vector <size_t> levelOffset(m_levels.size() + 1U, 0);
+	for (const auto& tile : tiles) {
+		for (const Segment& segment : tile) levelOffset[segment.level + 1U]++;
+	}
+	for (size_t l = 0; l < m_levels.size(); l++) levelOffset[l + 1U] += levelOffset[l];
+
+	std::vector <std::pair <uint64_t, uint64_t>> segments(levelOffset.back());
+	std::vector <size_t> cursor(levelOffset.begin(), levelOffset.end() - 1);
+	for (auto& tile : tiles) {
+		for (const Segment& segment : tile) segments[cursor[segment.level]++] = { segment.from, segment.to };
+		tile = std::vector <Segment>();
+	}
+
+	// join the segments of every level into strips, (end offset into points, closed) per strip
+	std::vector <std::vector <DirectX::XMFLOAT3>> points(m_levels.size());
+	std::vector <std::vector <std::pair <size_t, bool>>> strips(m_levels.size());
+	ParallelFor(0, m_levels.size(), [&](size_t _begin, size_t _end) {
+		for (size_t l = _begin; l < _end; l++) {
+			auto begin = segments.begin() + levelOffset[l], end = segments.begin() + levelOffset[l + 1U];
+			std::sort(begin, end);
+
+			size_t count = end - begin;
+			std::vector <size_t> next(count, count);
+			std::vector <bool> hasPrev(count, false), visited(count, false);
+			for (size_t i = 0; i < count; i++) {
+				auto found = std::lower_bound(begin, end, std::make_pair(begin[i].second, static_cast <uint64_t> (0)));
+				if (found != end && found->first == begin[i].second) {
+					next[i] = found - begin;
+					hasPrev[next[i]] = true;
+				}
+			}
+
+			auto trace = [&](size_t _start) {
+				points[l].push_back(EdgePoint(begin[_start].first, m_levels[l]));
+
+				size_t i = _start;
+				for (; i != count && !visited[i]; i = next[i]) {
+					visited[i] = true;
+					if (next[i] != _start) points[l].push_back(EdgePoint(begin[i].second, m_levels[l]));
+				}
+				strips[l].push_back({ points[l].size(), i == _start });
+			};
+
+			// open strips start on the grid boundary, whatever is left forms closed loops
+			for (size_t i = 0; i < count; i++) {
+				if (!hasPrev[i]) trace(i);
+			}
+			for (size_t i = 0; i < count; i++) {
+				if (!visited[i]) trace(i);
+			}
+		}
+	});
+
+	for (size_t l = 0; l < m_levels.size(); l++) {
+		size_t start = 0;
+		for (const auto& strip : strips[l]) {
+			AddStrip(points[l].data() + start, strip.first - start, strip.second);
+			start = strip.first;
+		}
+	}
+
+	Upload();
+}
\ No newline at end of file
@@ -0,0 +1,289 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Object/Curve.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace Cass;
+
+namespace {
+	// uniform intervals the domain is split into, each is split at least s_minDepth times so that
+	// oscillations don't hide between samples, straight runs are merged again afterwards
+	const uint32_t s_seedCount = 32;
+	const uint32_t s_minDepth = 4;
+	const uint32_t s_maxDepth = 14;
+
+	// resample once the pixel size moved by more than this factor in either direction
+	const float s_resampleRatio = 1.5f;
+
+	bool IsFinite(DirectX::XMFLOAT3 _p) {
+		return std::isfinite(_p.x) && std::isfinite(_p.y) && std::isfinite(_p.z);
+	}
+
+	float DistanceToSegment(DirectX::XMFLOAT3 _p, DirectX::XMFLOAT3 _a, DirectX::XMFLOAT3 _b) {
+		DirectX::XMVECTOR p = DirectX::XMLoadFloat3(&_p), a = DirectX::XMLoadFloat3(&_a), b = DirectX::XMLoadFloat3(&_b);
+		DirectX::XMVECTOR ab = DirectX::XMVectorSubtract(b, a), ap = DirectX::XMVectorSubtract(p, a);
+
+		float lengthSq = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(ab));
+		float t = lengthSq > 0.0f ? DirectX::XMVectorGetX(DirectX::XMVector3Dot(ap, ab)) / lengthSq : 0.0f;
+		t = std::min(std::max(t, 0.0f), 1.0f);
+
+		return DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVectorSubtract(ap, DirectX::XMVectorScale(ab, t))));
+	}
+
+	/**
+	* Directions from an anchor that pass within a tolerance of every point added, as a cone of a unit axis and a half angle
+	* the cone stays inside the intersection of the cones of the single points, so it may reject a direction that would do but never
+	* accepts one that misses a point, worked out in double as the half angles of far points are tiny
+	*/
+	struct DirectionCone {
+		double axis[3];
+		double angle;
+
+		// length a chord needs to pass beside the farthest point rather than end before it
+		double reach;
+		bool bounded;
+
+		void Reset() {
+			angle = reach = 0.0;
+			bounded = false;
+		}
+
+		static double Angle(const double* _u, const double* _v) {
+			double cross[3] = { _u[1] * _v[2] - _u[2] * _v[1], _u[2] * _v[0] - _u[0] * _v[2], _u[0] * _v[1] - _u[1] * _v[0] };
+			double dot = _u[0] * _v[0] + _u[1] * _v[1] + _u[2] * _v[2];
+			return std::atan2(std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot);
+		}
+
+		/**
+		* @brief Unit direction from _a to _b and the distance, false if they coincide
+		*/
+		static bool Direction(DirectX::XMFLOAT3 _a, DirectX::XMFLOAT3 _b, double* _oDir, double& _oLength) {
+			_oDir[0] = static_cast <double> (_b.x) - _a.x;
+			_oDir[1] = static_cast <double> (_b.y) - _a.y;
+			_oDir[2] = static_cast <double> (_b.z) - _a.z;
+			_oLength = std::sqrt(_oDir[0] * _oDir[0] + _oDir[1] * _oDir[1] + _oDir[2] * _oDir[2]);
+			if (_oLength == 0.0) return false;
+
+			for (int k = 0; k < 3; k++) _oDir[k] /= _oLength;
+			return true;
+		}
+
+		/**
+		* @brief Narrow the cone to the directions from _anchor passing within _tolerance of _point
+		*/
+		void Add(DirectX::XMFLOAT3 _anchor, DirectX::XMFLOAT3 _point, float _tolerance) {
+			double dir[3], length;
+			if (!Direction(_anchor, _point, dir, length) || length <= _tolerance) return;
+
+			reach = std::max(reach, length);
+			double radius = std::asin(_tolerance / length);
+			if (!bounded) {
+				std::copy(dir, dir + 3, axis);
+				angle = radius;
+				bounded = true;
+				return;
+			}
+			if (angle < 0.0) return;
+
+			// the largest cone in both lies on the great circle through the two axes, measured from the current one towards dir
+			double theta = Angle(axis, dir), s = std::sin(theta);
+			double lo = std::max(-angle, theta - radius), hi = std::min(angle, theta + radius);
+			if (hi < lo || (theta > 1e-9 && s < 1e-9)) {
+				angle = -1.0;
+				return;
+			}
+
+			double center = 0.5 * (lo + hi);
+			angle = 0.5 * (hi - lo);
+			if (theta <= 1e-9) return;
+
+			double wa = std::sin(theta - center) / s, wb = std::sin(center) / s;
+			for (int k = 0; k < 3; k++) axis[k] = wa * axis[k] + wb * dir[k];
+
+			double norm = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+			for (int k = 0; k < 3; k++) axis[k] /= norm;
+		}
+
+		/**
+		* @brief Whether the chord from _anchor to _end passes every point added
+		*/
+		bool Accepts(DirectX::XMFLOAT3 _anchor, DirectX::XMFLOAT3 _end) const {
+			if (!bounded) return true;
+			if (angle < 0.0) return false;
+
+			double dir[3], length;
+			if (!Direction(_anchor, _end, dir, length) || length < reach) return false;
+			return Angle(axis, dir) <= angle;
+		}
+	};
+}
+
+//
+// ---------- class Curve
+//
+
+Curve::Curve(
+	Function _func, DirectX::XMFLOAT2 _range, DirectX::XMFLOAT4 _color,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext,
+	float _pixelTolerance, float _angleTolerance) : Polyline(_color, _pDevice, _pContext) {
+
+	if (!_func) {
+		throw std::invalid_argument("Curve needs a function to sample");
+	}
+
+	m_func = _func;
+	m_range = _range;
+	m_pixelTolerance = std::max(_pixelTolerance, 0.01f);
+	m_cosAngleTolerance = std::cos(std::min(std::max(_angleTolerance, 0.1f), 180.0f) * Math::PI_180);
+
+	// until the camera is known sample relative to the extent of the curve
+	float lb[3] = { 0.0f, 0.0f, 0.0f }, ub[3] = { 0.0f, 0.0f, 0.0f };
+	bool any = false;
+	for (uint32_t i = 0; i <= s_seedCount; i++) {
+		DirectX::XMFLOAT3 p = m_func(m_range.x + (m_range.y - m_range.x) * i / s_seedCount);
+		if (!IsFinite(p)) continue;
+
+		float c[3] = { p.x, p.y, p.z };
+		for (int k = 0; k < 3; k++) {
+			lb[k] = any ? std::min(lb[k], c[k]) : c[k];
+			ub[k] = any ? std::max(ub[k], c[k]) : c[k];
+		}
+		any = true;
+	}
+	float extent = std::sqrt((ub[0] - lb[0]) * (ub[0] - lb[0]) + (ub[1] - lb[1]) * (ub[1] - lb[1]) + (ub[2] - lb[2]) * (ub[2] - lb[2]));
+	m_tolerance = extent > 0.0f ? 1e-3f * extent : 1e-3f;
+
+	InitVertices();
+}
+
+Curve::Function Curve::Explicit(std::function <float(float)> _func) {
+	return [_func](float _x) {
+		return DirectX::XMFLOAT3 { _x, _func(_x), 0.0f };
+	};
+}
+
+void Curve::Render(const CameraFrame& _frame, Shader& _shader) {
+	DirectX::XMFLOAT3 center = m_bounds.GetPosition();
+	DirectX::XMStoreFloat3(&center, DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&center), GetTransformation()));
+
+	DirectX::XMFLOAT3 scale = GetScale();
+	float maxScale = std::max(std::max(std::abs(scale.x), std::abs(scale.y)), std::abs(scale.z));
+	float pixelSize = _frame.GetPixelSize(center);
+
+	if (pixelSize > 0.0f && maxScale > 0.0f) {
+		float tolerance = m_pixelTolerance * pixelSize / maxScale;
+		float ratio = tolerance / m_tolerance;
+
+		if (ratio > s_resampleRatio || ratio * s_resampleRatio < 1.0f) {
+			m_tolerance = tolerance;
+			InitVertices();
+		}
+	}
+
+	Empty::Render(_frame, _shader);
+}
+
+void Curve::InitVertices() {
+	Clear();
+
+	std::vector <DirectX::XMFLOAT3> points;
+	float t0 = m_range.x;
+	DirectX::XMFLOAT3 p0 = m_func(t0);
+	points.push_back(p0);
+
+	for (uint32_t i = 1; i <= s_seedCount; i++) {
+		float t1 = i == s_seedCount ? m_range.y : m_range.x + (m_range.y - m_range.x) * i / s_seedCount;
+		DirectX::XMFLOAT3 p1 = m_func(t1);
+
+		Subdivide(t0, p0, t1, p1, 0, points);
+		t0 = t1;
+		p0 = p1;
+	}
+
+	// every run of finite points becomes a strip
+	std::vector <DirectX::XMFLOAT3> strip;
+	for (size_t i = 0; i <= points.size(); i++) {
+		if (i < points.size() && IsFinite(points[i])) {
+			strip.push_back(points[i]);
+			continue;
+		}
+
+		if (strip.size() > 1) {
+			Simplify(strip);
+			AddStrip(strip.data(), strip.size());
+		}
+		strip.clear();
+	}
+
+	Upload();
+}
+
+void Curve::Subdivide(float _t0, DirectX::XMFLOAT3 _p0, float _t1, DirectX::XMFLOAT3 _p1, uint32_t _depth, std::vector <DirectX::XMFLOAT3>& _oPoints) const {
+	float tm = 0.5f * (_t0 + _t1);
+	DirectX::XMFLOAT3 pm = m_func(tm);
+
+	bool refine = NeedsRefinement(_p0, pm, _p1);
+	if ((refine || _depth < s_minDepth) && _depth < s_maxDepth) {
+		Subdivide(_t0, _p0, tm, pm, _depth + 1U, _oPoints);
+		Subdivide(tm, pm, _t1, _p1, _depth + 1U, _oPoints);
+		return;
+	}
+
+	// out of depth, the interval still hides detail or a discontinuity so keep what was found
+	if (refine) _oPoints.push_back(pm);
+	_oPoints.push_back(_p1);
+}
+
+bool Curve::NeedsRefinement(DirectX::XMFLOAT3 _p0, DirectX::XMFLOAT3 _pm, DirectX::XMFLOAT3 _p1) const {
+	bool finite0 = IsFinite(_p0), finiteM = IsFinite(_pm), finite1 = IsFinite(_p1);
+
+	// narrow down where the curve stops being defined
+	if (!finite0 || !finiteM || !finite1) return finite0 || finiteM || finite1;
+
+	if (DistanceToSegment(_pm, _p0, _p1) > m_tolerance) return true;
+
+	// a sharp turn between long segments may hide a feature the midpoint happened to miss
+	DirectX::XMVECTOR a = DirectX::XMLoadFloat3(&_p0), m = DirectX::XMLoadFloat3(&_pm), b = DirectX::XMLoadFloat3(&_p1);
+	DirectX::XMVECTOR u = DirectX::XMVectorSubtract(m, a), v = DirectX::XMVectorSubtract(b, m);
+	float lengthU = DirectX::XMVectorGetX(DirectX::XMVector3Length(u)), lengthV = DirectX::XMVectorGetX(DirectX::XMVector3Length(v));
+
+	if (lengthU > 0.0f && lengthV > 0.0f && lengthU + lengthV > 4.0f * m_tolerance) {
+		float cosAngle = DirectX::XMVectorGetX(DirectX::XMVector3Dot(u, v)) / (lengthU * lengthV);
+		if (cosAngle < m_cosAngleTolerance) return true;
+	}
+
+	return false;
+}
+
+void Curve::Simplify(std::vector <DirectX::XMFLOAT3>& _points) const {
+	if (_points.size() < 3) return;
+
+	std::vector <DirectX::XMFLOAT3> kept;
+	kept.push_back(_points.front());
+
+	// keep point i only if the chord from the anchor to its successor misses one of the points in between
+	// the points since the anchor are only seen through the cone of directions passing all of them, so a run stays linear
+	DirectionCone cone;
+	cone.Reset();
+
+	size_t anchor = 0;
+	for (size_t i = 1; i + 1 < _points.size(); i++) {
+		cone.Add(_points[anchor], _points[i], m_tolerance);
+		if (cone.Accepts(_points[anchor], _points[i + 1])) continue;
+
+		kept.push_back(_points[i]);
+		anchor = i;
+		cone.Reset();
+	}
+
+	kept.push_back(_points.back());
+	_points.swap(kept);
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Object/DecimatedSeries.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+using namespace Cass;
+
+namespace {
+	// points transformed per call of the stream transform
+	const size_t s_batchSize = 1024;
+
+	// parts of the series decimated concurrently, several per thread to even out the culled ones
+	const size_t s_chunksPerThread = 4;
+	const size_t s_minChunk = 1 << 16;
+}
+
+//
+// ---------- class DecimatedSeries
+//
+
+DecimatedSeries::DecimatedSeries(std::vector <DirectX::XMFLOAT2> _points, DirectX::XMFLOAT4 _color, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) :
+	Polyline(_color, _pDevice, _pContext) {
+
+	m_lastViewport = { 0.0f, 0.0f };
+	SetPoints(std::move(_points));
+}
+
+void DecimatedSeries::SetPoints(std::vector <DirectX::XMFLOAT2> _points) {
+	m_points = std::move(_points);
+	m_sorted = std::is_sorted(m_points.begin(), m_points.end(), [](const DirectX::XMFLOAT2& _a, const DirectX::XMFLOAT2& _b) {
+		return _a.x < _b.x;
+	});
+
+	m_lb = m_ub = { 0.0f, 0.0f, 0.0f };
+	if (!m_points.empty()) {
+		m_lb = m_ub = { m_points[0].x, m_points[0].y, 0.0f };
+	}
+	for (const DirectX::XMFLOAT2& point : m_points) {
+		m_lb = { std::min(m_lb.x, point.x), std::min(m_lb.y, point.y), 0.0f };
+		m_ub = { std::max(m_ub.x, point.x), std::max(m_ub.y, point.y), 0.0f };
+	}
+	SetBounds(m_lb, m_ub);
+
+	m_dirty = true;
+	m_hoverIndex.Invalidate();
+}
+
+void DecimatedSeries::InitVertices() {
+	// nothing to reduce against until the first frame
+	m_dirty = true;
+}
+
+void DecimatedSeries::Render(const CameraFrame& _frame, Shader& _shader) {
+	DirectX::XMMATRIX toScreen = DirectX::XMMatrixMultiply(
+		GetTransformation(),
+		_frame.GetViewProjection()
+	);
+	DirectX::XMFLOAT2 viewport = _frame.GetViewportSize();
+
+	DirectX::XMFLOAT4X4 transform;
+	DirectX::XMStoreFloat4x4(&transform, toScreen);
+	if (m_dirty || memcmp(&transform, &m_lastTransform, sizeof(transform)) != 0 ||
+		viewport.x != m_lastViewport.x || viewport.y != m_lastViewport.y) {
+		Decimate(_frame, toScreen, viewport);
+
+		m_lastTransform = transform;
+		m_lastViewport = viewport;
+		m_dirty = false;
+	}
+
+	Empty::Render(_frame, _shader);
+}
+
+bool DecimatedSeries::FindPoint(const CameraFrame& _frame, float _x, float _y, float _radius, DirectX::XMFLOAT3& _oPoint, float& _oDistance) {
+	if (m_points.empty()) return false;
+
+	m_hoverIndex.Update(_frame, GetTransformation(), m_points.data(), m_points.size());
+	uint32_t index = m_hoverIndex.Nearest(_x, _y, _radius, _oDistance);
+	if (index == ScreenPointIndex::s_nullPoint) return false;
+
+	DirectX::XMStoreFloat3(&_oPoint, DirectX::XMVector3TransformCoord(
+		DirectX::XMVectorSet(m_points[index].x, m_points[index].y, 0.0f, 1.0f),
+		GetTransformation()
+	));
+	return true;
+}
+
+void DecimatedSeries::Decimate(const CameraFrame& _frame, DirectX::FXMMATRIX _toScreen, DirectX::XMFLOAT2 _viewport) {
+	Clear();
+	if (m_points.size() < 2 || _viewport.x <= 0.0f) {
+		Upload();
+		SetBounds(m_lb, m_ub);
+		return;
+	}
+
+	size_t begin = 0, end = m_points.size();
+	if (m_sorted) VisibleRange(_frame, begin, end);
+
+	// independent chunks, a column cut by a chunk boundary is joined back below
+	size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+	size_t chunkCount = std::max <size_t> (1, std::min((end - begin) / s_minChunk, threadCount * s_chunksPerThread));
+	std::vector <std::vector <Column>> chunks(chunkCount);
+
+	ParallelFor(0, chunkCount, [&](size_t _first, size_t _last) {
+		for (size_t c = _first; c < _last; c++) {
+			size_t b = begin + (end - begin) * c / chunkCount, e = begin + (end - begin) * (c + 1) / chunkCount;
+			DecimateRange(b, e, _toScreen, _viewport, chunks[c]);
+		}
+	});
+
+	std::vector <Column> columns;
+	for (auto& chunk : chunks) {
+		size_t i = 0;
+		if (!columns.empty() && !chunk.empty() && columns.back().column == chunk.front().column) {
+			Column& joined = columns.back();
+			const Column& next = chunk.front();
+
+			if (next.minY < joined.minY) { joined.minY = next.minY; joined.min = next.min; }
+			if (next.maxY > joined.maxY) { joined.maxY = next.maxY; joined.max = next.max; }
+			joined.last = next.last;
+			i = 1;
+		}
+		columns.insert(columns.end(), chunk.begin() + i, chunk.end());
+	}
+
+	// the kept samples of every column in series order, consecutive columns join up by themselves
+	std::vector <DirectX::XMFLOAT3> strip;
+	strip.reserve(columns.size() * 4);
+	for (const Column& column : columns) {
+		size_t samples[4] = { column.first, column.min, column.max, column.last };
+		std::sort(samples, samples + 4);
+
+		for (size_t i = 0; i < 4; i++) {
+			if (i > 0 && samples[i] == samples[i - 1]) continue;
+			strip.push_back({ m_points[samples[i]].x, m_points[samples[i]].y, 0.0f });
+		}
+	}
+
+	AddStrip(strip.data(), strip.size());
+	Upload();
+	SetBounds(m_lb, m_ub);
+}
+
+void DecimatedSeries::DecimateRange(size_t _begin, size_t _end, DirectX::FXMMATRIX _toScreen, DirectX::XMFLOAT2 _viewport, std::vector <Column>& _oColumns) const {
+	DirectX::XMFLOAT2 screen[s_batchSize];
+
+	// anything left or right of the screen collapses into a single column on that side
+	int64_t width = static_cast <int64_t> (_viewport.x);
+	Column current = { INT64_MIN, 0, 0, 0, 0, 0.0f, 0.0f };
+
+	for (size_t b = _begin; b < _end; b += s_batchSize) {
+		size_t count = std::min(s_batchSize, _end - b);
+		DirectX::XMVector2TransformCoordStream(screen, sizeof(DirectX::XMFLOAT2), m_points.data() + b, sizeof(DirectX::XMFLOAT2), count, _toScreen);
+
+		for (size_t i = 0; i < count; i++) {
+			float x = (screen[i].x * 0.5f + 0.5f) * _viewport.x, y = screen[i].y;
+			int64_t column = x < 0.0f ? -1 : (x >= _viewport.x ? width : static_cast <int64_t> (x));
+
+			if (column == current.column) {
+				if (y < current.minY) { current.minY = y; current.min = b + i; }
+				if (y > current.maxY) { current.maxY = y; current.max = b + i; }
+				current.last = b + i;
+				continue;
+			}
+
+			if (current.column != INT64_MIN) _oColumns.push_back(current);
+			current = { column, b + i, b + i, b + i, b + i, y, y };
+		}
+	}
+
+	if (current.column != INT64_MIN) _oColumns.push_back(current);
+}
+
+void DecimatedSeries::VisibleRange(const CameraFrame& _frame, size_t& _oBegin, size_t& _oEnd) const {
+	_oBegin = 0;
+	_oEnd = m_points.size();
+
+	float minX, maxX;
+	if (!_frame.GetPlaneRangeX(*this, minX, maxX)) return;
+
+	auto less = [](const DirectX::XMFLOAT2& _p, float _x) { return _p.x < _x; };
+	size_t first = std::lower_bound(m_points.begin(), m_points.end(), minX, less) - m_points.begin();
+	size_t last = std::lower_bound(m_points.begin(), m_points.end(), maxX, less) - m_points.begin();
+
+	// keep the neighbours outside so the line runs off the screen edges
+	_oBegin = first > 0 ? first - 1 : 0;
+	_oEnd = std::min(last + 1, m_points.size());
+}
\ No newline at end of file
@@ -0,0 +1,295 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Object/DomainColoring.hpp>
+#include <util.hpp>
+
+#include <DirectXPackedVector.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+using namespace Cass;
+
+namespace {
+	// texels per tile side, a multiple of 4 so rows split evenly into SIMD lanes
+	const uint32_t s_tileSize = 64;
+
+	// zoom levels per doubling of the extent
+	const int32_t s_levelsPerOctave = 8;
+
+	// cached tiles kept on top of the ones the texture can hold at once
+	const size_t s_spareTiles = 2048;
+
+	int64_t FloorDiv(int64_t _a, int64_t _b) {
+		int64_t q = _a / _b;
+		return (_a % _b != 0 && (_a < 0) != (_b < 0)) ? q - 1 : q;
+	}
+
+	int64_t Mod(int64_t _a, int64_t _b) {
+		int64_t r = _a % _b;
+		return r < 0 ? r + _b : r;
+	}
+
+	/**
+	* @brief Map _count values w = (_re[i], _im[i]) to RGBA, 4 at a time, _count must be a multiple of 4
+	*		 hue is arg(w), zeros go to black and poles to white, rings at every power of two of |w|
+	*/
+	void Shade(const float* _re, const float* _im, size_t _count, uint8_t* _rgba) {
+		using namespace DirectX;
+
+		const XMVECTOR one = XMVectorSplatOne();
+		const XMVECTOR two = XMVectorReplicate(2.0f);
+		const XMVECTOR half = XMVectorReplicate(0.5f);
+		const XMVECTOR gray = XMVectorReplicate(0.5f);
+
+		for (size_t k = 0; k < _count; k += 4) {
+			XMVECTOR re = XMLoadFloat4(reinterpret_cast <const XMFLOAT4*> (_re + k));
+			XMVECTOR im = XMLoadFloat4(reinterpret_cast <const XMFLOAT4*> (_im + k));
+
+			XMVECTOR modulus = XMVectorSqrt(XMVectorMultiplyAdd(re, re, XMVectorMultiply(im, im)));
+			XMVECTOR invalid = XMVectorIsNaN(modulus);
+
+			// hue in [0, 1) turned into a fully saturated color
+			XMVECTOR hue = XMVectorScale(XMVectorATan2(im, re), 1.0f / Math::PIx2);
+			hue = XMVectorScale(XMVectorSubtract(hue, XMVectorFloor(hue)), 6.0f);
+
+			XMVECTOR r = XMVectorSaturate(XMVectorSubtract(XMVectorAbs(XMVectorSubtract(hue, XMVectorReplicate(3.0f))), one));
+			XMVECTOR g = XMVectorSaturate(XMVectorSubtract(two, XMVectorAbs(XMVectorSubtract(hue, two))));
+			XMVECTOR b = XMVectorSaturate(XMVectorSubtract(two, XMVectorAbs(XMVectorSubtract(hue, XMVectorReplicate(4.0f)))));
+
+			// modulus rings, the clamp keeps log2 finite at zeros and poles
+			XMVECTOR ring = XMVectorLog2(XMVectorClamp(modulus, XMVectorReplicate(FLT_MIN), XMVectorReplicate(FLT_MAX)));
+			ring = XMVectorSubtract(ring, XMVectorFloor(ring));
+			XMVECTOR shade = XMVectorMultiplyAdd(ring, XMVectorReplicate(0.2f), XMVectorReplicate(0.8f));
+
+			r = XMVectorMultiply(r, shade);
+			g = XMVectorMultiply(g, shade);
+			b = XMVectorMultiply(b, shade);
+
+			// lightness 0 at zeros, 1/2 on the unit circle and 1 at poles, darken towards black or lighten towards white
+			XMVECTOR light = XMVectorScale(XMVectorATan(modulus), 2.0f / Math::PI);
+			XMVECTOR dark = XMVectorLess(light, half);
+			XMVECTOR t = XMVectorSubtract(XMVectorScale(light, 2.0f), one);
+			XMVECTOR scale = XMVectorScale(light, 2.0f);
+
+			r = XMVectorSelect(XMVectorMultiplyAdd(XMVectorSubtract(one, r), t, r), XMVectorMultiply(r, scale), dark);
+			g = XMVectorSelect(XMVectorMultiplyAdd(XMVectorSubtract(one, g), t, g), XMVectorMultiply(g, scale), dark);
+			b = XMVectorSelect(XMVectorMultiplyAdd(XMVectorSubtract(one, b), t, b), XMVectorMultiply(b, scale), dark);
+
+			r = XMVectorSelect(r, gray, invalid);
+			g = XMVectorSelect(g, gray, invalid);
+			b = XMVectorSelect(b, gray, invalid);
+
+			// one row per channel to one row per texel
+			XMMATRIX texels = XMMatrixTranspose(XMMATRIX(r, g, b, one));
+			for (size_t i = 0; i < 4; i++) {
+				PackedVector::XMStoreUByteN4(reinterpret_cast <PackedVector::XMUBYTEN4*> (_rgba + 4 * (k + i)), texels.r[i]);
+			}
+		}
+	}
+}
+
+//
+// ---------- class DomainColoring
+//
+
+DomainColoring::DomainColoring(
+	Kernel _kernel, DirectX::XMFLOAT2 _center, float _extent, DirectX::XMUINT2 _resolution, float _width,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) :
+	Plane(_width, _width * _resolution.y / std::max(1u, _resolution.x), 0, 0, _pDevice, _pContext, SHADING::SMOOTH) {
+
+	if (!_kernel) throw std::invalid_argument("Invalid kernel");
+	if (_resolution.x == 0 || _resolution.y == 0) throw std::invalid_argument("Invalid resolution");
+
+	m_kernel = _kernel;
+	m_resolution = _resolution;
+	m_level = INT32_MIN;
+	m_updateCount = 0;
+	m_evaluatedTiles = m_uploadedTiles = 0;
+
+	// one spare slot along each axis, a view that is not tile aligned straddles one more tile
+	m_slotCount = {
+		(_resolution.x + s_tileSize - 1) / s_tileSize + 1,
+		(_resolution.y + s_tileSize - 1) / s_tileSize + 1
+	};
+	m_slots.assign(static_cast <size_t> (m_slotCount.x) * m_slotCount.y, TileKey { INT32_MIN, 0, 0 });
+	m_cacheBudget = m_slots.size() + s_spareTiles;
+
+	// no mips, they would be regenerated for the whole texture on every tile update
+	uint32_t texWidth = m_slotCount.x * s_tileSize, texHeight = m_slotCount.y * s_tileSize;
+	m_texture = std::make_shared <Texture> (D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_WRAP);
+	ThrowIfFailed(m_texture->LoadFromMemory(
+		texWidth, texHeight, std::vector <uint8_t> (static_cast <size_t> (texWidth) * texHeight * 4, 0),
+		_pDevice, _pContext, false
+	));
+
+	SetView(_center, _extent);
+}
+
+DomainColoring::Kernel DomainColoring::Scalar(Function _func) {
+	return [_func](const float* _re, const float* _im, float* _outRe, float* _outIm, size_t _count) {
+		for (size_t i = 0; i < _count; i++) {
+			std::complex <float> w = _func({ _re[i], _im[i] });
+			_outRe[i] = w.real();
+			_outIm[i] = w.imag();
+		}
+	};
+}
+
+void DomainColoring::SetView(DirectX::XMFLOAT2 _center, float _extent) {
+	if (!(_extent > 0.0f) || !std::isfinite(_extent)) return;
+
+	int32_t level = static_cast <int32_t> (std::lround(std::log2(static_cast <double> (_extent) / m_resolution.x) * s_levelsPerOctave));
+	if (level != m_level) {
+		// tiles of another level never line up with the texture contents
+		std::fill(m_slots.begin(), m_slots.end(), TileKey { INT32_MIN, 0, 0 });
+	}
+
+	m_level = level;
+	m_pixelSize = std::exp2(static_cast <double> (level) / s_levelsPerOctave);
+	m_centerX = std::llround(_center.x / m_pixelSize);
+	m_centerY = std::llround(_center.y / m_pixelSize);
+	m_dirty = true;
+}
+
+void DomainColoring::SetKernel(Kernel _kernel) {
+	if (!_kernel) return;
+
+	m_kernel = _kernel;
+	m_cache.clear();
+	std::fill(m_slots.begin(), m_slots.end(), TileKey { INT32_MIN, 0, 0 });
+	m_dirty = true;
+}
+
+DirectX::XMFLOAT2 DomainColoring::GetCenter() const {
+	return { static_cast <float> (m_centerX * m_pixelSize), static_cast <float> (m_centerY * m_pixelSize) };
+}
+
+void DomainColoring::Render(const CameraFrame& _frame, Shader& _shader) {
+	if (m_dirty) {
+		UpdateTiles();
+		UpdateUVs();
+		m_dirty = false;
+	}
+
+	Plane::Render(_frame, _shader);
+}
+
+size_t DomainColoring::TileHash::operator () (const TileKey& _key) const {
+	uint64_t h = static_cast <uint64_t> (_key.x) * 0x9E3779B97F4A7C15ull;
+	h ^= static_cast <uint64_t> (_key.y) * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+	h ^= static_cast <uint64_t> (static_cast <uint32_t> (_key.level)) * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+	return static_cast <size_t> (h);
+}
+
+void DomainColoring::EvaluateTile(const TileKey& _key, Tile& _tile) const {
+	float re[s_tileSize], im[s_tileSize], outRe[s_tileSize], outIm[s_tileSize];
+
+	_tile.colors.resize(static_cast <size_t> (s_tileSize) * s_tileSize * 4);
+	for (size_t j = 0; j < s_tileSize; j++) {
+		re[j] = static_cast <float> ((_key.x * s_tileSize + static_cast <int64_t> (j) + 0.5) * m_pixelSize);
+	}
+
+	// texture rows run top down, texel y grows upwards
+	for (size_t i = 0; i < s_tileSize; i++) {
+		int64_t y = (_key.y + 1) * s_tileSize - 1 - static_cast <int64_t> (i);
+		std::fill(im, im + s_tileSize, static_cast <float> ((y + 0.5) * m_pixelSize));
+
+		m_kernel(re, im, outRe, outIm, s_tileSize);
+		Shade(outRe, outIm, s_tileSize, _tile.colors.data() + i * s_tileSize * 4);
+	}
+}
+
+void DomainColoring::UpdateTiles() {
+	m_updateCount++;
+	m_evaluatedTiles = m_uploadedTiles = 0;
+
+	// texel range of the view, then the tiles it touches
+	int64_t x0 = m_centerX - m_resolution.x / 2, y0 = m_centerY - m_resolution.y / 2;
+	int64_t tx0 = FloorDiv(x0, s_tileSize), tx1 = FloorDiv(x0 + m_resolution.x - 1, s_tileSize);
+	int64_t ty0 = FloorDiv(y0, s_tileSize), ty1 = FloorDiv(y0 + m_resolution.y - 1, s_tileSize);
+
+	std::vector <std::pair <size_t, Tile*>> uploads;
+	std::vector <std::pair <TileKey, Tile*>> missing;
+	for (int64_t ty = ty0; ty <= ty1; ty++) {
+		for (int64_t tx = tx0; tx <= tx1; tx++) {
+			TileKey key = { m_level, tx, ty };
+			size_t slot = static_cast <size_t> (Mod(-(ty + 1), m_slotCount.y) * m_slotCount.x + Mod(tx, m_slotCount.x));
+
+			auto it = m_cache.find(key);
+			if (it == m_cache.end()) {
+				it = m_cache.emplace(key, Tile {}).first;
+				missing.push_back({ key, &it->second });
+			}
+			it->second.lastUse = m_updateCount;
+
+			if (!(m_slots[slot] == key)) {
+				m_slots[slot] = key;
+				uploads.push_back({ slot, &it->second });
+			}
+		}
+	}
+
+	ParallelFor(0, missing.size(), [&](size_t _begin, size_t _end) {
+		for (size_t i = _begin; i < _end; i++) {
+			EvaluateTile(missing[i].first, *missing[i].second);
+		}
+	});
+
+	for (auto& upload : uploads) {
+		uint32_t x = static_cast <uint32_t> (upload.first % m_slotCount.x) * s_tileSize;
+		uint32_t y = static_cast <uint32_t> (upload.first / m_slotCount.x) * s_tileSize;
+		ThrowIfFailed(m_texture->UpdateFromMemory(x, y, s_tileSize, s_tileSize, upload.second->colors.data(), s_tileSize * 4, m_deviceContext.Get()));
+	}
+
+	m_evaluatedTiles = missing.size();
+	m_uploadedTiles = uploads.size();
+
+	TrimCache();
+}
+
+void DomainColoring::UpdateUVs() {
+	// the texture wraps, so the view maps to a window starting anywhere in it
+	double texWidth = static_cast <double> (m_slotCount.x) * s_tileSize, texHeight = static_cast <double> (m_slotCount.y) * s_tileSize;
+	int64_t x0 = m_centerX - m_resolution.x / 2, y1 = m_centerY - m_resolution.y / 2 + m_resolution.y;
+
+	float u0 = static_cast <float> (Mod(x0, static_cast <int64_t> (texWidth)) / texWidth);
+	float v0 = static_cast <float> (Mod(-y1, static_cast <int64_t> (texHeight)) / texHeight);
+	float du = static_cast <float> (m_resolution.x / texWidth), dv = static_cast <float> (m_resolution.y / texHeight);
+
+	DirectX::XMUINT2 grid = GetGridSize();
+	for (size_t i = 0; i < grid.y; i++) {
+		for (size_t j = 0; j < grid.x; j++) {
+			m_vertexData[i * grid.x + j].uv = {
+				u0 + du * j / (grid.x - 1),
+				v0 + dv * i / (grid.y - 1)
+			};
+		}
+	}
+
+	SetVertexBuffer();
+}
+
+void DomainColoring::TrimCache() {
+	if (m_cache.size() <= m_cacheBudget) return;
+
+	// drop down to the budget in one go, so trimming is rare
+	std::vector <uint64_t> uses;
+	uses.reserve(m_cache.size());
+	for (auto& tile : m_cache) uses.push_back(tile.second.lastUse);
+
+	size_t excess = m_cache.size() - m_cacheBudget + m_cacheBudget / 4;
+	std::nth_element(uses.begin(), uses.begin() + (excess - 1), uses.end());
+	uint64_t threshold = std::min(uses[excess - 1], m_updateCount - 1);
+
+	for (auto it = m_cache.begin(); it != m_cache.end();) {
+		if (it->second.lastUse <= threshold) it = m_cache.erase(it);
+		else ++it;
+	}
+}
\ No newline at end of file
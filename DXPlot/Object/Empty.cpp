@@ -7,8 +7,10 @@
 #include <Object/Empty.hpp>
 #include <util.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <stdexcept>
 
 using namespace Cass;
 
@@ -16,6 +18,8 @@ using namespace Cass;
 
 Empty::Empty(size_t _vertCount) {
 	m_vertCount = _vertCount;
+	m_indexCount = 0;
+	m_topology = D3D11_PRIMITIVE_TOPOLOGY_LINELIST;
 }
 
 Empty::~Empty() { }
@@ -34,15 +38,39 @@ void Empty::CreateBuffers() {
 	Cass::ThrowIfFailed(m_device->CreateBuffer(&bdc, nullptr, m_vertexBuffer.ReleaseAndGetAddressOf()));
 }
 
-void Empty::Render(Cass::Camera& camera, Cass::Shader& shader) {
+void Empty::Render(const Cass::CameraFrame& _frame, Cass::Shader& shader) {
+	Draw(_frame, shader, *this);
+}
+
+void Empty::Draw(const Cass::CameraFrame& _frame, Cass::Shader& _shader, const Transform& _model) {
+	if (!m_vertexBuffer || m_vertCount == 0) return;
+
 	UINT strides = sizeof(detail::EMPTY_VERTEX_DATA);
 	UINT offsets = 0;
 
-	shader.SetActive(m_deviceContext.Get(), camera, m_transformation);
+	_shader.SetActive(m_deviceContext.Get(), _frame, _model);
 
 	m_deviceContext->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &strides, &offsets);
-	m_deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
-	m_deviceContext->Draw(m_vertCount, 0);
+	m_deviceContext->IASetPrimitiveTopology(m_topology);
+
+	if (m_indexBuffer) {
+		m_deviceContext->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+		m_deviceContext->DrawIndexed(m_indexCount, 0, 0);
+	}
+	else m_deviceContext->Draw(m_vertCount, 0);
+}
+
+size_t Empty::GetByteSize() const {
+	size_t size = 0;
+	for (ID3D11Buffer* buffer : { m_vertexBuffer.Get(), m_indexBuffer.Get() }) {
+		if (!buffer) continue;
+
+		D3D11_BUFFER_DESC desc;
+		buffer->GetDesc(&desc);
+		size += desc.ByteWidth;
+	}
+
+	return size;
 }
 
 void Empty::SetBuffers() {
@@ -68,7 +96,7 @@ void Empty::SetBuffers() {
 		ub.z = std::max(ub.z, m_vertexData[i].position.z);
 	}
 
-	m_bounds.Calculate(lb, ub);
+	SetBounds(lb, ub);
 }
 
 // ---------- class Line
@@ -155,6 +183,250 @@ void Grid::InitVertices() {
 	SetBuffers();
 }
 
+// ---------- class Polyline
+
+Polyline::Polyline(DirectX::XMFLOAT4 _color, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) : Empty(0) {
+	m_color = _color;
+	m_stripCount = 0;
+	m_vertCapacity = m_indexCapacity = 0;
+
+	// strips are separated by the strip cut index
+	m_topology = D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP;
+
+	m_device = _pDevice;
+	m_deviceContext = _pContext;
+}
+
+void Polyline::Clear() {
+	m_points.clear();
+	m_indices.clear();
+	m_stripCount = 0;
+}
+
+void Polyline::AddStrip(const DirectX::XMFLOAT3* _points, size_t _count, bool _closed) {
+	if (_points == nullptr || _count < 2) return;
+
+	if (m_stripCount > 0) m_indices.push_back(0xFFFFFFFF);
+
+	uint32_t first = static_cast <uint32_t> (m_points.size());
+	for (size_t i = 0; i < _count; i++) {
+		m_indices.push_back(static_cast <uint32_t> (m_points.size()));
+		m_points.push_back(_points[i]);
+	}
+	if (_closed) m_indices.push_back(first);
+
+	m_stripCount++;
+}
+
+void Polyline::InitVertices() {
+	Upload();
+}
+
+void Polyline::Upload() {
+	m_vertCount = m_points.size();
+	m_indexCount = m_indices.size();
+	if (m_vertCount == 0) return;
+
+	// grow with some headroom, shrinking is never needed
+	if (m_vertCount > m_vertCapacity) {
+		m_vertCapacity = m_vertCount + m_vertCount / 2;
+		m_vertexData = std::unique_ptr <detail::EMPTY_VERTEX_DATA[]>(new detail::EMPTY_VERTEX_DATA[m_vertCapacity]);
+
+		D3D11_BUFFER_DESC bdc;
+		ZeroMemory(&bdc, sizeof(bdc));
+		bdc.Usage = D3D11_USAGE_DYNAMIC;
+		bdc.ByteWidth = sizeof(detail::EMPTY_VERTEX_DATA) * m_vertCapacity;
+		bdc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		bdc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+		Cass::ThrowIfFailed(m_device->CreateBuffer(&bdc, nullptr, m_vertexBuffer.ReleaseAndGetAddressOf()));
+	}
+	if (m_indexCount > m_indexCapacity) {
+		m_indexCapacity = m_indexCount + m_indexCount / 2;
+
+		D3D11_BUFFER_DESC bdc;
+		ZeroMemory(&bdc, sizeof(bdc));
+		bdc.Usage = D3D11_USAGE_DYNAMIC;
+		bdc.ByteWidth = sizeof(uint32_t) * m_indexCapacity;
+		bdc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+		bdc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+		Cass::ThrowIfFailed(m_device->CreateBuffer(&bdc, nullptr, m_indexBuffer.ReleaseAndGetAddressOf()));
+	}
+
+	for (size_t i = 0; i < m_vertCount; i++) {
+		m_vertexData[i] = { m_points[i], m_color };
+	}
+	SetBuffers();
+
+	D3D11_MAPPED_SUBRESOURCE ms;
+	Cass::ThrowIfFailed(m_deviceContext->Map(m_indexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, NULL, &ms));
+	memcpy(ms.pData, m_indices.data(), sizeof(uint32_t) * m_indexCount);
+	m_deviceContext->Unmap(m_indexBuffer.Get(), 0);
+}
+
+// ---------- class StreamingPolyline
+
+StreamingPolyline::StreamingPolyline(size_t _window, DirectX::XMFLOAT4 _color, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext, size_t _capacity) : Empty(0) {
+	if (_window < 2) throw std::invalid_argument("Window must hold at least 2 points");
+
+	m_color = _color;
+	m_window = _window;
+	m_capacity = std::max(_capacity == 0 ? 4 * _window : _capacity, _window + 1);
+	m_historyHead = m_unflushed = 0;
+	m_total = 0;
+	m_cleared = false;
+	m_gpuHead = 0;
+	m_lb = m_ub = { 0.0f, 0.0f, 0.0f };
+	m_boundsChanged = false;
+
+	m_topology = D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP;
+	m_vertexData = std::unique_ptr <detail::EMPTY_VERTEX_DATA[]>(new detail::EMPTY_VERTEX_DATA[m_window]);
+
+	m_device = _pDevice;
+	m_deviceContext = _pContext;
+
+	D3D11_BUFFER_DESC bdc;
+	ZeroMemory(&bdc, sizeof(bdc));
+	bdc.Usage = D3D11_USAGE_DYNAMIC;
+	bdc.ByteWidth = static_cast <UINT> (sizeof(detail::EMPTY_VERTEX_DATA) * m_capacity);
+	bdc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bdc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+	Cass::ThrowIfFailed(m_device->CreateBuffer(&bdc, nullptr, m_vertexBuffer.ReleaseAndGetAddressOf()));
+}
+
+void StreamingPolyline::Append(const DirectX::XMFLOAT3* _points, size_t _count) {
+	if (_points == nullptr || _count == 0) return;
+
+	std::lock_guard <std::mutex> lock(m_mutex);
+	bool first = m_total == 0;
+	m_total += _count;
+
+	// points pushed out of the window by the same call are never seen
+	if (_count > m_window) {
+		_points += _count - m_window;
+		_count = m_window;
+	}
+
+	bool wrapped = false;
+	for (size_t i = 0; i < _count; i++) {
+		m_vertexData[m_historyHead] = { _points[i], m_color };
+		m_historyHead = m_historyHead + 1 == m_window ? 0 : m_historyHead + 1;
+		wrapped = wrapped || m_historyHead == 0;
+	}
+
+	// the bounds grow with the new points, once per pass over the ring they're rebuilt to drop the points that left the window
+	if (wrapped || first) {
+		m_lb = m_ub = m_vertexData[0].position;
+		GrowBounds(0, static_cast <size_t> (std::min <uint64_t> (m_total, m_window)));
+	}
+	else {
+		GrowBounds((m_historyHead + m_window - _count) % m_window, _count);
+	}
+	m_boundsChanged = true;
+
+	m_unflushed = std::min(m_unflushed + _count, m_window);
+}
+
+uint64_t StreamingPolyline::GetTotalCount() const {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	return m_total;
+}
+
+void StreamingPolyline::Clear() {
+	std::lock_guard <std::mutex> lock(m_mutex);
+	m_historyHead = m_unflushed = 0;
+	m_total = 0;
+	m_cleared = true;
+
+	// the next Refresh publishes empty bounds instead of those of the dropped points
+	m_lb = m_ub = { 0.0f, 0.0f, 0.0f };
+	m_boundsChanged = true;
+}
+
+void StreamingPolyline::Render(const CameraFrame& _frame, Shader& _shader) {
+	Flush();
+	if (m_vertCount < 2) return;
+
+	UINT strides = sizeof(detail::EMPTY_VERTEX_DATA);
+	UINT offsets = 0;
+
+	_shader.SetActive(m_deviceContext.Get(), _frame, *this);
+
+	m_deviceContext->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &strides, &offsets);
+	m_deviceContext->IASetPrimitiveTopology(m_topology);
+	m_deviceContext->Draw(static_cast <UINT> (m_vertCount), static_cast <UINT> (m_gpuHead - m_vertCount));
+}
+
+void StreamingPolyline::Refresh() {
+	std::lock_guard <std::mutex> lock(m_mutex);
+
+	// bounds kept by Append, published here on the render thread
+	if (m_boundsChanged) {
+		SetBounds(m_lb, m_ub);
+		m_boundsChanged = false;
+	}
+}
+
+void StreamingPolyline::Flush() {
+	std::lock_guard <std::mutex> lock(m_mutex);
+
+	if (m_cleared) {
+		m_vertCount = m_gpuHead = 0;
+		m_cleared = false;
+	}
+	if (m_unflushed == 0) return;
+
+	size_t visible = static_cast <size_t> (std::min <uint64_t> (m_total, m_window));
+	detail::EMPTY_VERTEX_DATA* dest;
+	size_t first, count;
+
+	D3D11_MAPPED_SUBRESOURCE ms;
+	if (m_gpuHead > 0 && m_gpuHead + m_unflushed <= m_capacity) {
+		// the GPU may still be reading the window, the new points go after it
+		Cass::ThrowIfFailed(m_deviceContext->Map(m_vertexBuffer.Get(), 0, D3D11_MAP_WRITE_NO_OVERWRITE, NULL, &ms));
+		first = m_gpuHead;
+		count = m_unflushed;
+	}
+	else {
+		// out of room, start over in a fresh buffer with the whole window
+		Cass::ThrowIfFailed(m_deviceContext->Map(m_vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, NULL, &ms));
+		first = 0;
+		count = visible;
+	}
+
+	dest = static_cast <detail::EMPTY_VERTEX_DATA*> (ms.pData) + first;
+	CopyNewest(count, dest);
+	m_deviceContext->Unmap(m_vertexBuffer.Get(), 0);
+
+	m_gpuHead = first + count;
+	m_vertCount = visible;
+	m_unflushed = 0;
+}
+
+void StreamingPolyline::GrowBounds(size_t _first, size_t _count) {
+	for (size_t i = 0, index = _first; i < _count; i++, index = index + 1 == m_window ? 0 : index + 1) {
+		const DirectX::XMFLOAT3& position = m_vertexData[index].position;
+
+		m_lb.x = std::min(m_lb.x, position.x);
+		m_lb.y = std::min(m_lb.y, position.y);
+		m_lb.z = std::min(m_lb.z, position.z);
+
+		m_ub.x = std::max(m_ub.x, position.x);
+		m_ub.y = std::max(m_ub.y, position.y);
+		m_ub.z = std::max(m_ub.z, position.z);
+	}
+}
+
+void StreamingPolyline::CopyNewest(size_t _count, detail::EMPTY_VERTEX_DATA* _dest) const {
+	size_t start = (m_historyHead + m_window - _count) % m_window;
+	size_t head = std::min(_count, m_window - start);
+
+	memcpy(_dest, m_vertexData.get() + start, sizeof(detail::EMPTY_VERTEX_DATA) * head);
+	memcpy(_dest + head, m_vertexData.get(), sizeof(detail::EMPTY_VERTEX_DATA) * (_count - head));
+}
+
 // ---------- class Box
 
 Box::Box(DirectX::XMFLOAT3 _dims, DirectX::XMFLOAT4 _color, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext):Empty(24) {
@@ -0,0 +1,460 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Object/IsoSurface.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Cass;
+
+namespace {
+	//
+	// ---------- marching cubes case table
+	//
+
+	// corner c of a cell sits at offset (c & 1, (c >> 1) & 1, (c >> 2) & 1)
+	// edge e runs along axis e / 4 starting from corner s_edgeBase[e]
+	const uint8_t s_edgeBase[12] = { 0, 2, 4, 6, 0, 1, 4, 5, 0, 1, 2, 3 };
+	const uint8_t s_axisBit[3] = { 1, 2, 4 };
+
+	struct CaseTable {
+		// up to 5 triangles of cell edges per corner configuration, terminated by -1
+		int8_t tris[256][16];
+	};
+
+	int EdgeBetween(int _a, int _b) {
+		int diff = _a ^ _b;
+		int axis = diff == 1 ? 0 : (diff == 2 ? 1 : 2);
+		int base = _a & ~diff;
+
+		for (int e = axis * 4; e < axis * 4 + 4; e++) {
+			if (s_edgeBase[e] == base) return e;
+		}
+		return -1;
+	}
+
+	/**
+	* @brief Derive the triangle table instead of hardcoding it
+	*		 on every face the edge entering a run of inside corners is joined to the edge leaving it, the resulting segments
+	*		 chain into closed loops which are fan triangulated. Ambiguous faces always cut off inside corners individually,
+	*		 both cells sharing a face resolve it the same way and the surface stays watertight
+	*/
+	CaseTable BuildCaseTable() {
+		CaseTable table;
+
+		// faces as corner cycles, all wound the same way around their outward normal
+		int faces[6][4];
+		for (int axis = 0, f = 0; axis < 3; axis++) {
+			int u = s_axisBit[(axis + 1) % 3], v = s_axisBit[(axis + 2) % 3], a = s_axisBit[axis];
+			int cycle[4] = { 0, u, u | v, v };
+
+			for (int side = 0; side < 2; side++, f++) {
+				for (int k = 0; k < 4; k++) {
+					faces[f][k] = (side ? cycle[k] : cycle[3 - k]) | (side ? a : 0);
+				}
+			}
+		}
+
+		for (int mask = 0; mask < 256; mask++) {
+			int next[12];
+			for (int e = 0; e < 12; e++) next[e] = -1;
+
+			for (int f = 0; f < 6; f++) {
+				for (int k = 0; k < 4; k++) {
+					int c0 = faces[f][k], c1 = faces[f][(k + 1) % 4];
+					if ((mask >> c0 & 1) || !(mask >> c1 & 1)) continue;
+
+					// c1 starts a run of inside corners, walk to its end
+					int j = (k + 1) % 4;
+					while (mask >> faces[f][(j + 1) % 4] & 1) j = (j + 1) % 4;
+
+					next[EdgeBetween(c0, c1)] = EdgeBetween(faces[f][j], faces[f][(j + 1) % 4]);
+				}
+			}
+
+			int count = 0;
+			bool visited[12] = {};
+			for (int e = 0; e < 12; e++) {
+				if (next[e] < 0 || visited[e]) continue;
+
+				int loop[12], length = 0;
+				for (int x = e; !visited[x]; x = next[x]) {
+					visited[x] = true;
+					loop[length++] = x;
+				}
+
+				// winding order : CW, face normals point out of the inside region
+				for (int k = 1; k + 1 < length; k++) {
+					table.tris[mask][count++] = static_cast <int8_t> (loop[0]);
+					table.tris[mask][count++] = static_cast <int8_t> (loop[k]);
+					table.tris[mask][count++] = static_cast <int8_t> (loop[k + 1]);
+				}
+			}
+			for (; count < 16; count++) table.tris[mask][count] = -1;
+		}
+
+		return table;
+	}
+
+	const CaseTable& GetCaseTable() {
+		static const CaseTable table = BuildCaseTable();
+		return table;
+	}
+
+	//
+	// ---------- slab extraction
+	//
+
+	struct VoxelGrid {
+		uint32_t nx, ny, nz;
+		DirectX::XMFLOAT3 lb;
+		DirectX::XMFLOAT3 cell;
+	};
+
+	struct EdgeEntry {
+		uint32_t stamp;
+		uint32_t vertex;
+	};
+
+	struct Slab {
+		std::vector <detail::MESH_VERTEX_DATA> vertices;
+		std::vector <uint32_t> indices;
+
+		// (edge key, local vertex) of vertices on the first and last plane of the slab, shared with the neighbouring slabs
+		std::vector <std::pair <uint32_t, uint32_t>> bottom;
+		std::vector <std::pair <uint32_t, uint32_t>> top;
+	};
+
+	/*
+	* samples a function one plane at a time, keeping the four planes needed for central differences around a cell layer
+	*/
+	class FunctionSampler {
+	public:
+		FunctionSampler(const IsoSurface::Function& _func, const VoxelGrid& _grid) : m_func(_func), m_grid(_grid) {
+			for (int i = 0; i < 4; i++) {
+				m_planes[i].resize(static_cast <size_t> (_grid.nx) * _grid.ny);
+				m_planeZ[i] = std::numeric_limits <uint32_t>::max();
+			}
+		}
+
+		float Value(uint32_t _x, uint32_t _y, uint32_t _z) {
+			return GetPlane(_z)[static_cast <size_t> (_y) * m_grid.nx + _x];
+		}
+
+	private:
+		const float* GetPlane(uint32_t _z) {
+			std::vector <float>& plane = m_planes[_z & 3U];
+			if (m_planeZ[_z & 3U] == _z) return plane.data();
+
+			float z = m_grid.lb.z + _z * m_grid.cell.z;
+			for (uint32_t y = 0; y < m_grid.ny; y++) {
+				float fy = m_grid.lb.y + y * m_grid.cell.y;
+				for (uint32_t x = 0; x < m_grid.nx; x++) {
+					plane[static_cast <size_t> (y) * m_grid.nx + x] = m_func(m_grid.lb.x + x * m_grid.cell.x, fy, z);
+				}
+			}
+
+			m_planeZ[_z & 3U] = _z;
+			return plane.data();
+		}
+
+		const IsoSurface::Function& m_func;
+		const VoxelGrid& m_grid;
+
+		std::vector <float> m_planes[4];
+		uint32_t m_planeZ[4];
+	};
+
+	/*
+	* reads a stored volume, x varies fastest
+	*/
+	class VolumeSampler {
+	public:
+		VolumeSampler(const std::vector <float>& _samples, const VoxelGrid& _grid) : m_samples(_samples.data()), m_grid(_grid) {}
+
+		float Value(uint32_t _x, uint32_t _y, uint32_t _z) const {
+			return m_samples[(static_cast <size_t> (_z) * m_grid.ny + _y) * m_grid.nx + _x];
+		}
+
+	private:
+		const float* m_samples;
+		const VoxelGrid& m_grid;
+	};
+
+	template <class Sampler>
+	DirectX::XMVECTOR Gradient(Sampler& _sampler, const VoxelGrid& _grid, uint32_t _x, uint32_t _y, uint32_t _z) {
+		// central differences, one sided on the boundary of the volume
+		uint32_t x0 = _x > 0 ? _x - 1 : _x, x1 = _x + 1 < _grid.nx ? _x + 1 : _x;
+		uint32_t y0 = _y > 0 ? _y - 1 : _y, y1 = _y + 1 < _grid.ny ? _y + 1 : _y;
+		uint32_t z0 = _z > 0 ? _z - 1 : _z, z1 = _z + 1 < _grid.nz ? _z + 1 : _z;
+
+		return DirectX::XMVectorSet(
+			(_sampler.Value(x1, _y, _z) - _sampler.Value(x0, _y, _z)) / ((x1 - x0) * _grid.cell.x),
+			(_sampler.Value(_x, y1, _z) - _sampler.Value(_x, y0, _z)) / ((y1 - y0) * _grid.cell.y),
+			(_sampler.Value(_x, _y, z1) - _sampler.Value(_x, _y, z0)) / ((z1 - z0) * _grid.cell.z),
+			0.0f
+		);
+	}
+
+	/**
+	* @brief Triangulate cell layers [_z0, _z1) into _slab
+	*		 vertices are shared through per plane edge caches, entries are stamped with their plane so the caches never need clearing
+	*
+	* @param _forEachCell	called with a layer index and a callback taking (x, y, z) for every cell of that layer worth visiting
+	*/
+	template <class Sampler, class CellVisitor>
+	void PolygonizeSlab(Sampler& _sampler, const VoxelGrid& _grid, float _iso, uint32_t _z0, uint32_t _z1, CellVisitor&& _forEachCell, Slab& _slab) {
+		const CaseTable& table = GetCaseTable();
+		size_t planeSize = static_cast <size_t> (_grid.nx) * _grid.ny;
+
+		std::vector <EdgeEntry> planeEdges[2] = {
+			std::vector <EdgeEntry>(planeSize * 2, EdgeEntry { 0, 0 }),
+			std::vector <EdgeEntry>(planeSize * 2, EdgeEntry { 0, 0 })
+		};
+		std::vector <EdgeEntry> zEdges(planeSize, EdgeEntry { 0, 0 });
+
+		auto vertexOnEdge = [&](uint32_t _x, uint32_t _y, uint32_t _z, uint32_t _axis) -> uint32_t {
+			uint32_t key = static_cast <uint32_t> (static_cast <size_t> (_y) * _grid.nx + _x);
+			EdgeEntry& entry = _axis == 2 ? zEdges[key] : planeEdges[_z & 1U][key * 2U + _axis];
+			if (entry.stamp == _z + 1U) return entry.vertex;
+
+			uint32_t x1 = _x + (_axis == 0), y1 = _y + (_axis == 1), z1 = _z + (_axis == 2);
+			float v0 = _sampler.Value(_x, _y, _z), v1 = _sampler.Value(x1, y1, z1);
+			float t = v1 != v0 ? (_iso - v0) / (v1 - v0) : 0.5f;
+
+			DirectX::XMFLOAT3 p = { _x + t * (x1 - _x), _y + t * (y1 - _y), _z + t * (z1 - _z) };
+			detail::MESH_VERTEX_DATA vertex;
+			vertex.position = { _grid.lb.x + p.x * _grid.cell.x, _grid.lb.y + p.y * _grid.cell.y, _grid.lb.z + p.z * _grid.cell.z };
+			vertex.uv = { p.x / (_grid.nx - 1U), p.y / (_grid.ny - 1U) };
+			DirectX::XMStoreFloat3(
+				&vertex.normal,
+				DirectX::XMVector3Normalize(DirectX::XMVectorLerp(
+					Gradient(_sampler, _grid, _x, _y, _z),
+					Gradient(_sampler, _grid, x1, y1, z1),
+					t
+				))
+			);
+
+			entry.stamp = _z + 1U;
+			entry.vertex = static_cast <uint32_t> (_slab.vertices.size());
+			if (_axis != 2 && _z == _z0) _slab.bottom.push_back({ key * 2U + _axis, entry.vertex });
+			if (_axis != 2 && _z == _z1) _slab.top.push_back({ key * 2U + _axis, entry.vertex });
+
+			_slab.vertices.push_back(vertex);
+			return entry.vertex;
+		};
+
+		auto processCell = [&](uint32_t _x, uint32_t _y, uint32_t _z) {
+			uint32_t mask = 0;
+			for (uint32_t c = 0; c < 8; c++) {
+				if (_sampler.Value(_x + (c & 1U), _y + (c >> 1 & 1U), _z + (c >> 2 & 1U)) < _iso) mask |= 1U << c;
+			}
+
+			for (const int8_t* edge = table.tris[mask]; *edge >= 0; edge++) {
+				uint32_t base = s_edgeBase[*edge];
+				_slab.indices.push_back(vertexOnEdge(_x + (base & 1U), _y + (base >> 1 & 1U), _z + (base >> 2 & 1U), *edge / 4U));
+			}
+		};
+
+		for (uint32_t z = _z0; z < _z1; z++) {
+			_forEachCell(z, processCell);
+		}
+	}
+
+	/**
+	* @brief Merge the slabs into a single indexed mesh, vertices on a plane shared by two slabs are kept once
+	*/
+	void StitchSlabs(
+		std::vector <Slab>& _slabs,
+		std::unique_ptr <detail::MESH_VERTEX_DATA[]>& _vertexData, std::unique_ptr <uint32_t[]>& _indices,
+		size_t& _vertCount, size_t& _polyCount) {
+
+		std::vector <std::vector <uint32_t>> remap(_slabs.size());
+		std::vector <size_t> vertexOffset(_slabs.size()), indexOffset(_slabs.size());
+
+		_vertCount = 0;
+		size_t indexCount = 0;
+		for (size_t s = 0; s < _slabs.size(); s++) {
+			Slab& slab = _slabs[s];
+			remap[s].assign(slab.vertices.size(), std::numeric_limits <uint32_t>::max());
+
+			if (s > 0) {
+				Slab& prev = _slabs[s - 1];
+				std::sort(slab.bottom.begin(), slab.bottom.end());
+				std::sort(prev.top.begin(), prev.top.end());
+
+				for (size_t i = 0, j = 0; i < slab.bottom.size() && j < prev.top.size(); ) {
+					if (slab.bottom[i].first < prev.top[j].first) i++;
+					else if (prev.top[j].first < slab.bottom[i].first) j++;
+					else remap[s][slab.bottom[i++].second] = remap[s - 1][prev.top[j++].second];
+				}
+			}
+
+			vertexOffset[s] = _vertCount;
+			indexOffset[s] = indexCount;
+			for (uint32_t& index : remap[s]) {
+				if (index == std::numeric_limits <uint32_t>::max()) index = static_cast <uint32_t> (_vertCount++);
+			}
+			indexCount += slab.indices.size();
+		}
+
+		_polyCount = indexCount / 3;
+		_vertexData = std::unique_ptr <detail::MESH_VERTEX_DATA[]>(new detail::MESH_VERTEX_DATA[std::max(_vertCount, static_cast <size_t> (1))]);
+		_indices = std::unique_ptr <uint32_t[]>(new uint32_t[std::max(indexCount, static_cast <size_t> (1))]);
+
+		ParallelFor(0, _slabs.size(), [&](size_t _begin, size_t _end) {
+			for (size_t s = _begin; s < _end; s++) {
+				const Slab& slab = _slabs[s];
+
+				for (size_t i = 0; i < slab.vertices.size(); i++) {
+					if (remap[s][i] >= vertexOffset[s]) _vertexData[remap[s][i]] = slab.vertices[i];
+				}
+				for (size_t i = 0; i < slab.indices.size(); i++) {
+					_indices[indexOffset[s] + i] = remap[s][slab.indices[i]];
+				}
+			}
+		});
+	}
+}
+
+//
+// ---------- class IsoSurface
+//
+
+IsoSurface::IsoSurface(
+	Function _func, DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, DirectX::XMUINT3 _res, float _isoValue,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) : Mesh(0, 0, SHADING::SMOOTH, _pDevice, _pContext) {
+
+	m_func = _func;
+	m_lb = _lb;
+	m_ub = _ub;
+	m_res = { std::max(_res.x, 2U), std::max(_res.y, 2U), std::max(_res.z, 2U) };
+	m_isoValue = _isoValue;
+	m_extractionTime = 0.0;
+	m_vertCapacity = m_polyCapacity = 0;
+
+	if (!m_func) return;
+
+	InitVertices();
+}
+
+IsoSurface::IsoSurface(
+	std::vector <float> _samples, DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, DirectX::XMUINT3 _res, float _isoValue,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) : Mesh(0, 0, SHADING::SMOOTH, _pDevice, _pContext) {
+
+	// unlike sampling a function the resolution can't be clamped, it has to describe the samples given
+	if (_res.x < 2 || _res.y < 2 || _res.z < 2) {
+		throw std::invalid_argument("Volume needs at least 2 samples along each axis");
+	}
+	if (static_cast <size_t> (_res.x) * _res.y > SIZE_MAX / _res.z) {
+		throw std::invalid_argument("Volume resolution too large");
+	}
+	if (_samples.size() != static_cast <size_t> (_res.x) * _res.y * _res.z) {
+		throw std::invalid_argument("Sample count doesn't match the volume resolution");
+	}
+
+	m_samples = std::move(_samples);
+	m_octree = std::make_unique <MinMaxOctree> (m_samples.data(), _res);
+	m_lb = _lb;
+	m_ub = _ub;
+	m_res = _res;
+	m_isoValue = _isoValue;
+	m_extractionTime = 0.0;
+	m_vertCapacity = m_polyCapacity = 0;
+
+	InitVertices();
+}
+
+void IsoSurface::SetIsoValue(float _isoValue) {
+	m_isoValue = _isoValue;
+	if (m_func || m_octree) InitVertices();
+}
+
+void IsoSurface::InitVertices() {
+	auto start = std::chrono::high_resolution_clock::now();
+
+	VoxelGrid grid;
+	grid.nx = m_res.x;
+	grid.ny = m_res.y;
+	grid.nz = m_res.z;
+	grid.lb = m_lb;
+	grid.cell = { (m_ub.x - m_lb.x) / (m_res.x - 1U), (m_ub.y - m_lb.y) / (m_res.y - 1U), (m_ub.z - m_lb.z) / (m_res.z - 1U) };
+
+	// split the cell layers into one slab per worker
+	uint32_t layers = grid.nz - 1U;
+	uint32_t slabCount = std::min(layers, std::max(1U, std::thread::hardware_concurrency()));
+	std::vector <Slab> slabs(slabCount);
+
+	ParallelFor(0, slabCount, [&](size_t _begin, size_t _end) {
+		for (size_t s = _begin; s < _end; s++) {
+			uint32_t z0 = static_cast <uint32_t> (layers * s / slabCount);
+			uint32_t z1 = static_cast <uint32_t> (layers * (s + 1) / slabCount);
+
+			if (!m_octree) {
+				FunctionSampler sampler(m_func, grid);
+				PolygonizeSlab(sampler, grid, m_isoValue, z0, z1, [&grid](uint32_t _z, auto&& _processCell) {
+					for (uint32_t y = 0; y + 1U < grid.ny; y++) {
+						for (uint32_t x = 0; x + 1U < grid.nx; x++) _processCell(x, y, _z);
+					}
+				}, slabs[s]);
+				continue;
+			}
+
+			// only visit the bricks crossed by the iso value, grouped by brick layer
+			uint32_t brickSize = m_octree->GetBrickSize();
+			uint32_t firstLayer = z0 / brickSize;
+
+			std::vector <DirectX::XMUINT3> bricks;
+			m_octree->Query(m_isoValue, z0, z1, bricks);
+
+			std::vector <std::vector <DirectX::XMUINT3>> brickLayers((z1 - 1U) / brickSize - firstLayer + 1U);
+			for (const DirectX::XMUINT3& brick : bricks) brickLayers[brick.z - firstLayer].push_back(brick);
+
+			VolumeSampler sampler(m_samples, grid);
+			PolygonizeSlab(sampler, grid, m_isoValue, z0, z1, [&](uint32_t _z, auto&& _processCell) {
+				for (const DirectX::XMUINT3& brick : brickLayers[_z / brickSize - firstLayer]) {
+					uint32_t y1 = std::min((brick.y + 1U) * brickSize, grid.ny - 1U);
+					uint32_t x1 = std::min((brick.x + 1U) * brickSize, grid.nx - 1U);
+
+					for (uint32_t y = brick.y * brickSize; y < y1; y++) {
+						for (uint32_t x = brick.x * brickSize; x < x1; x++) _processCell(x, y, _z);
+					}
+				}
+			}, slabs[s]);
+		}
+	});
+
+	StitchSlabs(slabs, m_vertexData, m_indices, m_vertCount, m_polyCount);
+
+	m_extractionTime = std::chrono::duration <double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	UploadSurface();
+}
+
+void IsoSurface::UploadSurface() {
+	if (m_vertCount < 3 || m_polyCount < 1) return;
+
+	if (m_vertCount > m_vertCapacity || m_polyCount > m_polyCapacity) {
+		// leave some headroom so that small changes of the iso value don't reallocate every time
+		size_t vertCount = m_vertCount, polyCount = m_polyCount;
+		m_vertCount = m_vertCapacity = std::max(vertCount + vertCount / 4, m_vertCapacity);
+		m_polyCount = m_polyCapacity = std::max(polyCount + polyCount / 4, m_polyCapacity);
+
+		CreateBuffers();
+
+		m_vertCount = vertCount;
+		m_polyCount = polyCount;
+	}
+
+	SetBuffers();
+}
@@ -12,6 +12,7 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <limits>
@@ -31,6 +32,9 @@ Mesh::Mesh(size_t _vertCount, size_t _polyCount, SHADING _shading, ID3D11Device*
 	m_vertCount	= m_shadingMode == SHADING::SMOOTH ? _vertCount : m_polyCount * 3;
 	m_device = _pDevice;
 	m_deviceContext = _pContext;
+	m_deformed = false;
+	m_boundsVersion = 0;
+	m_bvhStale = false;
 
 	if (!s_defShader) {
 		s_defShader = std::make_unique<FlatShader>();
@@ -40,14 +44,14 @@ Mesh::Mesh(size_t _vertCount, size_t _polyCount, SHADING _shading, ID3D11Device*
 
 Mesh::~Mesh() {}
 
-void Mesh::Render(Camera& _camera, Cass::Shader& _shader) {
+void Mesh::Render(const CameraFrame& _frame, Cass::Shader& _shader) {
 	if (m_vertCount < 3 || m_polyCount < 1) return;
 	if (m_vBuffer.Get() == nullptr || m_iBuffer.Get() == nullptr) return;
 
 	UINT strides = sizeof(detail::MESH_VERTEX_DATA);
 	UINT offsets = 0;
 
-	_shader.SetActive(m_deviceContext.Get(), _camera, m_transformation);
+	_shader.SetActive(m_deviceContext.Get(), _frame, *this);
 
 	m_deviceContext->IASetVertexBuffers(0, 1, m_vBuffer.GetAddressOf(), &strides, &offsets);
 	m_deviceContext->IASetIndexBuffer(m_iBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
@@ -55,9 +59,8 @@ void Mesh::Render(Camera& _camera, Cass::Shader& _shader) {
 	m_deviceContext->DrawIndexed(m_polyCount * 3, 0, 0);
 	
 	if (m_boundsMesh) {
-		m_boundsMesh->ResetTransform();
-		m_boundsMesh->Translate(Math::XMFloat3Add(m_bounds.GetPosition(), GetPosition()));
-		m_boundsMesh->Render(_camera, *s_defShader.get());
+		if (m_boundsVersion != GetVersion()) PlaceBoundsMesh();
+		m_boundsMesh->Render(_frame, *s_defShader.get());
 	}
 }
 
@@ -94,17 +97,23 @@ void Mesh::SetShading(DirectX::XMFLOAT3* _pFaceNormals) {
 }
 
 void Mesh::SetBuffers() {
-	// copy vertex data into vertex buffer
-	D3D11_MAPPED_SUBRESOURCE ms;
-	ThrowIfFailed(m_deviceContext->Map(m_vBuffer.Get(), NULL, D3D11_MAP_WRITE_DISCARD, NULL, &ms));
-	memcpy(ms.pData, m_vertexData.get(), sizeof(detail::MESH_VERTEX_DATA) * m_vertCount);
-	m_deviceContext->Unmap(m_vBuffer.Get(), NULL);
+	// new indices, the hierarchy is rebuilt on the next query
+	m_bvh.reset();
+	SetVertexBuffer();
 
 	// copy index data into index buffer
-	ZeroMemory(&ms, sizeof(ms));
+	D3D11_MAPPED_SUBRESOURCE ms;
 	ThrowIfFailed(m_deviceContext->Map(m_iBuffer.Get(), NULL, D3D11_MAP_WRITE_DISCARD, NULL, &ms));
 	memcpy(ms.pData, m_indices.get(), sizeof(uint32_t) * m_polyCount * 3);
 	m_deviceContext->Unmap(m_iBuffer.Get(), NULL);
+}
+
+void Mesh::SetVertexBuffer() {
+	// copy vertex data into vertex buffer
+	D3D11_MAPPED_SUBRESOURCE ms;
+	ThrowIfFailed(m_deviceContext->Map(m_vBuffer.Get(), NULL, D3D11_MAP_WRITE_DISCARD, NULL, &ms));
+	memcpy(ms.pData, m_vertexData.get(), sizeof(detail::MESH_VERTEX_DATA) * m_vertCount);
+	m_deviceContext->Unmap(m_vBuffer.Get(), NULL);
 
 	// update bounding box
 	static float fMax = std::numeric_limits <float>::max();
@@ -120,8 +129,8 @@ void Mesh::SetBuffers() {
 		ub.y = std::max(ub.y, m_vertexData[i].position.y);
 		ub.z = std::max(ub.z, m_vertexData[i].position.z);
 	}
-	m_bounds.Calculate(lb, ub);
-	if (m_boundsMesh) m_boundsMesh->Recompute(m_bounds.GetDimensions());
+	SetBounds(lb, ub);
+	m_bvhStale = true;
 }
 
 void Mesh::CreateBuffers() {
@@ -153,6 +162,13 @@ void Mesh::CreateBuffers() {
 void Mesh::CalculateNormalsFromFace() {
 	if (m_polyCount < 1) return;
 
+	RecomputeNormals();
+	SetBuffers();
+}
+
+void Mesh::RecomputeNormals() {
+	if (m_polyCount < 1) return;
+
 	std::unique_ptr <DirectX::XMFLOAT3[]> faceNorm(new DirectX::XMFLOAT3[m_polyCount]);
 	for (size_t i = 0; i < m_polyCount * 3; i += 3) {
 		DirectX::XMFLOAT3 a, b;
@@ -170,7 +186,6 @@ void Mesh::CalculateNormalsFromFace() {
 	}
 
 	SetShading(faceNorm.get());
-	SetBuffers();
 }
 
 void Mesh::GetPositions(std::vector <DirectX::XMFLOAT3> &_oPos) const {
@@ -206,21 +221,97 @@ void Mesh::SetPositions(const std::vector<DirectX::XMFLOAT3>& _position) {
 	for (int i = 0; i < m_vertCount; i++) {
 		m_vertexData[i].position = _position[i];
 	}
+	m_deformed = true;
 
-	SetBuffers();
-	CalculateNormalsFromFace();
+	// the indices don't change, a single vertex upload covers positions and normals
+	RecomputeNormals();
+	SetVertexBuffer();
 }
 
 void Mesh::ShowBounds(bool _toggle) {
 	if (_toggle) {
 		if (m_boundsMesh != nullptr) return;
 		m_boundsMesh = std::make_unique<Box>(m_bounds.GetDimensions(), DirectX::XMFLOAT4 { 1.0f, 0.5f, 0.25f, 1.0f }, m_device.Get(), m_deviceContext.Get());
+		PlaceBoundsMesh();
 	}
 	else {
 		m_boundsMesh.reset();
 	}
 }
 
+void Mesh::PlaceBoundsMesh() {
+	DirectX::XMFLOAT3 lb, ub;
+	GetWorldBounds(lb, ub);
+
+	m_boundsMesh->Recompute({ ub.x - lb.x, ub.y - lb.y, ub.z - lb.z });
+	m_boundsMesh->ResetTransform();
+	m_boundsMesh->Translate({ 0.5f * (lb.x + ub.x), 0.5f * (lb.y + ub.y), 0.5f * (lb.z + ub.z) });
+	m_boundsVersion = GetVersion();
+}
+
+bool Mesh::Intersect(const Ray& _ray, float& _oDistance) const {
+	if (!m_vertexData || !m_indices) return false;
+
+	Ray local = ToLocal(_ray);
+	float t;
+	uint32_t triangle;
+	if (!GetBvh().Intersect(local, GetGeometry(), t, triangle)) return false;
+
+	_oDistance = ToWorldDistance(_ray, local, t);
+	return true;
+}
+
+const TriangleBvh& Mesh::GetBvh() const {
+	if (!m_bvh) {
+		m_bvh = std::make_unique <TriangleBvh>(GetGeometry());
+		m_bvhStale = false;
+	}
+	else if (m_bvhStale) {
+		m_bvh->Refit(GetGeometry());
+		m_bvhStale = false;
+	}
+
+	return *m_bvh;
+}
+
+TriangleBvh::Geometry Mesh::GetGeometry() const {
+	if (!m_vertexData || !m_indices) return { nullptr, 0, nullptr, 0 };
+
+	return { &m_vertexData[0].position, sizeof(detail::MESH_VERTEX_DATA), m_indices.get(), m_polyCount };
+}
+
+size_t Mesh::GetByteSize() const {
+	size_t size = 0;
+	for (ID3D11Buffer* buffer : { m_vBuffer.Get(), m_iBuffer.Get() }) {
+		if (!buffer) continue;
+
+		D3D11_BUFFER_DESC desc;
+		buffer->GetDesc(&desc);
+		size += desc.ByteWidth;
+	}
+
+	return size;
+}
+
+Ray Mesh::ToLocal(const Ray& _ray) const {
+	DirectX::XMMATRIX inverse = GetInverseTransformation();
+	DirectX::XMFLOAT3 origin = _ray.GetOrigin(), dir = _ray.GetDirection();
+
+	DirectX::XMStoreFloat3(&origin, DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&origin), inverse));
+	DirectX::XMStoreFloat3(&dir, DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&dir), inverse));
+
+	return Ray(origin, dir);
+}
+
+float Mesh::ToWorldDistance(const Ray& _ray, const Ray& _local, float _distance) const {
+	// the local direction is renormalized, so distances only agree without scaling
+	DirectX::XMFLOAT3 origin = _local.GetOrigin(), dir = _local.GetDirection(), worldOrigin = _ray.GetOrigin();
+	DirectX::XMVECTOR hit = DirectX::XMVectorMultiplyAdd(DirectX::XMLoadFloat3(&dir), DirectX::XMVectorReplicate(_distance), DirectX::XMLoadFloat3(&origin));
+
+	hit = DirectX::XMVector3TransformCoord(hit, GetTransformation());
+	return DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVectorSubtract(hit, DirectX::XMLoadFloat3(&worldOrigin))));
+}
+
 // static methods
 
 void Mesh::SetSplitNormals(_In_ size_t polyCount, _In_ uint32_t* indices, _In_ DirectX::XMFLOAT3* faceNormals, _Out_ std::unique_ptr <DirectX::XMFLOAT3[]>& normals) {
@@ -282,18 +373,21 @@ void RegularPolygon::InitVertices() {
 	m_vertexData = std::unique_ptr <detail::MESH_VERTEX_DATA[]> (new detail::MESH_VERTEX_DATA[m_vertCount]);
 	m_indices = std::unique_ptr <uint32_t[]> (new uint32_t[m_polyCount * 3]);
 
-	float theta = 2.0f * Math::PI;
 	float offset = 2.0f * Math::PI / m_degree;
 
 	m_vertexData[0].position = { 0.0f, 0.0f, 0.0f };
 	m_vertexData[0].uv = { 0.5f, 0.5f };
 
+	std::vector <float> theta(m_vertCount - 1), sinTheta(m_vertCount - 1), cosTheta(m_vertCount - 1);
+	for (size_t i = 0; i < theta.size(); i++) {
+		theta[i] = 2.0f * Math::PI - offset * i;
+	}
+	Math::SinCos(theta.data(), sinTheta.data(), cosTheta.data(), theta.size());
+
 	// winding order : CW
 	for (UINT i = 1; i < m_vertCount; i++) {
-		m_vertexData[i].position = { m_radius * cos(theta), m_radius * sin(theta), 0.0f };
-		m_vertexData[i].uv = { 0.5f * (cos(theta) + 1.0f), 0.5f * (sin(theta) + 1.0f) };
-
-		theta -= offset;
+		m_vertexData[i].position = { m_radius * cosTheta[i - 1], m_radius * sinTheta[i - 1], 0.0f };
+		m_vertexData[i].uv = { 0.5f * (cosTheta[i - 1] + 1.0f), 0.5f * (sinTheta[i - 1] + 1.0f) };
 	}
 
 	size_t p = 1;
@@ -313,6 +407,29 @@ void RegularPolygon::InitVertices() {
 	SetBuffers();
 }
 
+bool RegularPolygon::Intersect(const Ray& _ray, float& _oDistance) const {
+	if (m_deformed) return Mesh::Intersect(_ray, _oDistance);
+	if (m_degree < 3) return false;
+
+	Ray local = ToLocal(_ray);
+	float t;
+	if (!local.IntersectPlane({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, t)) return false;
+
+	DirectX::XMFLOAT3 origin = local.GetOrigin(), dir = local.GetDirection();
+	float x = origin.x + dir.x * t, y = origin.y + dir.y * t;
+
+	// the edge facing the hit is the one of its angular sector, inside if not past the apothem along that edge's normal
+	float sector = Math::PIx2 / m_degree;
+	float angle = std::atan2(y, x);
+	if (angle < 0.0f) angle += Math::PIx2;
+
+	float normalAngle = (std::floor(angle / sector) + 0.5f) * sector;
+	if (std::sqrt(x * x + y * y) * std::cos(angle - normalAngle) > m_radius * std::cos(0.5f * sector)) return false;
+
+	_oDistance = ToWorldDistance(_ray, local, t);
+	return true;
+}
+
 //
 // ---------- class Cuboid
 //
@@ -408,6 +525,21 @@ void Cuboid::InitVertices() {
 	SetBuffers();
 }
 
+bool Cuboid::Intersect(const Ray& _ray, float& _oDistance) const {
+	if (m_deformed) return Mesh::Intersect(_ray, _oDistance);
+
+	Ray local = ToLocal(_ray);
+	float tNear, tFar;
+	if (!local.IntersectBox(
+		{ -m_width * 0.5f, -m_height * 0.5f, -m_depth * 0.5f },
+		{ m_width * 0.5f, m_height * 0.5f, m_depth * 0.5f },
+		tNear, tFar)) return false;
+
+	// from inside the faces are hit on the way out
+	_oDistance = ToWorldDistance(_ray, local, tNear >= 0.0f ? tNear : tFar);
+	return true;
+}
+
 //
 // ---------- class Sphere
 //
@@ -433,29 +565,33 @@ void Sphere::InitVertices() {
 	m_vertexData = std::unique_ptr <detail::MESH_VERTEX_DATA[]> (new detail::MESH_VERTEX_DATA[m_vertCount]);
 	m_indices = std::unique_ptr <uint32_t[]> (new uint32_t[m_polyCount * 3]);
 
-	float theta = Math::PI, phi;
 	float incrY = -Math::PI / m_resY, incrX = -Math::PIx2 / m_resX;
 
 	m_vertexData[0].position = { 0.0f, 0.0f, -m_radius };
 	m_vertexData[0].normal = { 0.0f, 0.0f, -1.0f };
-	theta += incrY;
+
+	// the rings and meridians share their angles, so only resX + resY - 1 sines and cosines are needed
+	std::vector <float> theta(m_resY - 1U), sinTheta(m_resY - 1U), cosTheta(m_resY - 1U);
+	std::vector <float> phi(m_resX), sinPhi(m_resX), cosPhi(m_resX);
+	for (size_t i = 0; i < theta.size(); i++) theta[i] = Math::PI + incrY * (i + 1);
+	for (size_t j = 0; j < phi.size(); j++) phi[j] = Math::PIx2 + incrX * j;
+
+	Math::SinCos(theta.data(), sinTheta.data(), cosTheta.data(), theta.size());
+	Math::SinCos(phi.data(), sinPhi.data(), cosPhi.data(), phi.size());
 
 	// generate vertices
 
 	int index = 1;
 	for (size_t i = 0; i < m_resY - 1U; i++) {
-		phi = Math::PIx2;
 		for (size_t j = 0; j < m_resX; j++) {
 			m_vertexData[index].position = {
-				m_radius * sin(theta) * cos(phi),
-				m_radius * sin(theta) * sin(phi),
-				m_radius * cos(theta)
+				m_radius * sinTheta[i] * cosPhi[j],
+				m_radius * sinTheta[i] * sinPhi[j],
+				m_radius * cosTheta[i]
 			};
 
-			phi += incrX;
 			index += 1;
 		}
-		theta += incrY;
 	}
 
 	m_vertexData[index].position = DirectX::XMFLOAT3 { 0.0f, 0.0f, m_radius };
@@ -520,10 +656,20 @@ void Sphere::InitVertices() {
 		);
 	}
 
+	// uv from longitude and latitude, the latitude uses the unit direction so any radius stays within asin's domain
+	std::vector <float> x(m_vertCount), y(m_vertCount), z(m_vertCount);
+	for (size_t i = 0; i < m_vertCount; i++) {
+		x[i] = m_vertexData[i].position.x;
+		y[i] = m_vertexData[i].position.y;
+		z[i] = std::clamp(m_vertexData[i].position.z / m_radius, -1.0f, 1.0f);
+	}
+	Math::ATan2(y.data(), x.data(), x.data(), m_vertCount);
+	Math::ASin(z.data(), z.data(), m_vertCount);
+
 	for (size_t i = 0; i < m_vertCount; i++) {
 		m_vertexData[i].uv = {
-			0.5f + atan2(m_vertexData[i].position.y, m_vertexData[i].position.x) / Math::PIx2,
-			0.5f + asin(m_vertexData[i].position.z) / Math::PI
+			0.5f + x[i] / Math::PIx2,
+			0.5f + z[i] / Math::PI
 		};
 	}
 
@@ -531,6 +677,17 @@ void Sphere::InitVertices() {
 	SetBuffers();
 }
 
+bool Sphere::Intersect(const Ray& _ray, float& _oDistance) const {
+	if (m_deformed) return Mesh::Intersect(_ray, _oDistance);
+
+	Ray local = ToLocal(_ray);
+	float t;
+	if (!local.IntersectSphere({ 0.0f, 0.0f, 0.0f }, m_radius, t)) return false;
+
+	_oDistance = ToWorldDistance(_ray, local, t);
+	return true;
+}
+
 //
 // ---------- class Plane
 //
@@ -603,6 +760,217 @@ void Plane::InitVertices() {
 	SetBuffers();
 }
 
+DirectX::XMFLOAT3 Plane::HeightNormal(const float* _heights, size_t _width, size_t _height, size_t _i, size_t _j, float _offsetX, float _offsetY) {
+	size_t i0 = _i > 0 ? _i - 1 : _i, i1 = _i + 1 < _height ? _i + 1 : _i;
+	size_t j0 = _j > 0 ? _j - 1 : _j, j1 = _j + 1 < _width ? _j + 1 : _j;
+
+	// rows run towards -y, normals face -z like the flat plane
+	float dx = (_heights[_i * _width + j1] - _heights[_i * _width + j0]) / ((j1 - j0) * _offsetX);
+	float dy = (_heights[i0 * _width + _j] - _heights[i1 * _width + _j]) / ((i1 - i0) * _offsetY);
+
+	DirectX::XMFLOAT3 normal = { dx, dy, -1.0f };
+	DirectX::XMStoreFloat3(&normal, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&normal)));
+	return normal;
+}
+
+void Plane::SetHeights(const std::vector <float>& _heights) {
+	size_t width = static_cast <size_t> (m_resX) + 2U, height = static_cast <size_t> (m_resY) + 2U;
+	if (!m_vertexData || !m_deviceContext || _heights.size() != width * height) return;
+
+	m_deformed = std::any_of(_heights.begin(), _heights.end(), [](float _h) { return _h != 0.0f; });
+
+	float offsetX = m_width / (m_resX + 1), offsetY = m_length / (m_resY + 1);
+
+	if (m_shadingMode == SHADING::SMOOTH) {
+		for (size_t i = 0; i < height; i++) {
+			for (size_t j = 0; j < width; j++) {
+				size_t index = i * width + j;
+
+				m_vertexData[index].position.z = _heights[index];
+				m_vertexData[index].normal = HeightNormal(_heights.data(), width, height, i, j, offsetX, offsetY);
+			}
+		}
+	}
+	else {
+		// flat shaded vertices are unshared, recover their grid position from x and y
+		for (size_t i = 0; i < m_vertCount; i++) {
+			DirectX::XMFLOAT3& position = m_vertexData[i].position;
+			size_t row = static_cast <size_t> (std::lround((m_length / 2 - position.y) / offsetY));
+			size_t column = static_cast <size_t> (std::lround((position.x + m_width / 2) / offsetX));
+
+			position.z = _heights[std::min(row, height - 1U) * width + std::min(column, width - 1U)];
+		}
+		for (size_t i = 0; i + 2 < m_vertCount; i += 3) {
+			DirectX::XMVECTOR a = DirectX::XMLoadFloat3(&m_vertexData[i].position);
+			DirectX::XMVECTOR normal = DirectX::XMVector3Normalize(DirectX::XMVector3Cross(
+				DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&m_vertexData[i + 1].position), a),
+				DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&m_vertexData[i + 2].position), a)
+			));
+
+			for (size_t k = 0; k < 3; k++) DirectX::XMStoreFloat3(&m_vertexData[i + k].normal, normal);
+		}
+	}
+
+	SetVertexBuffer();
+}
+
+bool Plane::Intersect(const Ray& _ray, float& _oDistance) const {
+	if (m_deformed) return Mesh::Intersect(_ray, _oDistance);
+
+	Ray local = ToLocal(_ray);
+	float t;
+	if (!local.IntersectPlane({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, t)) return false;
+
+	DirectX::XMFLOAT3 origin = local.GetOrigin(), dir = local.GetDirection();
+	float x = origin.x + dir.x * t, y = origin.y + dir.y * t;
+	if (std::abs(x) > m_width * 0.5f || std::abs(y) > m_length * 0.5f) return false;
+
+	_oDistance = ToWorldDistance(_ray, local, t);
+	return true;
+}
+
+//
+// ---------- class ParametricSurface
+//
+
+ParametricSurface::ParametricSurface(
+	Function _func,
+	DirectX::XMFLOAT2 _rangeU, DirectX::XMFLOAT2 _rangeV,
+	uint32_t _resU, uint32_t _resV,
+	WRAP _wrapU, WRAP _wrapV,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext,
+	SHADING _shading
+) : Mesh(
+		static_cast <size_t> (std::max(_resU, 2U)) * std::max(_resV, 2U),
+		2U * QuadCount(std::max(_resU, 2U), _wrapU) * QuadCount(std::max(_resV, 2U), _wrapV),
+		_shading, _pDevice, _pContext
+	) {
+
+	m_func = _func;
+	m_rangeU = _rangeU;
+	m_rangeV = _rangeV;
+	m_resU = std::max(_resU, 2U);
+	m_resV = std::max(_resV, 2U);
+	m_wrapU = _wrapU;
+	m_wrapV = _wrapV;
+	m_collapsedU[0] = m_collapsedU[1] = false;
+	m_collapsedV[0] = m_collapsedV[1] = false;
+
+	if (!m_func) return;
+
+	CreateBuffers();
+	InitVertices();
+}
+
+ParametricSurface::Function ParametricSurface::Polar(std::function <float(float, float)> _radius) {
+	return [_radius](float _theta, float _phi) {
+		float r = _radius(_theta, _phi);
+		return DirectX::XMFLOAT3 { r * std::sin(_theta) * std::cos(_phi), r * std::sin(_theta) * std::sin(_phi), r * std::cos(_theta) };
+	};
+}
+
+uint32_t ParametricSurface::SampleIndex(uint32_t _i, uint32_t _j) const {
+	// wrap around the seams, twisted seams mirror the other parameter
+	if (_i >= m_resU) {
+		_i -= m_resU;
+		if (m_wrapU == WRAP::TWISTED) _j = (m_wrapV == WRAP::NONE) ? m_resV - 1U - _j : (m_resV - _j) % m_resV;
+	}
+	if (_j >= m_resV) {
+		_j -= m_resV;
+		if (m_wrapV == WRAP::TWISTED) _i = (m_wrapU == WRAP::NONE) ? m_resU - 1U - _i : (m_resU - _i) % m_resU;
+	}
+
+	// weld degenerate boundaries onto their first sample
+	if ((_j == 0 && m_collapsedV[0]) || (_j == m_resV - 1U && m_collapsedV[1])) _i = 0;
+	if ((_i == 0 && m_collapsedU[0]) || (_i == m_resU - 1U && m_collapsedU[1])) _j = 0;
+
+	return _j * m_resU + _i;
+}
+
+void ParametricSurface::InitVertices() {
+	m_vertexData = std::unique_ptr <detail::MESH_VERTEX_DATA[]>(new detail::MESH_VERTEX_DATA[m_vertCount]);
+	m_indices = std::unique_ptr <uint32_t[]>(new uint32_t[m_polyCount * 3]);
+
+	size_t quadsU = QuadCount(m_resU, m_wrapU), quadsV = QuadCount(m_resV, m_wrapV);
+	float stepU = (m_rangeU.y - m_rangeU.x) / quadsU;
+	float stepV = (m_rangeV.y - m_rangeV.x) / quadsV;
+
+	// vertex data, rows are evaluated concurrently so the function must be safe to call from multiple threads
+
+	ParallelFor(0, m_resV, [&](size_t _begin, size_t _end) {
+		for (size_t j = _begin; j < _end; j++) {
+			float v = m_rangeV.x + stepV * j;
+
+			for (size_t i = 0; i < m_resU; i++) {
+				size_t index = j * m_resU + i;
+
+				m_vertexData[index].position = m_func(m_rangeU.x + stepU * i, v);
+				m_vertexData[index].uv = DirectX::XMFLOAT2 { static_cast <float> (i) / quadsU, static_cast <float> (j) / quadsV };
+			}
+		}
+	}, 16);
+
+	// detect boundaries collapsing onto a single point, so that poles don't end up with a fan of split normals
+
+	auto isCollapsed = [this](size_t _start, size_t _stride, size_t _count) {
+		DirectX::XMFLOAT3 p0 = m_vertexData[_start].position;
+		float epsilon = 1e-5f * (1.0f + std::abs(p0.x) + std::abs(p0.y) + std::abs(p0.z));
+
+		for (size_t k = 1; k < _count; k++) {
+			DirectX::XMFLOAT3 p = m_vertexData[_start + k * _stride].position;
+			if (std::abs(p.x - p0.x) > epsilon || std::abs(p.y - p0.y) > epsilon || std::abs(p.z - p0.z) > epsilon) return false;
+		}
+		return true;
+	};
+
+	m_collapsedV[0] = m_wrapV == WRAP::NONE && isCollapsed(0, 1, m_resU);
+	m_collapsedV[1] = m_wrapV == WRAP::NONE && isCollapsed(static_cast <size_t> (m_resV - 1U) * m_resU, 1, m_resU);
+	m_collapsedU[0] = m_wrapU == WRAP::NONE && isCollapsed(0, m_resU, m_resV);
+	m_collapsedU[1] = m_wrapU == WRAP::NONE && isCollapsed(m_resU - 1U, m_resU, m_resV);
+
+	// indices, same quad split as Plane
+
+	ParallelFor(0, quadsV, [&](size_t _begin, size_t _end) {
+		for (size_t j = _begin; j < _end; j++) {
+			for (size_t i = 0; i < quadsU; i++) {
+				size_t index = (j * quadsU + i) * 6U;
+				uint32_t i0 = static_cast <uint32_t> (i), j0 = static_cast <uint32_t> (j);
+
+				m_indices[index] = SampleIndex(i0, j0);
+				m_indices[index + 1] = SampleIndex(i0 + 1U, j0);
+				m_indices[index + 2] = SampleIndex(i0, j0 + 1U);
+
+				m_indices[index + 3] = m_indices[index + 1];
+				m_indices[index + 4] = SampleIndex(i0 + 1U, j0 + 1U);
+				m_indices[index + 5] = m_indices[index + 2];
+			}
+		}
+	}, 16);
+
+	// face normals, welded triangles degenerate to a zero normal and don't contribute to smooth normals
+
+	std::unique_ptr <DirectX::XMFLOAT3[]> faceNorm(new DirectX::XMFLOAT3[m_polyCount]);
+	ParallelFor(0, m_polyCount, [&](size_t _begin, size_t _end) {
+		for (size_t i = _begin * 3; i < _end * 3; i += 3) {
+			DirectX::XMFLOAT3 a, b;
+
+			a = Math::XMFloat3Subtract(m_vertexData[m_indices[i + 1]].position, m_vertexData[m_indices[i]].position);
+			b = Math::XMFloat3Subtract(m_vertexData[m_indices[i + 2]].position, m_vertexData[m_indices[i]].position);
+
+			DirectX::XMStoreFloat3(
+				&faceNorm[i / 3],
+				DirectX::XMVector3Normalize(DirectX::XMVector3Cross(
+					DirectX::XMLoadFloat3(&a),
+					DirectX::XMLoadFloat3(&b)
+				))
+			);
+		}
+	}, 4096);
+
+	SetShading(faceNorm.get());
+	SetBuffers();
+}
+
 //
 // ---------- class CustomMesh
 //
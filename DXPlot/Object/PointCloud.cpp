@@ -0,0 +1,282 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Object/PointCloud.hpp>
+#include <util.hpp>
+
+#include <DirectXPackedVector.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <queue>
+#include <random>
+#include <stdexcept>
+
+using namespace Cass;
+
+namespace {
+	// points kept by an inner node, a node with up to twice as many keeps all of them
+	const size_t s_nodeSamples = 4096;
+	const uint32_t s_maxDepth = 20;
+
+	// points per instance buffer, 64 MB each
+	const size_t s_bufferPoints = 1 << 22;
+
+	/**
+	* @brief Screen size in pixels of the box _center +- _halfSize under _toClip, 0 if it's outside the view
+	*		 and FLT_MAX if it reaches behind the camera
+	*/
+	float ProjectedSize(DirectX::XMFLOAT3 _center, float _halfSize, DirectX::FXMMATRIX _toClip, DirectX::XMFLOAT2 _viewport) {
+		// corners outside of each clip plane, culled if all 8 are outside the same one
+		int outside[6] = { 0, 0, 0, 0, 0, 0 };
+		bool behind = false;
+
+		float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+		for (int i = 0; i < 8; i++) {
+			DirectX::XMVECTOR corner = DirectX::XMVectorSet(
+				_center.x + (i & 1 ? _halfSize : -_halfSize),
+				_center.y + (i & 2 ? _halfSize : -_halfSize),
+				_center.z + (i & 4 ? _halfSize : -_halfSize),
+				1.0f
+			);
+
+			DirectX::XMFLOAT4 clip;
+			DirectX::XMStoreFloat4(&clip, DirectX::XMVector4Transform(corner, _toClip));
+
+			outside[0] += clip.x < -clip.w;
+			outside[1] += clip.x > clip.w;
+			outside[2] += clip.y < -clip.w;
+			outside[3] += clip.y > clip.w;
+			outside[4] += clip.z < 0.0f;
+			outside[5] += clip.z > clip.w;
+
+			if (clip.w <= 0.0f) {
+				behind = true;
+				continue;
+			}
+
+			minX = std::min(minX, clip.x / clip.w);
+			maxX = std::max(maxX, clip.x / clip.w);
+			minY = std::min(minY, clip.y / clip.w);
+			maxY = std::max(maxY, clip.y / clip.w);
+		}
+
+		for (int plane = 0; plane < 6; plane++) {
+			if (outside[plane] == 8) return 0.0f;
+		}
+		if (behind) return FLT_MAX;
+
+		return std::max((maxX - minX) * 0.5f * _viewport.x, (maxY - minY) * 0.5f * _viewport.y);
+	}
+}
+
+//
+// ---------- class PointCloud
+//
+
+PointCloud::PointCloud(
+	std::vector <DirectX::XMFLOAT3> _points, const std::vector <DirectX::XMFLOAT4>& _colors,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+) : Empty(0) {
+	if (!_colors.empty() && _colors.size() != _points.size()) {
+		throw std::invalid_argument("Expected one color per point");
+	}
+
+	m_device = _pDevice;
+	m_deviceContext = _pContext;
+	m_topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+
+	m_pointBudget = 1 << 22;
+	m_minNodePixels = 64.0f;
+	m_drawnNodes = m_drawnPoints = 0;
+
+	m_points.resize(_points.size());
+	ParallelFor(0, _points.size(), [&](size_t _first, size_t _last) {
+		for (size_t i = _first; i < _last; i++) {
+			DirectX::PackedVector::XMUBYTEN4 color(_colors.empty() ? 0xFFFFFFFF : 0);
+			if (!_colors.empty()) DirectX::PackedVector::XMStoreUByteN4(&color, DirectX::XMLoadFloat4(&_colors[i]));
+
+			m_points[i] = { _points[i], color.v };
+		}
+	}, 1 << 16);
+	_points.clear();
+	_points.shrink_to_fit();
+
+	if (m_points.empty()) return;
+
+	// in random order every prefix of a range is an even subsample of it, which is what the nodes keep
+	std::shuffle(m_points.begin(), m_points.end(), std::mt19937(0x5EED));
+
+	DirectX::XMFLOAT3 lb = m_points[0].position, ub = m_points[0].position;
+	for (const auto& point : m_points) {
+		lb = { std::min(lb.x, point.position.x), std::min(lb.y, point.position.y), std::min(lb.z, point.position.z) };
+		ub = { std::max(ub.x, point.position.x), std::max(ub.y, point.position.y), std::max(ub.z, point.position.z) };
+	}
+	SetBounds(lb, ub);
+
+	Node root = {};
+	root.center = { (lb.x + ub.x) * 0.5f, (lb.y + ub.y) * 0.5f, (lb.z + ub.z) * 0.5f };
+	root.halfSize = std::max({ ub.x - lb.x, ub.y - lb.y, ub.z - lb.z, FLT_EPSILON }) * 0.5f;
+	m_nodes.push_back(root);
+
+	std::vector <detail::POINT_INSTANCE_DATA> scratch(m_points.size());
+	Build(0, 0, m_points.size(), 0, scratch);
+
+	CreateInstanceBuffers();
+}
+
+void PointCloud::Build(uint32_t _node, size_t _begin, size_t _end, uint32_t _depth, std::vector <detail::POINT_INSTANCE_DATA>& _scratch) {
+	m_nodes[_node].begin = _begin;
+	if (_end - _begin <= 2 * s_nodeSamples || _depth == s_maxDepth) {
+		m_nodes[_node].count = _end - _begin;
+		return;
+	}
+	m_nodes[_node].count = s_nodeSamples;
+
+	DirectX::XMFLOAT3 center = m_nodes[_node].center;
+	float half = m_nodes[_node].halfSize * 0.5f;
+	auto octant = [&center](const DirectX::XMFLOAT3& _p) {
+		return (_p.x >= center.x ? 1 : 0) | (_p.y >= center.y ? 2 : 0) | (_p.z >= center.z ? 4 : 0);
+	};
+
+	// a stable counting sort into the octants keeps the order within each of them random
+	size_t first = _begin + s_nodeSamples;
+	size_t offsets[9] = {};
+	for (size_t i = first; i < _end; i++) offsets[octant(m_points[i].position) + 1]++;
+	for (int i = 0; i < 8; i++) offsets[i + 1] += offsets[i];
+
+	size_t cursor[8];
+	std::copy(offsets, offsets + 8, cursor);
+	for (size_t i = first; i < _end; i++) _scratch[first + cursor[octant(m_points[i].position)]++] = m_points[i];
+	std::copy(_scratch.begin() + first, _scratch.begin() + _end, m_points.begin() + first);
+
+	for (int i = 0; i < 8; i++) {
+		if (offsets[i + 1] == offsets[i]) continue;
+
+		Node child = {};
+		child.center = {
+			center.x + (i & 1 ? half : -half),
+			center.y + (i & 2 ? half : -half),
+			center.z + (i & 4 ? half : -half)
+		};
+		child.halfSize = half;
+
+		uint32_t index = static_cast <uint32_t> (m_nodes.size());
+		m_nodes.push_back(child);
+		m_nodes[_node].children[i] = index;
+
+		Build(index, first + offsets[i], first + offsets[i + 1], _depth + 1, _scratch);
+	}
+}
+
+void PointCloud::CreateInstanceBuffers() {
+	m_instanceBuffers.clear();
+
+	for (size_t begin = 0; begin < m_points.size(); begin += s_bufferPoints) {
+		size_t count = std::min(s_bufferPoints, m_points.size() - begin);
+
+		D3D11_BUFFER_DESC bdc;
+		ZeroMemory(&bdc, sizeof(bdc));
+		bdc.Usage = D3D11_USAGE_IMMUTABLE;
+		bdc.ByteWidth = static_cast <UINT> (sizeof(detail::POINT_INSTANCE_DATA) * count);
+		bdc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+		D3D11_SUBRESOURCE_DATA srd;
+		ZeroMemory(&srd, sizeof(srd));
+		srd.pSysMem = m_points.data() + begin;
+
+		Microsoft::WRL::ComPtr <ID3D11Buffer> buffer;
+		Cass::ThrowIfFailed(m_device->CreateBuffer(&bdc, &srd, buffer.ReleaseAndGetAddressOf()));
+		m_instanceBuffers.push_back(buffer);
+	}
+}
+
+void PointCloud::Select(const CameraFrame& _frame, std::vector <std::pair <size_t, size_t>>& _oRanges) {
+	_oRanges.clear();
+	m_drawnNodes = m_drawnPoints = 0;
+	if (m_nodes.empty()) return;
+
+	DirectX::XMMATRIX toClip = DirectX::XMMatrixMultiply(
+		GetTransformation(),
+		_frame.GetViewProjection()
+	);
+	DirectX::XMFLOAT2 viewport = _frame.GetViewportSize();
+
+	// largest on screen first
+	std::priority_queue <std::pair <float, uint32_t>> queue;
+	auto visit = [&](uint32_t _index) {
+		float pixels = ProjectedSize(m_nodes[_index].center, m_nodes[_index].halfSize, toClip, viewport);
+		if (pixels > 0.0f) queue.push({ pixels, _index });
+	};
+
+	visit(0);
+	while (!queue.empty()) {
+		auto [pixels, index] = queue.top();
+		queue.pop();
+
+		const Node& node = m_nodes[index];
+		if (m_drawnPoints > 0 && m_drawnPoints + node.count > m_pointBudget) break;
+
+		_oRanges.push_back({ node.begin, node.count });
+		m_drawnPoints += node.count;
+		m_drawnNodes++;
+
+		if (pixels < m_minNodePixels) continue;
+		for (uint32_t child : node.children) {
+			if (child != 0) visit(child);
+		}
+	}
+
+	// a node's points are followed by those of its first child, so refined regions mostly merge into single draws
+	std::sort(_oRanges.begin(), _oRanges.end());
+	size_t merged = 0;
+	for (size_t i = 1; i < _oRanges.size(); i++) {
+		if (_oRanges[merged].first + _oRanges[merged].second == _oRanges[i].first) _oRanges[merged].second += _oRanges[i].second;
+		else _oRanges[++merged] = _oRanges[i];
+	}
+	if (!_oRanges.empty()) _oRanges.resize(merged + 1);
+}
+
+void PointCloud::Render(const CameraFrame& _frame, Shader& _shader) {
+	if (m_instanceBuffers.empty()) return;
+
+	std::vector <std::pair <size_t, size_t>> ranges;
+	Select(_frame, ranges);
+	if (ranges.empty()) return;
+
+	_shader.SetActive(m_deviceContext.Get(), _frame, *this);
+	m_deviceContext->IASetPrimitiveTopology(m_topology);
+
+	// the four corners of each impostor come from the vertex id, only the instances are read from buffers
+	UINT stride = sizeof(detail::POINT_INSTANCE_DATA), offset = 0;
+	size_t bound = SIZE_MAX;
+	for (auto [begin, count] : ranges) {
+		while (count > 0) {
+			size_t buffer = begin / s_bufferPoints, local = begin % s_bufferPoints;
+			size_t instances = std::min(count, s_bufferPoints - local);
+
+			if (buffer != bound) {
+				m_deviceContext->IASetVertexBuffers(0, 1, m_instanceBuffers[buffer].GetAddressOf(), &stride, &offset);
+				bound = buffer;
+			}
+			m_deviceContext->DrawInstanced(4, static_cast <UINT> (instances), 0, static_cast <UINT> (local));
+
+			begin += instances;
+			count -= instances;
+		}
+	}
+}
+
+bool PointCloud::FindPoint(const CameraFrame& _frame, float _x, float _y, float _radius, DirectX::XMFLOAT3& _oPoint, float& _oDistance) {
+	if (m_points.empty()) return false;
+
+	m_hoverIndex.Update(_frame, GetTransformation(), &m_points[0].position, m_points.size(), sizeof(detail::POINT_INSTANCE_DATA));
+	uint32_t index = m_hoverIndex.Nearest(_x, _y, _radius, _oDistance);
+	if (index == ScreenPointIndex::s_nullPoint) return false;
+
+	DirectX::XMStoreFloat3(&_oPoint, DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&m_points[index].position), GetTransformation()));
+	return true;
+}
\ No newline at end of file
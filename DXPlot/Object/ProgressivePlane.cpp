@@ -0,0 +1,178 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Object/ProgressivePlane.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+
+using namespace Cass;
+
+namespace {
+	// the first level has at most this many intervals along either axis
+	const uint32_t s_coarseSize = 32;
+
+	bool OnLattice(size_t _index, size_t _stride, size_t _count) {
+		return _index % _stride == 0 || _index + 1 == _count;
+	}
+}
+
+//
+// ---------- class ProgressivePlane
+//
+
+ProgressivePlane::ProgressivePlane(
+	Function _func, float _width, float _length, uint32_t _resX, uint32_t _resY,
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext,
+	SHADING _shading) : Plane(_width, _length, _resX, _resY, _pDevice, _pContext, _shading) {
+
+	m_stride = 0;
+	m_hasPending = false;
+	m_stop = false;
+	m_publishedGeneration = 0;
+	m_publishedStride = 0;
+	m_hasPublished = false;
+	m_errorGeneration = 0;
+	m_generation = 0;
+
+	m_worker = std::thread(&ProgressivePlane::WorkerLoop, this);
+	SetFunction(_func);
+}
+
+ProgressivePlane::~ProgressivePlane() {
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_stop = true;
+		m_generation++;
+	}
+	m_wake.notify_one();
+	m_worker.join();
+}
+
+void ProgressivePlane::SetFunction(Function _func) {
+	if (!_func) return;
+
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_pending = std::move(_func);
+		m_hasPending = true;
+		m_generation++;
+	}
+	m_wake.notify_one();
+}
+
+void ProgressivePlane::Refresh() {
+	bool ready = false;
+	std::exception_ptr error;
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+
+		// reported once, and only while the function that threw is still the current one
+		if (m_error && IsCurrent(m_errorGeneration)) error = m_error;
+		m_error = nullptr;
+
+		// a level of an abandoned function is never shown
+		if (m_hasPublished && IsCurrent(m_publishedGeneration)) {
+			m_published.swap(m_display);
+			m_stride = m_publishedStride;
+			ready = true;
+		}
+		m_hasPublished = false;
+	}
+
+	if (ready) SetHeights(m_display);
+	if (error) std::rethrow_exception(error);
+}
+
+void ProgressivePlane::WorkerLoop() {
+	for (;;) {
+		Function func;
+		uint64_t generation;
+		{
+			std::unique_lock <std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this]() { return m_stop || m_hasPending; });
+			if (m_stop) return;
+
+			// only the latest function matters, anything set before it was already replaced
+			func = std::move(m_pending);
+			m_hasPending = false;
+			generation = m_generation.load();
+		}
+
+		// an exception must not leave the thread, the render thread gets it instead
+		try {
+			Evaluate(func, generation);
+		}
+		catch (...) {
+			std::lock_guard <std::mutex> lock(m_mutex);
+			m_error = std::current_exception();
+			m_errorGeneration = generation;
+		}
+	}
+}
+
+void ProgressivePlane::Evaluate(const Function& _func, uint64_t _generation) {
+	DirectX::XMUINT2 size = GetGridSize();
+	DirectX::XMFLOAT2 dims = GetDimensions();
+	size_t width = size.x, height = size.y;
+
+	m_samples.resize(width * height);
+	m_level.resize(width * height);
+
+	// same vertex layout as the plane, rows run from +y to -y
+	float offsetX = dims.x / (width - 1U), offsetY = dims.y / (height - 1U);
+
+	size_t coarse = 1;
+	while ((width - 1U) / coarse > s_coarseSize || (height - 1U) / coarse > s_coarseSize) coarse *= 2;
+
+	for (size_t stride = coarse; stride > 0; stride /= 2) {
+		// evaluate the lattice points the previous level didn't have
+		ParallelFor(0, height, [&](size_t _begin, size_t _end) {
+			for (size_t i = _begin; i < _end && IsCurrent(_generation); i++) {
+				if (!OnLattice(i, stride, height)) continue;
+				bool coarseRow = stride < coarse && OnLattice(i, stride * 2U, height);
+
+				for (size_t j = 0; j < width; j++) {
+					if (!OnLattice(j, stride, width)) continue;
+					if (coarseRow && OnLattice(j, stride * 2U, width)) continue;
+
+					m_samples[i * width + j] = _func(-dims.x / 2 + j * offsetX, dims.y / 2 - i * offsetY);
+				}
+			}
+		});
+		if (!IsCurrent(_generation)) return;
+
+		// fill the remaining vertices bilinearly from the lattice
+		ParallelFor(0, height, [&](size_t _begin, size_t _end) {
+			for (size_t i = _begin; i < _end; i++) {
+				size_t i0 = i / stride * stride, i1 = std::min(i0 + stride, height - 1U);
+				float ti = i1 > i0 ? static_cast <float> (i - i0) / (i1 - i0) : 0.0f;
+
+				for (size_t j = 0; j < width; j++) {
+					size_t j0 = j / stride * stride, j1 = std::min(j0 + stride, width - 1U);
+					float tj = j1 > j0 ? static_cast <float> (j - j0) / (j1 - j0) : 0.0f;
+
+					float top = m_samples[i0 * width + j0] + tj * (m_samples[i0 * width + j1] - m_samples[i0 * width + j0]);
+					float bottom = m_samples[i1 * width + j0] + tj * (m_samples[i1 * width + j1] - m_samples[i1 * width + j0]);
+					m_level[i * width + j] = top + ti * (bottom - top);
+				}
+			}
+		});
+
+		{
+			std::lock_guard <std::mutex> lock(m_mutex);
+			if (!IsCurrent(_generation)) return;
+
+			m_published.swap(m_level);
+			m_publishedGeneration = _generation;
+			m_publishedStride = static_cast <uint32_t> (stride);
+			m_hasPublished = true;
+		}
+
+		// the buffer handed back is empty until the render thread has taken a level
+		m_level.resize(width * height);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,317 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Resource/CsvTable.hpp>
+#include <Resource/MappedFile.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+#if defined(_XM_SSE_INTRINSICS_)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace Cass;
+
+namespace {
+	// bytes parsed per task, several tasks per thread so uneven lines even out
+	const size_t s_minChunk = 1 << 20;
+	const size_t s_chunksPerThread = 4;
+
+	const float s_nan = std::numeric_limits <float>::quiet_NaN();
+	const double s_wideNan = std::numeric_limits <double>::quiet_NaN();
+
+	// from here on float can't tell neighbouring integers apart
+	const double s_wideLimit = 16777216.0;
+
+	uint32_t LowestBit(uint32_t _mask) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, _mask);
+		return index;
+#else
+		return __builtin_ctz(_mask);
+#endif
+	}
+
+	const char* FindByte(const char* _begin, const char* _end, char _value) {
+#if defined(_XM_SSE_INTRINSICS_)
+		__m128i pattern = _mm_set1_epi8(_value);
+		for (; _end - _begin >= 16; _begin += 16) {
+			int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast <const __m128i*> (_begin)), pattern));
+			if (mask != 0) return _begin + LowestBit(mask);
+		}
+#endif
+		for (; _begin < _end; _begin++) {
+			if (*_begin == _value) return _begin;
+		}
+		return _end;
+	}
+
+	/**
+	* @brief Bit i is set if _block[i] is a delimiter or a line break, _size at most 16
+	*/
+	uint32_t SeparatorMask(const char* _block, size_t _size, char _delimiter) {
+#if defined(_XM_SSE_INTRINSICS_)
+		if (_size == 16) {
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast <const __m128i*> (_block));
+			__m128i separators = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(_delimiter)), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+			return static_cast <uint32_t> (_mm_movemask_epi8(separators));
+		}
+#endif
+		uint32_t mask = 0;
+		for (size_t i = 0; i < _size; i++) {
+			if (_block[i] == _delimiter || _block[i] == '\n') mask |= 1u << i;
+		}
+		return mask;
+	}
+
+	void Trim(const char*& _begin, const char*& _end) {
+		while (_begin < _end && (*_begin == ' ' || *_begin == '\t')) _begin++;
+		while (_end > _begin && (_end[-1] == ' ' || _end[-1] == '\t' || _end[-1] == '\r')) _end--;
+	}
+
+	bool IsBlank(const char* _begin, const char* _end) {
+		Trim(_begin, _end);
+		return _begin == _end;
+	}
+
+	/**
+	* @brief Number of lines in [_begin, _end) that hold more than whitespace
+	*/
+	size_t CountRows(const char* _begin, const char* _end) {
+		size_t count = 0;
+		while (_begin < _end) {
+			const char* lineEnd = FindByte(_begin, _end, '\n');
+			if (!IsBlank(_begin, lineEnd)) count++;
+			_begin = lineEnd + 1;
+		}
+		return count;
+	}
+
+	template <class T>
+	bool ParseNumber(const char* _begin, const char* _end, T& _oValue) {
+		Trim(_begin, _end);
+		if (_begin < _end && *_begin == '+') _begin++;
+		if (_begin == _end) return false;
+
+		auto result = std::from_chars(_begin, _end, _oValue);
+		return result.ec == std::errc() && result.ptr == _end;
+	}
+}
+
+//
+// ---------- class CsvTable
+//
+
+CsvTable::CsvTable() {
+	m_rowCount = 0;
+	m_byteCount = 0;
+	m_loadTime = 0.0;
+}
+
+HRESULT CsvTable::Load(LPCWSTR _fileName, char _delimiter, bool _header) {
+	auto start = std::chrono::high_resolution_clock::now();
+
+	m_names.clear();
+	m_types.clear();
+	m_columns.clear();
+	m_wideColumns.clear();
+	m_rowCount = 0;
+	m_byteCount = 0;
+	m_loadTime = 0.0;
+
+	MappedFile file;
+	HRESULT hr = file.Open(_fileName);
+	if (FAILED(hr)) return hr;
+
+	const char* data = reinterpret_cast <const char*> (file.GetData());
+	const char* end = data + file.GetSize();
+	m_byteCount = file.GetSize();
+
+	if (end - data >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) data += 3;
+	if (data == end) return S_OK;
+
+	// the first line decides the number of columns
+	const char* lineEnd = FindByte(data, end, '\n');
+	for (const char* field = data;;) {
+		const char* fieldEnd = FindByte(field, lineEnd, _delimiter);
+		const char* nameBegin = field, *nameEnd = fieldEnd;
+		Trim(nameBegin, nameEnd);
+
+		m_names.push_back(_header ? std::string(nameBegin, nameEnd) : std::to_string(m_names.size()));
+		if (fieldEnd == lineEnd) break;
+		field = fieldEnd + 1;
+	}
+
+	const char* body = _header ? std::min(lineEnd + 1, end) : data;
+
+	// the first data row decides the column types, blank cells don't make a column text
+	const char* firstRow = body;
+	lineEnd = FindByte(firstRow, end, '\n');
+	while (lineEnd != end && IsBlank(firstRow, lineEnd)) {
+		firstRow = lineEnd + 1;
+		lineEnd = FindByte(firstRow, end, '\n');
+	}
+
+	m_types.assign(m_names.size(), COLUMN_TYPE::NUMBER);
+	const char* field = firstRow;
+	for (size_t c = 0; c < m_names.size() && firstRow < end; c++) {
+		const char* fieldEnd = FindByte(field, lineEnd, _delimiter);
+		const char* textBegin = field, *textEnd = fieldEnd;
+		Trim(textBegin, textEnd);
+
+		double value;
+		if (textBegin != textEnd && !ParseNumber(textBegin, textEnd, value)) m_types[c] = COLUMN_TYPE::TEXT;
+		else if (textBegin != textEnd && std::abs(value) >= s_wideLimit) m_types[c] = COLUMN_TYPE::WIDE_NUMBER;
+		if (fieldEnd == lineEnd) break;
+		field = fieldEnd + 1;
+	}
+
+	// chunks of whole lines
+	size_t bytes = end - body;
+	size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+	size_t chunkCount = std::max <size_t> (1, std::min(bytes / s_minChunk, threadCount * s_chunksPerThread));
+
+	std::vector <const char*> bounds(chunkCount + 1);
+	bounds[0] = body;
+	bounds[chunkCount] = end;
+	for (size_t c = 1; c < chunkCount; c++) {
+		const char* split = std::max(body + bytes * c / chunkCount, bounds[c - 1]);
+		const char* lineBreak = FindByte(split - 1, end, '\n');
+		bounds[c] = lineBreak == end ? end : lineBreak + 1;
+	}
+
+	// first pass counts the rows of each chunk, the second parses them into their place
+	std::vector <size_t> rows(chunkCount + 1, 0);
+	ParallelFor(0, chunkCount, [&](size_t _first, size_t _last) {
+		for (size_t c = _first; c < _last; c++) rows[c + 1] = CountRows(bounds[c], bounds[c + 1]);
+	});
+	for (size_t c = 0; c < chunkCount; c++) rows[c + 1] += rows[c];
+	m_rowCount = rows[chunkCount];
+
+	m_columns.resize(m_names.size());
+	m_wideColumns.resize(m_names.size());
+	for (size_t c = 0; c < m_names.size(); c++) {
+		if (m_types[c] == COLUMN_TYPE::NUMBER) m_columns[c].resize(m_rowCount);
+		if (m_types[c] == COLUMN_TYPE::WIDE_NUMBER) m_wideColumns[c].resize(m_rowCount);
+	}
+
+	ParallelFor(0, chunkCount, [&](size_t _first, size_t _last) {
+		for (size_t c = _first; c < _last; c++) ParseLines(bounds[c], bounds[c + 1], rows[c], _delimiter);
+	});
+
+	m_loadTime = std::chrono::duration <double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	// DebugLog reads %u as 64 bit and has no precision or length modifiers
+	DebugLog("CsvTable: %u rows, %u columns, %f MB in %f ms (%f GB/s)\n",
+		static_cast <uint64_t> (m_rowCount), static_cast <uint64_t> (m_names.size()), static_cast <double> (m_byteCount) / 1e6, m_loadTime, GetThroughput());
+
+	return S_OK;
+}
+
+size_t CsvTable::FindColumn(const std::string& _name) const {
+	auto it = std::find(m_names.begin(), m_names.end(), _name);
+	return it == m_names.end() ? SIZE_MAX : static_cast <size_t> (it - m_names.begin());
+}
+
+std::vector <DirectX::XMFLOAT2> CsvTable::GetPoints(size_t _x, size_t _y, double _xOrigin) const {
+	CheckNumbers(_x);
+	CheckNumbers(_y);
+
+	std::vector <DirectX::XMFLOAT2> points(m_rowCount);
+	ParallelFor(0, m_rowCount, [&](size_t _first, size_t _last) {
+		for (size_t i = _first; i < _last; i++) points[i] = { GetNumber(_x, i, _xOrigin), GetNumber(_y, i, 0.0) };
+	}, s_minChunk);
+
+	return points;
+}
+
+std::vector <DirectX::XMFLOAT3> CsvTable::GetPoints(size_t _x, size_t _y, size_t _z) const {
+	CheckNumbers(_x);
+	CheckNumbers(_y);
+	CheckNumbers(_z);
+
+	std::vector <DirectX::XMFLOAT3> points(m_rowCount);
+	ParallelFor(0, m_rowCount, [&](size_t _first, size_t _last) {
+		for (size_t i = _first; i < _last; i++) points[i] = { GetNumber(_x, i, 0.0), GetNumber(_y, i, 0.0), GetNumber(_z, i, 0.0) };
+	}, s_minChunk);
+
+	return points;
+}
+
+double CsvTable::GetThroughput() const {
+	return m_loadTime > 0.0 ? static_cast <double> (m_byteCount) / 1e9 / (m_loadTime / 1e3) : 0.0;
+}
+
+void CsvTable::ParseLines(const char* _begin, const char* _end, size_t _row, char _delimiter) {
+	size_t columnCount = m_names.size(), column = 0;
+	const char* field = _begin;
+
+	auto endField = [&](const char* _fieldEnd) {
+		if (column < columnCount && m_types[column] == COLUMN_TYPE::NUMBER) {
+			float value;
+			m_columns[column][_row] = ParseNumber(field, _fieldEnd, value) ? value : s_nan;
+		}
+		else if (column < columnCount && m_types[column] == COLUMN_TYPE::WIDE_NUMBER) {
+			double value;
+			m_wideColumns[column][_row] = ParseNumber(field, _fieldEnd, value) ? value : s_wideNan;
+		}
+		column++;
+	};
+	auto endLine = [&]() {
+		// short lines leave the missing cells empty
+		for (; column < columnCount; column++) {
+			if (m_types[column] == COLUMN_TYPE::NUMBER) m_columns[column][_row] = s_nan;
+			if (m_types[column] == COLUMN_TYPE::WIDE_NUMBER) m_wideColumns[column][_row] = s_wideNan;
+		}
+		column = 0;
+		_row++;
+	};
+
+	// every set bit is the end of a field, the structure is found 16 bytes at a time before touching the values
+	for (const char* block = _begin; block < _end; block += 16) {
+		uint32_t mask = SeparatorMask(block, std::min <size_t> (16, _end - block), _delimiter);
+
+		while (mask != 0) {
+			const char* separator = block + LowestBit(mask);
+			mask &= mask - 1;
+
+			// blank lines aren't rows, the same as in CountRows
+			if (*separator != '\n' || column != 0 || !IsBlank(field, separator)) {
+				endField(separator);
+				if (*separator == '\n') endLine();
+			}
+			field = separator + 1;
+		}
+	}
+
+	// last line without a line break
+	if (field < _end && (column != 0 || !IsBlank(field, _end))) {
+		endField(_end);
+		endLine();
+	}
+}
+
+float CsvTable::GetNumber(size_t _column, size_t _row, double _origin) const {
+	if (m_types[_column] == COLUMN_TYPE::WIDE_NUMBER) return static_cast <float> (m_wideColumns[_column][_row] - _origin);
+	return static_cast <float> (m_columns[_column][_row] - _origin);
+}
+
+void CsvTable::CheckNumbers(size_t _column) const {
+	if (_column >= m_columns.size() || m_types[_column] == COLUMN_TYPE::TEXT) {
+		throw std::invalid_argument("Column out of range or not a number column");
+	}
+}
\ No newline at end of file
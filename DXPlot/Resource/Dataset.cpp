@@ -0,0 +1,303 @@
+#pragma warning (disable: 26451)
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Resource/Dataset.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+using namespace Cass;
+
+namespace {
+	const char s_magic[4] = { 'C', 'D', 'A', 'T' };
+	const uint32_t s_version = 1;
+	const uint64_t s_alignment = 64;
+	const size_t s_nameSize = 48;
+
+	const float s_nan = std::numeric_limits <float>::quiet_NaN();
+
+	/*
+	* start of the file, followed by one COLUMN_DESC per column, the chunk stats of all columns and the column data
+	*/
+	struct FILE_HEADER {
+		char magic[4];
+		uint32_t version;
+		uint32_t columnCount;
+		uint32_t chunkRows;
+		uint64_t rowCount;
+		uint64_t reserved;
+	};
+
+	struct COLUMN_DESC {
+		char name[s_nameSize];
+		uint64_t statsOffset;
+		uint64_t dataOffset;
+	};
+
+	uint64_t Align(uint64_t _offset) {
+		return (_offset + s_alignment - 1) / s_alignment * s_alignment;
+	}
+
+	HRESULT WriteAll(HANDLE _file, const void* _data, uint64_t _size) {
+		const uint8_t* data = static_cast <const uint8_t*> (_data);
+		while (_size > 0) {
+			DWORD written = 0;
+			DWORD size = static_cast <DWORD> (std::min <uint64_t> (_size, 1 << 30));
+			if (!WriteFile(_file, data, size, &written, nullptr)) return HRESULT_FROM_WIN32(GetLastError());
+
+			data += written;
+			_size -= written;
+		}
+		return S_OK;
+	}
+}
+
+//
+// ---------- class Dataset
+//
+
+Dataset::Dataset() {
+	m_rowCount = 0;
+	m_chunkRows = 0;
+}
+
+HRESULT Dataset::Write(
+	LPCWSTR _fileName, const std::vector <std::string>& _names, const std::vector <const float*>& _columns, size_t _rowCount,
+	uint32_t _chunkRows
+) {
+	if (_names.size() != _columns.size() || _chunkRows == 0) return E_INVALIDARG;
+
+	size_t chunkCount = (_rowCount + _chunkRows - 1) / _chunkRows;
+
+	// metadata first, the data offsets follow from it
+	FILE_HEADER header = {};
+	memcpy(header.magic, s_magic, sizeof(s_magic));
+	header.version = s_version;
+	header.columnCount = static_cast <uint32_t> (_columns.size());
+	header.chunkRows = _chunkRows;
+	header.rowCount = _rowCount;
+
+	std::vector <COLUMN_DESC> descs(_columns.size());
+	uint64_t offset = sizeof(FILE_HEADER) + descs.size() * sizeof(COLUMN_DESC);
+	for (size_t c = 0; c < descs.size(); c++) {
+		memset(descs[c].name, 0, s_nameSize);
+		memcpy(descs[c].name, _names[c].data(), std::min(_names[c].size(), s_nameSize - 1));
+
+		descs[c].statsOffset = offset;
+		offset += chunkCount * sizeof(ChunkStats);
+	}
+	for (size_t c = 0; c < descs.size(); c++) {
+		offset = Align(offset);
+		descs[c].dataOffset = offset;
+		offset += _rowCount * sizeof(float);
+	}
+
+	std::vector <ChunkStats> stats(descs.size() * chunkCount);
+	ParallelFor(0, stats.size(), [&](size_t _first, size_t _last) {
+		for (size_t i = _first; i < _last; i++) {
+			size_t column = i / chunkCount, chunk = i % chunkCount;
+			size_t begin = chunk * _chunkRows, end = std::min(begin + _chunkRows, _rowCount);
+
+			ChunkStats chunkStats = { s_nan, s_nan, 0, 0 };
+			for (size_t row = begin; row < end; row++) {
+				float value = _columns[column][row];
+				if (std::isnan(value)) continue;
+
+				chunkStats.min = chunkStats.count == 0 ? value : std::min(chunkStats.min, value);
+				chunkStats.max = chunkStats.count == 0 ? value : std::max(chunkStats.max, value);
+				chunkStats.count++;
+			}
+			stats[i] = chunkStats;
+		}
+	});
+
+	HANDLE file = CreateFileW(_fileName, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return HRESULT_FROM_WIN32(GetLastError());
+
+	HRESULT hr = WriteAll(file, &header, sizeof(header));
+	if (SUCCEEDED(hr)) hr = WriteAll(file, descs.data(), descs.size() * sizeof(COLUMN_DESC));
+	if (SUCCEEDED(hr)) hr = WriteAll(file, stats.data(), stats.size() * sizeof(ChunkStats));
+
+	uint64_t position = sizeof(FILE_HEADER) + descs.size() * sizeof(COLUMN_DESC) + stats.size() * sizeof(ChunkStats);
+	const uint8_t padding[s_alignment] = {};
+	for (size_t c = 0; c < descs.size() && SUCCEEDED(hr); c++) {
+		hr = WriteAll(file, padding, descs[c].dataOffset - position);
+		if (SUCCEEDED(hr)) hr = WriteAll(file, _columns[c], _rowCount * sizeof(float));
+		position = descs[c].dataOffset + _rowCount * sizeof(float);
+	}
+
+	CloseHandle(file);
+	return hr;
+}
+
+HRESULT Dataset::Write(LPCWSTR _fileName, const CsvTable& _table, uint32_t _chunkRows) {
+	std::vector <std::string> names;
+	std::vector <const float*> columns;
+
+	// the file holds float, wide columns are rounded into copies that live until the write is done
+	std::vector <std::vector <float>> rounded;
+	rounded.reserve(_table.GetColumnCount());
+
+	for (size_t c = 0; c < _table.GetColumnCount(); c++) {
+		if (_table.GetType(c) == COLUMN_TYPE::TEXT) continue;
+
+		names.push_back(_table.GetName(c));
+		if (_table.GetType(c) == COLUMN_TYPE::NUMBER) {
+			columns.push_back(_table.GetColumn(c).data());
+			continue;
+		}
+
+		const std::vector <double>& wide = _table.GetWideColumn(c);
+		rounded.emplace_back(wide.size());
+		for (size_t i = 0; i < wide.size(); i++) rounded.back()[i] = static_cast <float> (wide[i]);
+		columns.push_back(rounded.back().data());
+	}
+
+	return Write(_fileName, names, columns, _table.GetRowCount(), _chunkRows);
+}
+
+HRESULT Dataset::Open(LPCWSTR _fileName) {
+	m_columns.clear();
+	m_rowCount = 0;
+	m_chunkRows = 0;
+
+	HRESULT hr = m_file.Open(_fileName);
+	if (FAILED(hr)) return hr;
+
+	auto corrupt = [this]() {
+		m_file.Close();
+		m_columns.clear();
+		return HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT);
+	};
+
+	uint64_t size = m_file.GetSize();
+	if (size < sizeof(FILE_HEADER)) return corrupt();
+
+	FILE_HEADER header;
+	memcpy(&header, m_file.GetData(), sizeof(header));
+	if (memcmp(header.magic, s_magic, sizeof(s_magic)) != 0 || header.version != s_version || header.chunkRows == 0) return corrupt();
+	if ((size - sizeof(FILE_HEADER)) / sizeof(COLUMN_DESC) < header.columnCount) return corrupt();
+
+	// every column has to lie inside the file, the data aligned for reading it as floats
+	uint64_t chunkCount = (header.rowCount + header.chunkRows - 1) / header.chunkRows;
+	const uint8_t* descs = m_file.GetData() + sizeof(FILE_HEADER);
+	for (uint32_t c = 0; c < header.columnCount; c++) {
+		COLUMN_DESC desc;
+		memcpy(&desc, descs + c * sizeof(COLUMN_DESC), sizeof(desc));
+
+		if (desc.statsOffset % alignof(ChunkStats) != 0 || desc.dataOffset % sizeof(float) != 0) return corrupt();
+		if (desc.statsOffset > size || (size - desc.statsOffset) / sizeof(ChunkStats) < chunkCount) return corrupt();
+		if (desc.dataOffset > size || (size - desc.dataOffset) / sizeof(float) < header.rowCount) return corrupt();
+
+		m_columns.push_back({ std::string(desc.name, strnlen(desc.name, s_nameSize)), desc.statsOffset, desc.dataOffset });
+	}
+
+	m_rowCount = static_cast <size_t> (header.rowCount);
+	m_chunkRows = header.chunkRows;
+
+	return S_OK;
+}
+
+size_t Dataset::FindColumn(const std::string& _name) const {
+	for (size_t c = 0; c < m_columns.size(); c++) {
+		if (m_columns[c].name == _name) return c;
+	}
+	return SIZE_MAX;
+}
+
+const float* Dataset::GetColumn(size_t _column) const {
+	return reinterpret_cast <const float*> (m_file.GetData() + GetDesc(_column).dataOffset);
+}
+
+const Dataset::ChunkStats* Dataset::GetChunkStats(size_t _column) const {
+	return reinterpret_cast <const ChunkStats*> (m_file.GetData() + GetDesc(_column).statsOffset);
+}
+
+DirectX::XMFLOAT2 Dataset::GetRange(size_t _column) const {
+	const ChunkStats* stats = GetChunkStats(_column);
+
+	DirectX::XMFLOAT2 range = { s_nan, s_nan };
+	bool empty = true;
+	for (size_t i = 0; i < GetChunkCount(); i++) {
+		if (stats[i].count == 0) continue;
+
+		range.x = empty ? stats[i].min : std::min(range.x, stats[i].min);
+		range.y = empty ? stats[i].max : std::max(range.y, stats[i].max);
+		empty = false;
+	}
+
+	return range;
+}
+
+BoundingBox Dataset::GetBounds(size_t _x, size_t _y, size_t _z) const {
+	DirectX::XMFLOAT2 x = GetRange(_x), y = GetRange(_y), z = GetRange(_z);
+
+	BoundingBox bounds;
+	bounds.Calculate({ x.x, y.x, z.x }, { x.y, y.y, z.y });
+	return bounds;
+}
+
+void Dataset::FindChunks(size_t _column, float _min, float _max, std::vector <size_t>& _oChunks) const {
+	const ChunkStats* stats = GetChunkStats(_column);
+	for (size_t i = 0; i < GetChunkCount(); i++) {
+		if (stats[i].count > 0 && stats[i].max >= _min && stats[i].min <= _max) _oChunks.push_back(i);
+	}
+}
+
+void Dataset::Filter(size_t _column, float _min, float _max, std::vector <size_t>& _oRows) const {
+	const ChunkStats* stats = GetChunkStats(_column);
+	const float* values = GetColumn(_column);
+
+	std::vector <size_t> chunks;
+	FindChunks(_column, _min, _max, chunks);
+
+	for (size_t chunk : chunks) {
+		size_t begin = chunk * m_chunkRows, end = std::min(begin + m_chunkRows, m_rowCount);
+
+		// a chunk without NaN lying inside the range matches as a whole
+		if (stats[chunk].count == end - begin && stats[chunk].min >= _min && stats[chunk].max <= _max) {
+			for (size_t row = begin; row < end; row++) _oRows.push_back(row);
+			continue;
+		}
+
+		for (size_t row = begin; row < end; row++) {
+			if (values[row] >= _min && values[row] <= _max) _oRows.push_back(row);
+		}
+	}
+}
+
+std::vector <DirectX::XMFLOAT2> Dataset::GetPoints(size_t _x, size_t _y) const {
+	const float* x = GetColumn(_x), * y = GetColumn(_y);
+
+	std::vector <DirectX::XMFLOAT2> points(m_rowCount);
+	ParallelFor(0, m_rowCount, [&](size_t _first, size_t _last) {
+		for (size_t i = _first; i < _last; i++) points[i] = { x[i], y[i] };
+	}, m_chunkRows);
+
+	return points;
+}
+
+std::vector <DirectX::XMFLOAT3> Dataset::GetPoints(size_t _x, size_t _y, size_t _z) const {
+	const float* x = GetColumn(_x), * y = GetColumn(_y), * z = GetColumn(_z);
+
+	std::vector <DirectX::XMFLOAT3> points(m_rowCount);
+	ParallelFor(0, m_rowCount, [&](size_t _first, size_t _last) {
+		for (size_t i = _first; i < _last; i++) points[i] = { x[i], y[i], z[i] };
+	}, m_chunkRows);
+
+	return points;
+}
+
+const Dataset::Column& Dataset::GetDesc(size_t _column) const {
+	if (_column >= m_columns.size()) {
+		throw std::invalid_argument("Column out of range");
+	}
+	return m_columns[_column];
+}
\ No newline at end of file
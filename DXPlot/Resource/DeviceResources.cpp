@@ -24,6 +24,8 @@ DeviceResources::DeviceResources(
 	m_window(NULL),
 	m_windowSize({ 0, 0, 1, 1 }),
 	m_featureLevel(D3D_FEATURE_LEVEL_9_1),
+	m_frameIndex(0),
+	m_completedFrames(0),
 	m_msaaEnabled(_msaa) {
 	
 	ZeroMemory(&m_viewport, sizeof(m_viewport));
@@ -83,6 +85,15 @@ void DeviceResources::CreateDeviceResource(UINT creationFlags) {
 		ThrowIfFailed(dxgiAdapter->GetParent(__uuidof(IDXGIFactory1), &s_factory));
 	}
 	CreateStates();
+
+	// event queries signal when the GPU has worked through the commands of a frame
+	D3D11_QUERY_DESC qd;
+	qd.Query = D3D11_QUERY_EVENT;
+	qd.MiscFlags = 0;
+	for (UINT i = 0; i < s_frameQueryCount; i++) {
+		ThrowIfFailed(m_device->CreateQuery(&qd, m_frameQueries[i].ReleaseAndGetAddressOf()));
+	}
+	m_frameIndex = m_completedFrames = 0;
 }
 
 void DeviceResources::CreateSizeDependentResource() {
@@ -212,6 +223,38 @@ void DeviceResources::Resolve() {
 	m_context->ResolveSubresource(m_renderTarget.Get(), 0, m_renderTarget_msaa.Get(), 0, m_backBufferFormat);
 }
 
+void DeviceResources::EndFrame() {
+	// the query of this frame is still pending from s_frameQueryCount frames ago
+	if (m_frameIndex - m_completedFrames >= s_frameQueryCount) PollFrames(true);
+
+	m_context->End(m_frameQueries[m_frameIndex % s_frameQueryCount].Get());
+	m_frameIndex++;
+
+	PollFrames(false);
+}
+
+void DeviceResources::PollFrames(bool _wait) {
+	while (m_completedFrames < m_frameIndex) {
+		ID3D11Query* query = m_frameQueries[m_completedFrames % s_frameQueryCount].Get();
+		BOOL done = FALSE;
+
+		HRESULT hr;
+		if (_wait) {
+			while ((hr = m_context->GetData(query, &done, sizeof(done), 0)) == S_FALSE) std::this_thread::yield();
+			_wait = false;
+		}
+		else {
+			hr = m_context->GetData(query, &done, sizeof(done), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+		}
+
+		// a lost device never signals, its frames count as done
+		if (hr != S_OK && hr != S_FALSE) done = TRUE;
+		if (!done) break;
+
+		m_completedFrames++;
+	}
+}
+
 void DeviceResources::SetWindow(HWND _hWnd, int _width, int _height) {
 	m_window = _hWnd;
 	m_windowSize.left = m_windowSize.top = 0;
@@ -0,0 +1,68 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Resource/MappedFile.hpp>
+
+using namespace Cass;
+
+//
+// ---------- class MappedFile
+//
+
+MappedFile::MappedFile() {
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = nullptr;
+	m_data = nullptr;
+	m_size = 0;
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+HRESULT MappedFile::Open(LPCWSTR _fileName) {
+	Close();
+
+	// the access pattern of zooming around is random, read ahead would only pull in pages that aren't needed
+	m_file = CreateFileW(_fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE) return HRESULT_FROM_WIN32(GetLastError());
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size)) {
+		HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+		Close();
+		return hr;
+	}
+
+	// an empty file can't be mapped, it's still a valid file with no data
+	m_size = static_cast <uint64_t> (size.QuadPart);
+	if (m_size == 0) return S_OK;
+
+	m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping == nullptr) {
+		HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+		Close();
+		return hr;
+	}
+
+	m_data = static_cast <const uint8_t*> (MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (m_data == nullptr) {
+		HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+		Close();
+		return hr;
+	}
+
+	return S_OK;
+}
+
+void MappedFile::Close() {
+	if (m_data != nullptr) UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr) CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = nullptr;
+	m_data = nullptr;
+	m_size = 0;
+}
\ No newline at end of file
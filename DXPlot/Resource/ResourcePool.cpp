@@ -0,0 +1,28 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Resource/ResourcePool.hpp>
+
+#include <algorithm>
+
+using namespace Cass;
+
+//
+// ---------- class RetireQueue
+//
+
+void RetireQueue::Retire(std::shared_ptr <void> _resource, uint64_t _frame) {
+	if (!_resource) return;
+
+	m_retired.push_back({ std::move(_resource), _frame });
+}
+
+size_t RetireQueue::Collect(uint64_t _completedFrames) {
+	// frames only grow along the queue, the finished ones form its front
+	auto last = std::find_if(m_retired.begin(), m_retired.end(), [&](const Retired& _retired) { return _retired.frame >= _completedFrames; });
+	size_t count = static_cast <size_t> (last - m_retired.begin());
+	m_retired.erase(m_retired.begin(), last);
+
+	return count;
+}
\ No newline at end of file
@@ -35,12 +35,20 @@ namespace {
 		float worldScale;
 		DirectX::XMVECTOR color;
 	};
+
+	__declspec(align(16)) struct POINT_CBUFFERDATA_VS {
+		DirectX::XMMATRIX modelMat;
+		DirectX::XMMATRIX viewMat;
+		DirectX::XMMATRIX projectionMat;
+		DirectX::XMFLOAT2 viewportSize;
+		float pointSize;
+	};
 }
 
-void Shader::SetActive(ID3D11DeviceContext* _pContext, Camera& camera, DirectX::XMMATRIX _modelMat, UINT32 flags) {
+void Shader::SetActive(ID3D11DeviceContext* _pContext, const CameraFrame& _frame, const Transform& _model, UINT32 flags) {
 	if (_pContext == nullptr) return;
 
-	SetBuffers(_pContext, camera, _modelMat, flags);
+	SetBuffers(_pContext, _frame, _model, flags);
 
 	_pContext->IASetInputLayout(m_inputLayout.Get());
 	_pContext->VSSetShader(m_vertShader.Get(), nullptr, NULL);
@@ -52,6 +60,19 @@ void Shader::SetAlbedo(std::shared_ptr <Texture> _albedo) {
 	m_albedo = _albedo;
 }
 
+size_t Shader::GetByteSize() const {
+	size_t size = 0;
+	for (ID3D11Buffer* buffer : { m_vsCbuffer.Get(), m_psCbuffer.Get() }) {
+		if (!buffer) continue;
+
+		D3D11_BUFFER_DESC desc;
+		buffer->GetDesc(&desc);
+		size += desc.ByteWidth;
+	}
+
+	return size;
+}
+
 HRESULT Shader::CompileAndSetLayout(LPCWSTR fName, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext, D3D11_INPUT_ELEMENT_DESC* ied, UINT numElements) {
 	if (_pDevice == nullptr) return E_FAIL;
 
@@ -146,23 +167,22 @@ HRESULT SurfaceShader::LoadFromFile(LPCWSTR _fName, ID3D11Device* _pDevice, ID3D
 	return hr;
 }
 
-void SurfaceShader::SetBuffers(ID3D11DeviceContext* _pContext, Camera& camera, DirectX::XMMATRIX _modelMat, uint32_t flags) {
+void SurfaceShader::SetBuffers(ID3D11DeviceContext* _pContext, const CameraFrame& _frame, const Transform& _model, uint32_t flags) {
 	SURF_CBUFFERDATA_VS cb;
 	ZeroMemory(&cb, sizeof(cb));
-	cb.modelMat = _modelMat;
-	cb.projectionMat = camera.GetProjectionMat();
-	cb.viewMat = camera.GetViewMat();
-	cb.normalMat = DirectX::XMMatrixTranspose(DirectX::XMMatrixInverse(
-		nullptr, 
-		DirectX::XMMatrixMultiply(_modelMat, camera.GetViewMat())
-	));
+	cb.modelMat = _model.GetTransformation();
+	cb.projectionMat = _frame.GetProjection();
+	cb.viewMat = _frame.GetView();
+
+	// inverse(model * view) is inverse(view) * inverse(model), both already cached
+	cb.normalMat = DirectX::XMMatrixTranspose(DirectX::XMMatrixMultiply(_frame.GetInverseView(), _model.GetInverseTransformation()));
 
 	SURF_CBUFFERDATA_PS cb1;
 	ZeroMemory(&cb1, sizeof(cb1));
 	cb1.color = DirectX::XMLoadFloat4(&m_color);
 	cb1.metallic = m_metallic;
 	cb1.roughness = m_roughness;
-	cb1.worldScale = camera.GetScale().x;
+	cb1.worldScale = _frame.GetScale().x;
 
 	D3D11_MAPPED_SUBRESOURCE ms1;
 	ZeroMemory(&ms1, sizeof(ms1));
@@ -219,22 +239,22 @@ HRESULT FlatShader::LoadFromFile(LPCWSTR _fName, ID3D11Device* _pDevice, ID3D11D
 	return hr;
 }
 
-void FlatShader::SetBuffers(ID3D11DeviceContext* _pContext, Camera& camera, DirectX::XMMATRIX _modelMat, uint32_t flags) {
+void FlatShader::SetBuffers(ID3D11DeviceContext* _pContext, const CameraFrame& _frame, const Transform& _model, uint32_t flags) {
 	FLAT_CBUFFERDATA_VS cb1;
 	ZeroMemory(&cb1, sizeof(cb1));
-	cb1.modelMat = _modelMat;
+	cb1.modelMat = _model.GetTransformation();
 	if (flags & SHADER_FLAGS_FLAT_NO_PROJECT) {
 		cb1.viewMat = DirectX::XMMatrixIdentity();
 		cb1.projectionMat = DirectX::XMMatrixIdentity();
 	}
 	else {
-		cb1.viewMat = camera.GetViewMat();
-		cb1.projectionMat = camera.GetProjectionMat();
+		cb1.viewMat = _frame.GetView();
+		cb1.projectionMat = _frame.GetProjection();
 	}
 
 	FLAT_CBUFFERDATA_PS cb2;
 	ZeroMemory(&cb2, sizeof(cb2));
-	cb2.worldScale = camera.GetScale().x;
+	cb2.worldScale = _frame.GetScale().x;
 	cb2.color = DirectX::XMLoadFloat4(&m_color);
 
 	D3D11_MAPPED_SUBRESOURCE ms1;
@@ -247,6 +267,68 @@ void FlatShader::SetBuffers(ID3D11DeviceContext* _pContext, Camera& camera, Dire
 	memcpy(ms2.pData, &cb2, sizeof(cb2));
 	_pContext->Unmap(m_psCbuffer.Get(), 0);
 
+	_pContext->VSSetConstantBuffers(0, 1, m_vsCbuffer.GetAddressOf());
+	_pContext->PSSetConstantBuffers(0, 1, m_psCbuffer.GetAddressOf());
+}
+
+// --------- class PointShader
+
+PointShader::PointShader(DirectX::XMFLOAT4 _color, float _pointSize) : Shader(_color), m_pointSize(_pointSize) {}
+
+HRESULT PointShader::LoadFromFile(LPCWSTR _fName, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) {
+	HRESULT hr = S_OK;
+
+	// everything is per instance, the corners of the quad come from SV_VertexID
+	D3D11_INPUT_ELEMENT_DESC* ied = new D3D11_INPUT_ELEMENT_DESC[2]{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+	};
+
+	hr = CompileAndSetLayout(_fName, _pDevice, _pContext, ied, 2);
+	delete[] ied;
+	if (FAILED(hr)) return hr;
+
+	D3D11_BUFFER_DESC bd1;
+	ZeroMemory(&bd1, sizeof(bd1));
+	bd1.ByteWidth = sizeof(POINT_CBUFFERDATA_VS);
+	bd1.Usage = D3D11_USAGE_DYNAMIC;
+	bd1.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	bd1.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+	D3D11_BUFFER_DESC bd2;
+	bd2 = bd1;
+	bd2.ByteWidth = sizeof(FLAT_CBUFFERDATA_PS);
+
+	hr = _pDevice->CreateBuffer(&bd1, nullptr, m_vsCbuffer.ReleaseAndGetAddressOf());	if (FAILED(hr)) return hr;
+	hr = _pDevice->CreateBuffer(&bd2, nullptr, m_psCbuffer.ReleaseAndGetAddressOf());	if (FAILED(hr)) return hr;
+
+	return hr;
+}
+
+void PointShader::SetBuffers(ID3D11DeviceContext* _pContext, const CameraFrame& _frame, const Transform& _model, uint32_t flags) {
+	POINT_CBUFFERDATA_VS cb1;
+	ZeroMemory(&cb1, sizeof(cb1));
+	cb1.modelMat = _model.GetTransformation();
+	cb1.viewMat = _frame.GetView();
+	cb1.projectionMat = _frame.GetProjection();
+	cb1.viewportSize = _frame.GetViewportSize();
+	cb1.pointSize = m_pointSize;
+
+	FLAT_CBUFFERDATA_PS cb2;
+	ZeroMemory(&cb2, sizeof(cb2));
+	cb2.worldScale = _frame.GetScale().x;
+	cb2.color = DirectX::XMLoadFloat4(&m_color);
+
+	D3D11_MAPPED_SUBRESOURCE ms1;
+	ThrowIfFailed(_pContext->Map(m_vsCbuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, NULL, &ms1));
+	memcpy(ms1.pData, &cb1, sizeof(cb1));
+	_pContext->Unmap(m_vsCbuffer.Get(), 0);
+
+	D3D11_MAPPED_SUBRESOURCE ms2;
+	ThrowIfFailed(_pContext->Map(m_psCbuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, NULL, &ms2));
+	memcpy(ms2.pData, &cb2, sizeof(cb2));
+	_pContext->Unmap(m_psCbuffer.Get(), 0);
+
 	_pContext->VSSetConstantBuffers(0, 1, m_vsCbuffer.GetAddressOf());
 	_pContext->PSSetConstantBuffers(0, 1, m_psCbuffer.GetAddressOf());
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <combaseapi.h>
 #include <wincodec.h>
 
+#include <algorithm>
 #include <numeric>
 
 using namespace Cass;
@@ -127,11 +128,43 @@ Microsoft::WRL::ComPtr <IWICImagingFactory> Texture::s_factory = NULL;
 Texture::Texture(D3D11_FILTER _filtering, D3D11_TEXTURE_ADDRESS_MODE _addressMode, DirectX::XMFLOAT4 _borderColor, size_t _width, size_t _height) {
 	m_width = _width;
 	m_height = _height;
+	m_hasMips = false;
 	m_filtering = _filtering;
 	m_addressMode = _addressMode;
 	m_borderColor = _borderColor;
 }
 
+size_t Texture::GetByteSize() const {
+	if (!m_texture) return 0;
+
+	D3D11_TEXTURE2D_DESC desc;
+	m_texture->GetDesc(&desc);
+
+	size_t texelSize;
+	switch (desc.Format) {
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:	texelSize = 16; break;
+	case DXGI_FORMAT_R32G32B32_FLOAT:		texelSize = 12; break;
+	case DXGI_FORMAT_R16G16B16A16_FLOAT:
+	case DXGI_FORMAT_R16G16B16A16_UNORM:	texelSize = 8; break;
+	case DXGI_FORMAT_R16_FLOAT:
+	case DXGI_FORMAT_R16_UNORM:
+	case DXGI_FORMAT_B5G5R5A1_UNORM:
+	case DXGI_FORMAT_B5G6R5_UNORM:			texelSize = 2; break;
+	case DXGI_FORMAT_R8_UNORM:
+	case DXGI_FORMAT_A8_UNORM:				texelSize = 1; break;
+	default:								texelSize = 4; break;
+	}
+
+	size_t size = 0, width = desc.Width, height = desc.Height;
+	for (UINT i = 0; i < std::max(desc.MipLevels, 1U); i++) {
+		size += width * height * texelSize;
+		width = std::max(width / 2, size_t(1));
+		height = std::max(height / 2, size_t(1));
+	}
+
+	return size * desc.ArraySize;
+}
+
 DXGI_FORMAT Texture::WICToDXGI(const GUID& guid) {
 	for (SIZE_T i = 0; i < _countof(WICFormats); i++) {
 		if (memcmp(&WICFormats[i], &guid, sizeof(GUID)) == 0) {
@@ -214,7 +247,7 @@ HRESULT Texture::LoadFromFile(LPCWSTR _fileName, ID3D11Device* _pDevice, ID3D11D
 
 HRESULT Texture::LoadFromMemory(
 	uint32_t _width, uint32_t _height, const std::vector<uint8_t> &colorData, 
-	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+	ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext, bool _generateMips
 ) {
 	if (!_pDevice || !_pContext || colorData.size() < 4) return E_INVALIDARG;
 #ifdef _M_ADM64
@@ -230,14 +263,14 @@ HRESULT Texture::LoadFromMemory(
 	td.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 	td.Width = _width;
 	td.Height = _height;
-	td.MipLevels = 0;
+	td.MipLevels = _generateMips ? 0 : 1;
 	td.ArraySize = 1;
 	td.SampleDesc.Count = 1;
 	td.SampleDesc.Quality = 0;
 	td.Usage = D3D11_USAGE_DEFAULT;
-	td.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+	td.BindFlags = _generateMips ? (D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET) : D3D11_BIND_SHADER_RESOURCE;
 	td.CPUAccessFlags = NULL;
-	td.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+	td.MiscFlags = _generateMips ? D3D11_RESOURCE_MISC_GENERATE_MIPS : NULL;
 
 	hr = _pDevice->CreateTexture2D(&td, nullptr, m_texture.ReleaseAndGetAddressOf());
 	if (FAILED(hr)) return hr;
@@ -246,7 +279,7 @@ HRESULT Texture::LoadFromMemory(
 	ZeroMemory(&srvd, sizeof(srvd));
 	srvd.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 	srvd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-	srvd.Texture2D.MipLevels = -1;
+	srvd.Texture2D.MipLevels = _generateMips ? -1 : 1;
 
 	hr = _pDevice->CreateShaderResourceView(m_texture.Get(), &srvd, m_SRV.ReleaseAndGetAddressOf());
 	if (FAILED(hr)) {
@@ -257,7 +290,8 @@ HRESULT Texture::LoadFromMemory(
 	// Generate Mips
 	assert(_pContext != nullptr);
 	_pContext->UpdateSubresource(m_texture.Get(), 0, nullptr, colorData.data(), static_cast <UINT> (rowPitch), static_cast <UINT> (imageSize));
-	_pContext->GenerateMips(m_SRV.Get());
+	if (_generateMips) _pContext->GenerateMips(m_SRV.Get());
+	m_hasMips = _generateMips;
 
 	D3D11_SAMPLER_DESC sd;
 	ZeroMemory(&sd, sizeof(sd));
@@ -285,6 +319,28 @@ HRESULT Texture::LoadFromMemory(
 	return hr;
 }
 
+HRESULT Texture::UpdateFromMemory(
+	uint32_t _x, uint32_t _y, uint32_t _width, uint32_t _height, const uint8_t* _colorData, uint32_t _rowPitch,
+	ID3D11DeviceContext* _pContext
+) {
+	if (!_pContext || !_colorData || !m_texture) return E_INVALIDARG;
+	if (static_cast <size_t> (_x) + _width > m_width || static_cast <size_t> (_y) + _height > m_height) return E_INVALIDARG;
+	if (_width == 0 || _height == 0) return S_OK;
+
+	D3D11_BOX box;
+	box.left = _x;
+	box.top = _y;
+	box.front = 0;
+	box.right = _x + _width;
+	box.bottom = _y + _height;
+	box.back = 1;
+
+	_pContext->UpdateSubresource(m_texture.Get(), 0, &box, _colorData, _rowPitch, 0);
+	if (m_hasMips) _pContext->GenerateMips(m_SRV.Get());
+
+	return S_OK;
+}
+
 // Protected methods
 
 HRESULT Texture::CreateTextureFromWIC(ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext, IWICBitmapFrameDecode* _pFrame) {
@@ -507,6 +563,7 @@ HRESULT Texture::CreateTextureFromWIC(ID3D11Device* _pDevice, ID3D11DeviceContex
 
 	m_width = tWidth;
 	m_height = tHeight;
+	m_hasMips = autogen;
 
 	return hr;
 }
\ No newline at end of file
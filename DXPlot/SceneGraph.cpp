@@ -0,0 +1,296 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <SceneGraph.hpp>
+#include <util.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+using namespace Cass;
+
+namespace {
+	// nodes of one level handed to a separate thread
+	const size_t s_minBlock = 4096;
+
+	const DirectX::XMFLOAT4X4 s_identity = {
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+}
+
+//
+// ---------- class SceneGraph
+//
+
+SceneGraph::SceneGraph() {
+	m_orderValid = true;
+	m_nodeCount = 0;
+	m_dirtyCount = m_updatedCount = 0;
+	m_minDirtyDepth = s_nullNode;
+}
+
+uint32_t SceneGraph::AddNode(uint32_t _parent) {
+	uint32_t parentSlot = _parent == s_nullNode ? s_nullNode : GetSlot(_parent);
+	uint32_t depth = parentSlot == s_nullNode ? 0 : m_depth[parentSlot] + 1;
+
+	uint32_t node;
+	if (!m_freeIds.empty()) {
+		node = m_freeIds.back();
+		m_freeIds.pop_back();
+	}
+	else {
+		node = static_cast <uint32_t> (m_slotOf.size());
+		m_slotOf.push_back(s_nullNode);
+	}
+
+	uint32_t slot = static_cast <uint32_t> (m_nodeOf.size());
+	m_slotOf[node] = slot;
+	m_nodeOf.push_back(node);
+	m_parentSlot.push_back(parentSlot);
+	m_depth.push_back(depth);
+	m_positions.push_back({ 0.0f, 0.0f, 0.0f });
+	m_rotations.push_back({ 0.0f, 0.0f, 0.0f, 1.0f });
+	m_scales.push_back({ 1.0f, 1.0f, 1.0f });
+	m_world.push_back(s_identity);
+	m_dirty.push_back(0);
+	m_updated.push_back(0);
+	m_nodeCount++;
+
+	// appending to the deepest level or starting the next one keeps the order, anything else waits for a sort
+	if (m_orderValid) {
+		size_t levelCount = m_levelStarts.empty() ? 0 : m_levelStarts.size() - 1;
+		if (levelCount > 0 && depth == levelCount - 1) {
+			m_levelStarts.back() = slot + 1;
+		}
+		else if (depth == levelCount) {
+			if (m_levelStarts.empty()) m_levelStarts.push_back(slot);
+			m_levelStarts.push_back(slot + 1);
+		}
+		else {
+			m_orderValid = false;
+		}
+	}
+
+	MarkDirty(slot);
+	return node;
+}
+
+void SceneGraph::RemoveNode(uint32_t _node) {
+	GetSlot(_node);
+	if (!m_orderValid) Sort();
+
+	// parents come before their children, a single pass from the node on finds the whole subtree
+	uint32_t first = m_slotOf[_node];
+	std::vector <uint8_t> removed(m_nodeOf.size() - first, 0);
+	removed[0] = 1;
+	for (size_t i = first + 1; i < m_nodeOf.size(); i++) {
+		uint32_t parent = m_parentSlot[i];
+		if (parent != s_nullNode && parent >= first && removed[parent - first]) removed[i - first] = 1;
+	}
+
+	for (size_t i = first; i < m_nodeOf.size(); i++) {
+		if (!removed[i - first]) continue;
+
+		m_slotOf[m_nodeOf[i]] = s_nullNode;
+		m_freeIds.push_back(m_nodeOf[i]);
+		m_nodeOf[i] = s_nullNode;
+		if (m_dirty[i]) {
+			m_dirty[i] = 0;
+			m_dirtyCount--;
+		}
+		m_nodeCount--;
+	}
+
+	m_orderValid = false;
+}
+
+void SceneGraph::SetParent(uint32_t _node, uint32_t _parent) {
+	uint32_t slot = GetSlot(_node);
+	uint32_t parentSlot = _parent == s_nullNode ? s_nullNode : GetSlot(_parent);
+
+	for (uint32_t ancestor = parentSlot; ancestor != s_nullNode; ancestor = m_parentSlot[ancestor]) {
+		if (ancestor == slot) throw std::invalid_argument("Node can't be moved below its own subtree");
+	}
+
+	m_parentSlot[slot] = parentSlot;
+	MarkDirty(slot);
+
+	// the depths of the subtree change, they're worked out again by the next sort
+	m_orderValid = false;
+}
+
+uint32_t SceneGraph::GetParent(uint32_t _node) const {
+	uint32_t parent = m_parentSlot[GetSlot(_node)];
+	return parent == s_nullNode ? s_nullNode : m_nodeOf[parent];
+}
+
+void SceneGraph::SetLocal(uint32_t _node, DirectX::XMFLOAT3 _position, DirectX::XMFLOAT4 _rotation, DirectX::XMFLOAT3 _scale) {
+	uint32_t slot = GetSlot(_node);
+	if (memcmp(&m_positions[slot], &_position, sizeof(_position)) == 0 && memcmp(&m_rotations[slot], &_rotation, sizeof(_rotation)) == 0 &&
+		memcmp(&m_scales[slot], &_scale, sizeof(_scale)) == 0) return;
+
+	m_positions[slot] = _position;
+	m_rotations[slot] = _rotation;
+	m_scales[slot] = _scale;
+	MarkDirty(slot);
+}
+
+void SceneGraph::SetPosition(uint32_t _node, DirectX::XMFLOAT3 _position) {
+	uint32_t slot = GetSlot(_node);
+	m_positions[slot] = _position;
+	MarkDirty(slot);
+}
+
+void SceneGraph::SetRotation(uint32_t _node, DirectX::XMFLOAT4 _rotation) {
+	uint32_t slot = GetSlot(_node);
+	m_rotations[slot] = _rotation;
+	MarkDirty(slot);
+}
+
+void SceneGraph::SetScale(uint32_t _node, DirectX::XMFLOAT3 _scale) {
+	uint32_t slot = GetSlot(_node);
+	m_scales[slot] = _scale;
+	MarkDirty(slot);
+}
+
+size_t SceneGraph::Update() {
+	if (!m_orderValid) Sort();
+
+	if (m_updatedCount > 0) {
+		memset(m_updated.data(), 0, m_updated.size());
+		m_updatedCount = 0;
+	}
+	if (m_dirtyCount == 0) return 0;
+
+	// a node is recomputed if it changed itself or its parent was recomputed on the level above
+	std::atomic <size_t> updated(0), cleared(0);
+	for (size_t depth = m_minDirtyDepth; depth + 1 < m_levelStarts.size(); depth++) {
+		std::atomic <size_t> levelUpdated(0);
+
+		ParallelFor(m_levelStarts[depth], m_levelStarts[depth + 1], [&](size_t _first, size_t _last) {
+			size_t count = 0, clearedCount = 0;
+			for (size_t i = _first; i < _last; i++) {
+				uint32_t parent = m_parentSlot[i];
+				if (!m_dirty[i] && (parent == s_nullNode || !m_updated[parent])) continue;
+
+				DirectX::XMMATRIX world = DirectX::XMMatrixMultiply(
+					DirectX::XMMatrixMultiply(
+						DirectX::XMMatrixScaling(m_scales[i].x, m_scales[i].y, m_scales[i].z),
+						DirectX::XMMatrixRotationQuaternion(DirectX::XMLoadFloat4(&m_rotations[i]))
+					),
+					DirectX::XMMatrixTranslation(m_positions[i].x, m_positions[i].y, m_positions[i].z)
+				);
+				if (parent != s_nullNode) world = DirectX::XMMatrixMultiply(world, DirectX::XMLoadFloat4x4(&m_world[parent]));
+				DirectX::XMStoreFloat4x4(&m_world[i], world);
+
+				if (m_dirty[i]) clearedCount++;
+				m_dirty[i] = 0;
+				m_updated[i] = 1;
+				count++;
+			}
+
+			levelUpdated += count;
+			cleared += clearedCount;
+		}, s_minBlock);
+
+		updated += levelUpdated;
+
+		// nothing left to pass down and no changed node further below
+		if (levelUpdated == 0 && cleared == m_dirtyCount) break;
+	}
+
+	m_dirtyCount = 0;
+	m_minDirtyDepth = s_nullNode;
+	m_updatedCount = updated;
+
+	return m_updatedCount;
+}
+
+uint32_t SceneGraph::GetSlot(uint32_t _node) const {
+	if (_node >= m_slotOf.size() || m_slotOf[_node] == s_nullNode) throw std::invalid_argument("Not a node of this graph");
+	return m_slotOf[_node];
+}
+
+void SceneGraph::MarkDirty(uint32_t _slot) {
+	if (m_dirty[_slot]) return;
+
+	m_dirty[_slot] = 1;
+	m_dirtyCount++;
+	m_minDirtyDepth = std::min(m_minDirtyDepth, m_depth[_slot]);
+}
+
+void SceneGraph::Sort() {
+	size_t count = m_nodeOf.size();
+
+	// depths from the parent links, walking up to the first ancestor already known
+	std::vector <uint32_t> depth(count, s_nullNode), path;
+	uint32_t maxDepth = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (m_nodeOf[i] == s_nullNode || depth[i] != s_nullNode) continue;
+
+		uint32_t slot = static_cast <uint32_t> (i);
+		while (slot != s_nullNode && depth[slot] == s_nullNode) {
+			path.push_back(slot);
+			slot = m_parentSlot[slot];
+		}
+
+		uint32_t d = slot == s_nullNode ? 0 : depth[slot] + 1;
+		for (size_t j = path.size(); j-- > 0; d++) depth[path[j]] = d;
+		maxDepth = std::max(maxDepth, d - 1);
+		path.clear();
+	}
+
+	// counting sort by depth, stable within a level
+	m_levelStarts.assign(m_nodeCount > 0 ? maxDepth + 2 : 0, 0);
+	for (size_t i = 0; i < count; i++) {
+		if (m_nodeOf[i] != s_nullNode) m_levelStarts[depth[i] + 1]++;
+	}
+	for (size_t d = 1; d < m_levelStarts.size(); d++) m_levelStarts[d] += m_levelStarts[d - 1];
+
+	std::vector <uint32_t> newSlot(count, s_nullNode);
+	std::vector <size_t> next(m_levelStarts);
+	for (size_t i = 0; i < count; i++) {
+		if (m_nodeOf[i] != s_nullNode) newSlot[i] = static_cast <uint32_t> (next[depth[i]]++);
+	}
+
+	auto permute = [&](auto& _array) {
+		std::remove_reference_t <decltype(_array)> sorted(m_nodeCount);
+		for (size_t i = 0; i < count; i++) {
+			if (newSlot[i] != s_nullNode) sorted[newSlot[i]] = _array[i];
+		}
+		_array.swap(sorted);
+	};
+
+	permute(m_nodeOf);
+	permute(m_parentSlot);
+	permute(m_positions);
+	permute(m_rotations);
+	permute(m_scales);
+	permute(m_world);
+	permute(m_dirty);
+	permute(m_updated);
+
+	m_depth.resize(m_nodeCount);
+	for (size_t d = 0; d + 1 < m_levelStarts.size(); d++) {
+		std::fill(m_depth.begin() + m_levelStarts[d], m_depth.begin() + m_levelStarts[d + 1], static_cast <uint32_t> (d));
+	}
+
+	m_minDirtyDepth = s_nullNode;
+	m_updatedCount = 0;
+	for (size_t i = 0; i < m_nodeCount; i++) {
+		if (m_parentSlot[i] != s_nullNode) m_parentSlot[i] = newSlot[m_parentSlot[i]];
+		m_slotOf[m_nodeOf[i]] = static_cast <uint32_t> (i);
+
+		if (m_dirty[i]) m_minDirtyDepth = std::min(m_minDirtyDepth, m_depth[i]);
+		if (m_updated[i]) m_updatedCount++;
+	}
+
+	m_orderValid = true;
+}
\ No newline at end of file
@@ -6,78 +6,190 @@
 using namespace Cass;
 
 Transform::Transform() {
-	m_transformation = DirectX::XMMatrixIdentity();
+	m_position = { 0.0f, 0.0f, 0.0f };
+	m_rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+	m_scale = { 1.0f, 1.0f, 1.0f };
+	DirectX::XMStoreFloat4x4(&m_parent, DirectX::XMMatrixIdentity());
+	m_hasParent = false;
+
+	m_transformation = m_inverse = DirectX::XMMatrixIdentity();
+	m_worldLb = m_worldUb = { 0.0f, 0.0f, 0.0f };
+	m_matrixDirty = m_inverseDirty = false;
+	m_boundsDirty = true;
+	m_version = 0;
+
+	m_pChangeQueue = nullptr;
+	m_changeKey = 0;
+	m_changeQueued = false;
 }
 
-Transform::~Transform() { }
+Transform::Transform(const Transform& _other) {
+	CopyFrom(_other);
+	m_version = _other.m_version;
 
-DirectX::XMFLOAT3 Transform::GetPosition() const {
-	DirectX::XMVECTOR pos, t_rot, t_scale;
-	DirectX::XMFLOAT3 res;
+	// the copy isn't part of whatever watches the original, it would report changes under the original's key
+	m_pChangeQueue = nullptr;
+	m_changeKey = 0;
+	m_changeQueued = false;
+}
 
-	DirectX::XMMatrixDecompose(&t_scale, &t_rot, &pos, m_transformation);
-	DirectX::XMStoreFloat3(&res, pos);
+Transform& Transform::operator = (const Transform& _other) {
+	if (this == &_other) return *this;
 
-	return res;
-}
+	// the watch stays, the new transformation is reported as a change of this object
+	CopyFrom(_other);
+	Changed();
 
-DirectX::XMFLOAT4 Transform::GetRotationQuat() const {
-	DirectX::XMVECTOR t_pos, rot, t_scale;
-	DirectX::XMFLOAT4 res;
+	return *this;
+}
 
-	DirectX::XMMatrixDecompose(&t_scale, &rot, &t_pos, m_transformation);
-	DirectX::XMStoreFloat4(&res, rot);
+Transform::~Transform() { }
 
-	return res;
+void Transform::CopyFrom(const Transform& _other) {
+	m_bounds = _other.m_bounds;
+
+	m_position = _other.m_position;
+	m_rotation = _other.m_rotation;
+	m_scale = _other.m_scale;
+	m_parent = _other.m_parent;
+	m_hasParent = _other.m_hasParent;
+
+	m_transformation = _other.m_transformation;
+	m_inverse = _other.m_inverse;
+	m_worldLb = _other.m_worldLb;
+	m_worldUb = _other.m_worldUb;
+	m_matrixDirty = _other.m_matrixDirty;
+	m_inverseDirty = _other.m_inverseDirty;
+	m_boundsDirty = _other.m_boundsDirty;
 }
 
 DirectX::XMFLOAT3 Transform::GetRotationEuler() const {
-	DirectX::XMVECTOR t_pos, rot, t_scale, res_vec;
+	DirectX::XMVECTOR res_vec;
 	DirectX::XMFLOAT3 res;
 	float rot_angle;
 
-	DirectX::XMMatrixDecompose(&t_scale, &rot, &t_pos, m_transformation);
-	DirectX::XMQuaternionToAxisAngle(&res_vec, &rot_angle, rot);
+	DirectX::XMQuaternionToAxisAngle(&res_vec, &rot_angle, DirectX::XMLoadFloat4(&m_rotation));
 	DirectX::XMStoreFloat3(&res, res_vec);
 
 	return DirectX::XMFLOAT3{ res.x * rot_angle * Math::_180_P, res.y * rot_angle * Math::_180_P, res.z * rot_angle * Math::_180_P };
 }
 
-DirectX::XMFLOAT3 Transform::GetScale() const {
-	DirectX::XMVECTOR t_pos, t_rot, scale;
-	DirectX::XMFLOAT3 res;
+DirectX::XMMATRIX Transform::GetTransformation() const {
+	if (m_matrixDirty) {
+		m_transformation = DirectX::XMMatrixMultiply(
+			DirectX::XMMatrixMultiply(
+				DirectX::XMMatrixScaling(m_scale.x, m_scale.y, m_scale.z),
+				DirectX::XMMatrixRotationQuaternion(DirectX::XMLoadFloat4(&m_rotation))
+			),
+			DirectX::XMMatrixTranslation(m_position.x, m_position.y, m_position.z)
+		);
+		if (m_hasParent) m_transformation = DirectX::XMMatrixMultiply(m_transformation, DirectX::XMLoadFloat4x4(&m_parent));
+		m_matrixDirty = false;
+	}
+
+	return m_transformation;
+}
 
-	DirectX::XMMatrixDecompose(&scale, &t_rot, &t_pos, m_transformation);
-	DirectX::XMStoreFloat3(&res, scale);
+DirectX::XMMATRIX Transform::GetInverseTransformation() const {
+	if (m_inverseDirty) {
+		m_inverse = DirectX::XMMatrixInverse(nullptr, GetTransformation());
+		m_inverseDirty = false;
+	}
 
-	return res;
+	return m_inverse;
+}
+
+void Transform::SetParentTransformation(DirectX::FXMMATRIX _parent) {
+	DirectX::XMStoreFloat4x4(&m_parent, _parent);
+	m_hasParent = !DirectX::XMMatrixIsIdentity(_parent);
+
+	m_matrixDirty = m_inverseDirty = true;
+	Changed();
 }
 
 void Transform::ResetTransform() {
-	m_transformation = DirectX::XMMatrixIdentity();
+	m_position = { 0.0f, 0.0f, 0.0f };
+	m_rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+	m_scale = { 1.0f, 1.0f, 1.0f };
+
+	m_matrixDirty = m_inverseDirty = true;
+	Changed();
 }
 
 void Transform::Translate(DirectX::XMFLOAT3 _offset) {
-	m_transformation = DirectX::XMMatrixMultiply(
-		m_transformation,
-		DirectX::XMMatrixTranslation(_offset.x, _offset.y, _offset.z)
-	);
+	m_position = Math::XMFloat3Add(m_position, _offset);
+
+	m_matrixDirty = m_inverseDirty = true;
+	Changed();
+}
+
+void Transform::SetPosition(DirectX::XMFLOAT3 _position) {
+	m_position = _position;
+
+	m_matrixDirty = m_inverseDirty = true;
+	Changed();
 }
 
 void Transform::Rotate(DirectX::XMFLOAT3 _axis, float _angleEuler) {
-	m_transformation = DirectX::XMMatrixMultiply(
-		DirectX::XMMatrixRotationAxis(DirectX::XMLoadFloat3(&_axis), _angleEuler * Math::PI_180),
-		m_transformation
-	);
+	DirectX::XMVECTOR rotation = DirectX::XMQuaternionRotationAxis(DirectX::XMLoadFloat3(&_axis), _angleEuler * Math::PI_180);
+
+	// renormalized so that many small rotations don't drift away from a unit quaternion
+	DirectX::XMStoreFloat4(&m_rotation, DirectX::XMQuaternionNormalize(
+		DirectX::XMQuaternionMultiply(rotation, DirectX::XMLoadFloat4(&m_rotation))
+	));
+
+	m_matrixDirty = m_inverseDirty = true;
+	Changed();
 }
 
 void Transform::Scale(DirectX::XMFLOAT3 _axis) {
-	m_transformation = DirectX::XMMatrixMultiply(
-		DirectX::XMMatrixScaling(_axis.x, _axis.y, _axis.z),
-		m_transformation
-	);
+	m_scale = { m_scale.x * _axis.x, m_scale.y * _axis.y, m_scale.z * _axis.z };
+
+	m_matrixDirty = m_inverseDirty = true;
+	Changed();
 }
 
 int Transform::IntersectBox(const Ray& ray) const {
 	return m_bounds.Intersect(ray);
+}
+
+void Transform::GetWorldBounds(DirectX::XMFLOAT3& _oLb, DirectX::XMFLOAT3& _oUb) const {
+	if (m_boundsDirty) {
+		DirectX::XMFLOAT3 center = m_bounds.GetPosition(), dims = m_bounds.GetDimensions();
+		DirectX::XMMATRIX transformation = GetTransformation();
+
+		// the transformed center, and the half extents summed over the absolute rows of the matrix
+		DirectX::XMVECTOR worldCenter = DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&center), transformation);
+		DirectX::XMVECTOR extent = DirectX::XMVectorMultiply(DirectX::XMVectorAbs(transformation.r[0]), DirectX::XMVectorReplicate(0.5f * dims.x));
+		extent = DirectX::XMVectorMultiplyAdd(DirectX::XMVectorAbs(transformation.r[1]), DirectX::XMVectorReplicate(0.5f * dims.y), extent);
+		extent = DirectX::XMVectorMultiplyAdd(DirectX::XMVectorAbs(transformation.r[2]), DirectX::XMVectorReplicate(0.5f * dims.z), extent);
+
+		DirectX::XMStoreFloat3(&m_worldLb, DirectX::XMVectorSubtract(worldCenter, extent));
+		DirectX::XMStoreFloat3(&m_worldUb, DirectX::XMVectorAdd(worldCenter, extent));
+		m_boundsDirty = false;
+	}
+
+	_oLb = m_worldLb;
+	_oUb = m_worldUb;
+}
+
+void Transform::WatchChanges(std::vector <uint64_t>* _pQueue, uint64_t _key) {
+	m_pChangeQueue = _pQueue;
+	m_changeKey = _key;
+	m_changeQueued = false;
+}
+
+void Transform::SetBounds(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub) {
+	m_bounds.Calculate(_lb, _ub);
+	Changed();
+}
+
+void Transform::Changed() {
+	m_version++;
+	m_boundsDirty = true;
+
+	if (m_pChangeQueue && !m_changeQueued) {
+		m_pChangeQueue->push_back(m_changeKey);
+		m_changeQueued = true;
+	}
 }
\ No newline at end of file
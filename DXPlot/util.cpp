@@ -1,8 +1,39 @@
 #include <util.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdarg>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <sstream>
 
+// instruction set of the Cass::Math kernels, AVX2 needs /arch:AVX2, scalar code stands in where there's no SSE2
+#if !defined(_XM_NO_INTRINSICS_) && defined(__AVX2__)
+#define CASS_MATH_AVX2 1
+#define CASS_MATH_SSE2 1
+#elif !defined(_XM_NO_INTRINSICS_) && (defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__))
+#define CASS_MATH_AVX2 0
+#define CASS_MATH_SSE2 1
+#else
+#define CASS_MATH_AVX2 0
+#define CASS_MATH_SSE2 0
+#endif
+
+#if CASS_MATH_AVX2
+#include <immintrin.h>
+#elif CASS_MATH_SSE2
+#include <emmintrin.h>
+#endif
+
+// the backends only agree to the bit while every a * b + c is rounded twice, /arch:AVX2 would otherwise let the
+// compiler fuse them; GCC has no pragma for it and needs -ffp-contract=off
+#if defined(__clang__)
+#pragma clang fp contract (off)
+#elif defined(_MSC_VER)
+#pragma fp_contract (off)
+#endif
+
 const char* Cass::ComException::what() const {
 	std::ostringstream ss;
 	ss << "Faliure, HRESULT : " << std::hex << result;
@@ -71,4 +102,475 @@ RECT Cass::GetAbsoluteClientRect(HWND hWnd) {
 	rc.bottom = temp.y;
 
 	return rc;
+}
+
+// ---------- WorkerPool
+
+Cass::WorkerPool& Cass::WorkerPool::Get() {
+	// never destroyed, the workers are blocked waiting when the process ends and must not be joined from exit
+	static WorkerPool* s_pool = new WorkerPool();
+	return *s_pool;
+}
+
+Cass::WorkerPool::WorkerPool() {
+	// the calling thread of each Run is the remaining one
+	unsigned hc = std::thread::hardware_concurrency();
+	size_t workerCount = hc > 1 ? hc - 1 : 0;
+
+	m_threads.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; i++) m_threads.emplace_back([this]() { WorkerLoop(); });
+}
+
+void Cass::WorkerPool::Run(size_t _count, const std::function <void(size_t)>& _task) {
+	if (_count == 0) return;
+
+	Batch batch;
+	batch.task = &_task;
+	batch.count = _count;
+	batch.next = 0;
+	batch.helpers = 0;
+
+	{
+		std::lock_guard <std::mutex> lock(m_mutex);
+		m_batches.push_back(&batch);
+	}
+	m_wake.notify_all();
+
+	Work(batch);
+
+	// every task is handed out, the batch only lives on until the workers still on it are through
+	std::unique_lock <std::mutex> lock(m_mutex);
+	auto it = std::find(m_batches.begin(), m_batches.end(), &batch);
+	if (it != m_batches.end()) m_batches.erase(it);
+	m_done.wait(lock, [&batch]() { return batch.helpers == 0; });
+
+	if (batch.error) std::rethrow_exception(batch.error);
+}
+
+void Cass::WorkerPool::WorkerLoop() {
+	std::unique_lock <std::mutex> lock(m_mutex);
+	for (;;) {
+		m_wake.wait(lock, [this]() { return !m_batches.empty(); });
+
+		Batch& batch = *m_batches.front();
+		batch.helpers++;
+
+		lock.unlock();
+		Work(batch);
+		lock.lock();
+
+		// a batch is dropped by whoever finds it out of tasks first, its caller waits for the last helper
+		if (!m_batches.empty() && m_batches.front() == &batch) m_batches.pop_front();
+		if (--batch.helpers == 0) m_done.notify_all();
+	}
+}
+
+void Cass::WorkerPool::Work(Batch& _batch) {
+	for (size_t i = _batch.next++; i < _batch.count; i = _batch.next++) {
+		try {
+			(*_batch.task)(i);
+		}
+		catch (...) {
+			std::lock_guard <std::mutex> lock(m_mutex);
+			if (!_batch.error) _batch.error = std::current_exception();
+
+			// the remaining tasks are skipped
+			_batch.next = _batch.count;
+		}
+	}
+}
+
+// ---------- Math
+
+namespace {
+	/*
+	* the kernels below are written once against these lane types, each wraps one instruction set
+	* all of them expose the same static functions over Float (the values), Int (32 bit integers) and Mask (per lane conditions)
+	*/
+
+	struct ScalarLanes {
+		using Float = float;
+		using Int = int32_t;
+		using Mask = bool;
+		static constexpr size_t s_width = 1;
+
+		static Float Load(const float* _p) { return *_p; }
+		static void Store(float* _p, Float _v) { *_p = _v; }
+		static Float Set(float _v) { return _v; }
+		static Int SetInt(int32_t _v) { return _v; }
+
+		static Float Add(Float _a, Float _b) { return _a + _b; }
+		static Float Sub(Float _a, Float _b) { return _a - _b; }
+		static Float Mul(Float _a, Float _b) { return _a * _b; }
+		static Float Div(Float _a, Float _b) { return _a / _b; }
+		static Float Sqrt(Float _v) { return std::sqrt(_v); }
+		static Float Min(Float _a, Float _b) { return _b < _a ? _b : _a; }
+		static Float Max(Float _a, Float _b) { return _b > _a ? _b : _a; }
+		static Float Abs(Float _v) { return std::fabs(_v); }
+
+		static Mask Less(Float _a, Float _b) { return _a < _b; }
+		static Mask Greater(Float _a, Float _b) { return _a > _b; }
+		static Mask Equal(Float _a, Float _b) { return _a == _b; }
+		static Mask IsNegative(Float _v) { return std::signbit(_v); }
+		static Mask TestBits(Int _v, int32_t _bits) { return (_v & _bits) != 0; }
+		static Float Select(Mask _m, Float _a, Float _b) { return _m ? _a : _b; }
+		static Float Negate(Float _v, Mask _m) { return _m ? -_v : _v; }
+
+		static Int Round(Float _v) { return static_cast <Int> (std::lrint(_v)); }
+		static Float ToFloat(Int _v) { return static_cast <Float> (_v); }
+		static Int AddInt(Int _a, Int _b) { return _a + _b; }
+		static Int SubInt(Int _a, Int _b) { return _a - _b; }
+		static Int AndInt(Int _a, Int _b) { return _a & _b; }
+		static Int OrInt(Int _a, Int _b) { return _a | _b; }
+		template <int N> static Int ShiftLeft(Int _v) { return static_cast <Int> (static_cast <uint32_t> (_v) << N); }
+		template <int N> static Int ShiftRight(Int _v) { return _v >> N; }
+
+		static Int AsInt(Float _v) { Int i; memcpy(&i, &_v, sizeof(i)); return i; }
+		static Float AsFloat(Int _v) { Float f; memcpy(&f, &_v, sizeof(f)); return f; }
+	};
+
+#if CASS_MATH_SSE2
+	struct Sse2Lanes {
+		using Float = __m128;
+		using Int = __m128i;
+		using Mask = __m128;
+		static constexpr size_t s_width = 4;
+
+		static Float Load(const float* _p) { return _mm_loadu_ps(_p); }
+		static void Store(float* _p, Float _v) { _mm_storeu_ps(_p, _v); }
+		static Float Set(float _v) { return _mm_set1_ps(_v); }
+		static Int SetInt(int32_t _v) { return _mm_set1_epi32(_v); }
+
+		static Float Add(Float _a, Float _b) { return _mm_add_ps(_a, _b); }
+		static Float Sub(Float _a, Float _b) { return _mm_sub_ps(_a, _b); }
+		static Float Mul(Float _a, Float _b) { return _mm_mul_ps(_a, _b); }
+		static Float Div(Float _a, Float _b) { return _mm_div_ps(_a, _b); }
+		static Float Sqrt(Float _v) { return _mm_sqrt_ps(_v); }
+		static Float Min(Float _a, Float _b) { return _mm_min_ps(_a, _b); }
+		static Float Max(Float _a, Float _b) { return _mm_max_ps(_a, _b); }
+		static Float Abs(Float _v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), _v); }
+
+		static Mask Less(Float _a, Float _b) { return _mm_cmplt_ps(_a, _b); }
+		static Mask Greater(Float _a, Float _b) { return _mm_cmpgt_ps(_a, _b); }
+		static Mask Equal(Float _a, Float _b) { return _mm_cmpeq_ps(_a, _b); }
+		static Mask IsNegative(Float _v) { return _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(_v), 31)); }
+		static Mask TestBits(Int _v, int32_t _bits) {
+			return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_v, _mm_set1_epi32(_bits)), _mm_set1_epi32(_bits)));
+		}
+		static Float Select(Mask _m, Float _a, Float _b) { return _mm_or_ps(_mm_and_ps(_m, _a), _mm_andnot_ps(_m, _b)); }
+		static Float Negate(Float _v, Mask _m) { return _mm_xor_ps(_v, _mm_and_ps(_m, _mm_set1_ps(-0.0f))); }
+
+		static Int Round(Float _v) { return _mm_cvtps_epi32(_v); }
+		static Float ToFloat(Int _v) { return _mm_cvtepi32_ps(_v); }
+		static Int AddInt(Int _a, Int _b) { return _mm_add_epi32(_a, _b); }
+		static Int SubInt(Int _a, Int _b) { return _mm_sub_epi32(_a, _b); }
+		static Int AndInt(Int _a, Int _b) { return _mm_and_si128(_a, _b); }
+		static Int OrInt(Int _a, Int _b) { return _mm_or_si128(_a, _b); }
+		template <int N> static Int ShiftLeft(Int _v) { return _mm_slli_epi32(_v, N); }
+		template <int N> static Int ShiftRight(Int _v) { return _mm_srai_epi32(_v, N); }
+
+		static Int AsInt(Float _v) { return _mm_castps_si128(_v); }
+		static Float AsFloat(Int _v) { return _mm_castsi128_ps(_v); }
+	};
+#endif
+
+#if CASS_MATH_AVX2
+	struct Avx2Lanes {
+		using Float = __m256;
+		using Int = __m256i;
+		using Mask = __m256;
+		static constexpr size_t s_width = 8;
+
+		static Float Load(const float* _p) { return _mm256_loadu_ps(_p); }
+		static void Store(float* _p, Float _v) { _mm256_storeu_ps(_p, _v); }
+		static Float Set(float _v) { return _mm256_set1_ps(_v); }
+		static Int SetInt(int32_t _v) { return _mm256_set1_epi32(_v); }
+
+		static Float Add(Float _a, Float _b) { return _mm256_add_ps(_a, _b); }
+		static Float Sub(Float _a, Float _b) { return _mm256_sub_ps(_a, _b); }
+		static Float Mul(Float _a, Float _b) { return _mm256_mul_ps(_a, _b); }
+		static Float Div(Float _a, Float _b) { return _mm256_div_ps(_a, _b); }
+		static Float Sqrt(Float _v) { return _mm256_sqrt_ps(_v); }
+		static Float Min(Float _a, Float _b) { return _mm256_min_ps(_a, _b); }
+		static Float Max(Float _a, Float _b) { return _mm256_max_ps(_a, _b); }
+		static Float Abs(Float _v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), _v); }
+
+		static Mask Less(Float _a, Float _b) { return _mm256_cmp_ps(_a, _b, _CMP_LT_OQ); }
+		static Mask Greater(Float _a, Float _b) { return _mm256_cmp_ps(_a, _b, _CMP_GT_OQ); }
+		static Mask Equal(Float _a, Float _b) { return _mm256_cmp_ps(_a, _b, _CMP_EQ_OQ); }
+		static Mask IsNegative(Float _v) { return _mm256_castsi256_ps(_mm256_srai_epi32(_mm256_castps_si256(_v), 31)); }
+		static Mask TestBits(Int _v, int32_t _bits) {
+			return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_v, _mm256_set1_epi32(_bits)), _mm256_set1_epi32(_bits)));
+		}
+		static Float Select(Mask _m, Float _a, Float _b) { return _mm256_blendv_ps(_b, _a, _m); }
+		static Float Negate(Float _v, Mask _m) { return _mm256_xor_ps(_v, _mm256_and_ps(_m, _mm256_set1_ps(-0.0f))); }
+
+		static Int Round(Float _v) { return _mm256_cvtps_epi32(_v); }
+		static Float ToFloat(Int _v) { return _mm256_cvtepi32_ps(_v); }
+		static Int AddInt(Int _a, Int _b) { return _mm256_add_epi32(_a, _b); }
+		static Int SubInt(Int _a, Int _b) { return _mm256_sub_epi32(_a, _b); }
+		static Int AndInt(Int _a, Int _b) { return _mm256_and_si256(_a, _b); }
+		static Int OrInt(Int _a, Int _b) { return _mm256_or_si256(_a, _b); }
+		template <int N> static Int ShiftLeft(Int _v) { return _mm256_slli_epi32(_v, N); }
+		template <int N> static Int ShiftRight(Int _v) { return _mm256_srai_epi32(_v, N); }
+
+		static Int AsInt(Float _v) { return _mm256_castps_si256(_v); }
+		static Float AsFloat(Int _v) { return _mm256_castsi256_ps(_v); }
+	};
+
+	using Lanes = Avx2Lanes;
+#elif CASS_MATH_SSE2
+	using Lanes = Sse2Lanes;
+#else
+	using Lanes = ScalarLanes;
+#endif
+
+	const float s_pi = 3.14159265358979f;
+	const float s_infinity = std::numeric_limits <float>::infinity();
+
+	/**
+	* @brief Horner scheme, coefficients from the highest power down
+	*/
+	template <class L>
+	typename L::Float Polynomial(typename L::Float _x, typename L::Float _acc) {
+		return _acc;
+	}
+
+	template <class L, class... C>
+	typename L::Float Polynomial(typename L::Float _x, typename L::Float _acc, float _c, C... _rest) {
+		return Polynomial <L> (_x, L::Add(L::Mul(_acc, _x), L::Set(_c)), _rest...);
+	}
+
+	/**
+	* @brief Sine and cosine, x is reduced to n * pi / 2 + r with |r| <= pi / 4 and both are approximated on r
+	*/
+	template <class L>
+	void SinCosKernel(typename L::Float _x, typename L::Float& _oSin, typename L::Float& _oCos) {
+		using F = typename L::Float;
+
+		// pi / 2 split in four, the first three have few enough bits for n * C to be exact while |n| < 2^13
+		// so that r keeps its relative accuracy next to the zeros
+		typename L::Int n = L::Round(L::Mul(_x, L::Set(0.636619772f)));
+		F fn = L::ToFloat(n);
+		F r = L::Sub(_x, L::Mul(fn, L::Set(1.5703125f)));
+		r = L::Sub(r, L::Mul(fn, L::Set(4.837512969970703125e-4f)));
+		r = L::Sub(r, L::Mul(fn, L::Set(7.54953362047672271728515625e-8f)));
+		r = L::Sub(r, L::Mul(fn, L::Set(2.5633440682570896e-12f)));
+
+		F z = L::Mul(r, r);
+		F s = Polynomial <L> (z, L::Set(-1.9515295891e-4f), 8.3321608736e-3f, -1.6666654611e-1f);
+		s = L::Add(r, L::Mul(L::Mul(s, z), r));
+		F c = Polynomial <L> (z, L::Set(2.443315711809948e-5f), -1.388731625493765e-3f, 4.166664568298827e-2f);
+		c = L::Add(L::Sub(L::Set(1.0f), L::Mul(z, L::Set(0.5f))), L::Mul(L::Mul(c, z), z));
+
+		// by quadrant, sin x is sin r, cos r, -sin r, -cos r and cos x is cos r, -sin r, -cos r, sin r
+		typename L::Mask odd = L::TestBits(n, 1);
+		_oSin = L::Negate(L::Select(odd, c, s), L::TestBits(n, 2));
+		_oCos = L::Negate(L::Select(odd, s, c), L::TestBits(L::AddInt(n, L::SetInt(1)), 2));
+	}
+
+	/**
+	* @brief Arc tangent of _t in [0, 1]
+	*/
+	template <class L>
+	typename L::Float ATanKernel(typename L::Float _t) {
+		using F = typename L::Float;
+
+		// above tan(pi / 8) atan t = pi / 4 + atan((t - 1) / (t + 1))
+		typename L::Mask upper = L::Greater(_t, L::Set(0.414213562f));
+		F u = L::Select(upper, L::Div(L::Sub(_t, L::Set(1.0f)), L::Add(_t, L::Set(1.0f))), _t);
+
+		F z = L::Mul(u, u);
+		F a = Polynomial <L> (z, L::Set(8.05374449538e-2f), -1.38776856032e-1f, 1.99777106478e-1f, -3.33329491539e-1f);
+		a = L::Add(L::Mul(L::Mul(a, z), u), u);
+
+		return L::Select(upper, L::Add(a, L::Set(0.25f * s_pi)), a);
+	}
+
+	template <class L>
+	typename L::Float ATan2Kernel(typename L::Float _y, typename L::Float _x) {
+		using F = typename L::Float;
+
+		// the angle to the nearer axis first, then mirrored into the quadrant of (x, y)
+		F ax = L::Abs(_x), ay = L::Abs(_y);
+		F lo = L::Min(ax, ay), hi = L::Max(ax, ay);
+		F t = L::Select(L::Equal(hi, L::Set(0.0f)), L::Set(0.0f), L::Div(lo, hi));
+
+		F a = ATanKernel <L> (t);
+		a = L::Select(L::Greater(ay, ax), L::Sub(L::Set(0.5f * s_pi), a), a);
+		a = L::Select(L::IsNegative(_x), L::Sub(L::Set(s_pi), a), a);
+
+		return L::Negate(a, L::IsNegative(_y));
+	}
+
+	template <class L>
+	typename L::Float ASinKernel(typename L::Float _x) {
+		using F = typename L::Float;
+
+		// above 1/2 asin a = pi / 2 - 2 asin(sqrt((1 - a) / 2)), beyond 1 the root gives NaN
+		F a = L::Abs(_x);
+		typename L::Mask upper = L::Greater(a, L::Set(0.5f));
+		F z = L::Select(upper, L::Mul(L::Set(0.5f), L::Sub(L::Set(1.0f), a)), L::Mul(a, a));
+		F s = L::Select(upper, L::Sqrt(z), a);
+
+		F p = Polynomial <L> (z, L::Set(4.2163199048e-2f), 2.4181311049e-2f, 4.5470025998e-2f, 7.4953002686e-2f, 1.6666752422e-1f);
+		p = L::Add(L::Mul(L::Mul(p, z), s), s);
+		p = L::Select(upper, L::Sub(L::Set(0.5f * s_pi), L::Add(p, p)), p);
+
+		return L::Negate(p, L::IsNegative(_x));
+	}
+
+	template <class L>
+	typename L::Float ExpKernel(typename L::Float _x) {
+		using F = typename L::Float;
+		using I = typename L::Int;
+
+		// e^x = 2^n * e^r with |r| <= ln 2 / 2, ln 2 split in two for an exact n * C1
+		F x = L::Min(L::Max(_x, L::Set(-104.0f)), L::Set(89.0f));
+		I n = L::Round(L::Mul(x, L::Set(1.44269504089f)));
+		F fn = L::ToFloat(n);
+		F r = L::Sub(x, L::Mul(fn, L::Set(0.693359375f)));
+		r = L::Sub(r, L::Mul(fn, L::Set(-2.12194440e-4f)));
+
+		F p = Polynomial <L> (r, L::Set(1.9875691500e-4f), 1.3981999507e-3f, 8.3334519073e-3f, 4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f);
+		p = L::Add(L::Add(L::Mul(p, L::Mul(r, r)), r), L::Set(1.0f));
+
+		// 2^n as two factors so neither leaves the normal range, the product may round to a subnormal
+		I half = L::template ShiftRight <1> (n);
+		F scale0 = L::AsFloat(L::template ShiftLeft <23> (L::AddInt(half, L::SetInt(127))));
+		F scale1 = L::AsFloat(L::template ShiftLeft <23> (L::AddInt(L::SubInt(n, half), L::SetInt(127))));
+		p = L::Mul(L::Mul(p, scale0), scale1);
+
+		p = L::Select(L::Greater(_x, L::Set(88.7228391f)), L::Set(s_infinity), p);
+		p = L::Select(L::Less(_x, L::Set(-103.972084f)), L::Set(0.0f), p);
+		return L::Select(L::Equal(_x, _x), p, _x);
+	}
+
+	template <class L>
+	typename L::Float LogKernel(typename L::Float _x) {
+		using F = typename L::Float;
+		using I = typename L::Int;
+
+		// subnormals are scaled into the normal range before the exponent is taken apart
+		typename L::Mask tiny = L::Less(_x, L::Set(1.17549435e-38f));
+		F x = L::Select(tiny, L::Mul(_x, L::Set(8388608.0f)), _x);
+
+		// x = m * 2^e with m in [1/2, 1)
+		I bits = L::AsInt(x);
+		F e = L::ToFloat(L::SubInt(L::AndInt(L::template ShiftRight <23> (bits), L::SetInt(0xFF)), L::SetInt(126)));
+		e = L::Sub(e, L::Select(tiny, L::Set(23.0f), L::Set(0.0f)));
+		F m = L::AsFloat(L::OrInt(L::AndInt(bits, L::SetInt(0x007FFFFF)), L::SetInt(0x3F000000)));
+
+		// keep the polynomial argument in [sqrt(1/2) - 1, sqrt(2) - 1]
+		typename L::Mask low = L::Less(m, L::Set(0.707106781f));
+		e = L::Select(low, L::Sub(e, L::Set(1.0f)), e);
+		F f = L::Sub(L::Select(low, L::Add(m, m), m), L::Set(1.0f));
+
+		F z = L::Mul(f, f);
+		F y = Polynomial <L> (f, L::Set(7.0376836292e-2f), -1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f, 1.4249322787e-1f,
+			-1.6668057665e-1f, 2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f);
+		y = L::Mul(L::Mul(y, f), z);
+		y = L::Add(y, L::Mul(e, L::Set(-2.12194440e-4f)));
+		y = L::Sub(y, L::Mul(z, L::Set(0.5f)));
+		F r = L::Add(L::Add(f, y), L::Mul(e, L::Set(0.693359375f)));
+
+		r = L::Select(L::Equal(_x, L::Set(0.0f)), L::Set(-s_infinity), r);
+		r = L::Select(L::Less(_x, L::Set(0.0f)), L::Set(std::numeric_limits <float>::quiet_NaN()), r);
+		r = L::Select(L::Equal(_x, L::Set(s_infinity)), _x, r);
+		return L::Select(L::Equal(_x, _x), r, _x);
+	}
+
+	/**
+	* @brief Apply _kernel to Lanes::s_width values at a time, the tail goes through a buffer padded with _pad
+	*/
+	template <class Kernel>
+	void Map(const float* _x, float* _out, size_t _count, float _pad, Kernel _kernel) {
+		size_t i = 0;
+		for (; i + Lanes::s_width <= _count; i += Lanes::s_width) {
+			Lanes::Store(_out + i, _kernel(Lanes::Load(_x + i)));
+		}
+		if (i == _count) return;
+
+		float x[Lanes::s_width];
+		std::fill(x, x + Lanes::s_width, _pad);
+		memcpy(x, _x + i, (_count - i) * sizeof(float));
+		Lanes::Store(x, _kernel(Lanes::Load(x)));
+		memcpy(_out + i, x, (_count - i) * sizeof(float));
+	}
+
+	template <class Kernel>
+	void Map(const float* _x, const float* _y, float* _out, size_t _count, Kernel _kernel) {
+		size_t i = 0;
+		for (; i + Lanes::s_width <= _count; i += Lanes::s_width) {
+			Lanes::Store(_out + i, _kernel(Lanes::Load(_x + i), Lanes::Load(_y + i)));
+		}
+		if (i == _count) return;
+
+		float x[Lanes::s_width], y[Lanes::s_width];
+		std::fill(x, x + Lanes::s_width, 1.0f);
+		std::fill(y, y + Lanes::s_width, 1.0f);
+		memcpy(x, _x + i, (_count - i) * sizeof(float));
+		memcpy(y, _y + i, (_count - i) * sizeof(float));
+		Lanes::Store(x, _kernel(Lanes::Load(x), Lanes::Load(y)));
+		memcpy(_out + i, x, (_count - i) * sizeof(float));
+	}
+}
+
+void Cass::Math::Sin(const float* _x, float* _out, size_t _count) {
+	Map(_x, _out, _count, 0.0f, [](Lanes::Float _v) {
+		Lanes::Float s, c;
+		SinCosKernel <Lanes> (_v, s, c);
+		return s;
+	});
+}
+
+void Cass::Math::Cos(const float* _x, float* _out, size_t _count) {
+	Map(_x, _out, _count, 0.0f, [](Lanes::Float _v) {
+		Lanes::Float s, c;
+		SinCosKernel <Lanes> (_v, s, c);
+		return c;
+	});
+}
+
+void Cass::Math::SinCos(const float* _x, float* _sin, float* _cos, size_t _count) {
+	size_t i = 0;
+	for (; i + Lanes::s_width <= _count; i += Lanes::s_width) {
+		Lanes::Float s, c;
+		SinCosKernel <Lanes> (Lanes::Load(_x + i), s, c);
+		Lanes::Store(_sin + i, s);
+		Lanes::Store(_cos + i, c);
+	}
+	if (i == _count) return;
+
+	float x[Lanes::s_width] = {}, s[Lanes::s_width], c[Lanes::s_width];
+	memcpy(x, _x + i, (_count - i) * sizeof(float));
+
+	Lanes::Float vs, vc;
+	SinCosKernel <Lanes> (Lanes::Load(x), vs, vc);
+	Lanes::Store(s, vs);
+	Lanes::Store(c, vc);
+	memcpy(_sin + i, s, (_count - i) * sizeof(float));
+	memcpy(_cos + i, c, (_count - i) * sizeof(float));
+}
+
+void Cass::Math::ATan2(const float* _y, const float* _x, float* _out, size_t _count) {
+	Map(_y, _x, _out, _count, [](Lanes::Float _a, Lanes::Float _b) { return ATan2Kernel <Lanes> (_a, _b); });
+}
+
+void Cass::Math::ASin(const float* _x, float* _out, size_t _count) {
+	Map(_x, _out, _count, 0.0f, [](Lanes::Float _v) { return ASinKernel <Lanes> (_v); });
+}
+
+void Cass::Math::Exp(const float* _x, float* _out, size_t _count) {
+	Map(_x, _out, _count, 0.0f, [](Lanes::Float _v) { return ExpKernel <Lanes> (_v); });
+}
+
+void Cass::Math::Log(const float* _x, float* _out, size_t _count) {
+	Map(_x, _out, _count, 1.0f, [](Lanes::Float _v) { return LogKernel <Lanes> (_v); });
+}
+
+void Cass::Math::Pow(const float* _x, const float* _y, float* _out, size_t _count) {
+	Map(_x, _y, _out, _count, [](Lanes::Float _a, Lanes::Float _b) {
+		return ExpKernel <Lanes> (Lanes::Mul(_b, LogKernel <Lanes> (_a)));
+	});
 }
\ No newline at end of file
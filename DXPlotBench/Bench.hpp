@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+namespace Bench {
+	/**
+	* @brief Shortest of _repeat runs of _func in milliseconds, the first run warms the caches and is counted like the rest
+	*/
+	template <class Func>
+	double Time(Func&& _func, int _repeat = 5) {
+		double best = 0.0;
+		for (int i = 0; i < _repeat; i++) {
+			auto start = std::chrono::high_resolution_clock::now();
+			_func();
+			double elapsed = std::chrono::duration <double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			best = i == 0 ? elapsed : (elapsed < best ? elapsed : best);
+		}
+		return best;
+	}
+
+	/**
+	* @brief Fold the bits of _count floats into an FNV-1a hash, to compare the output of two builds
+	*/
+	inline uint64_t Hash(const float* _values, size_t _count, uint64_t _hash = 14695981039346656037ull) {
+		for (size_t i = 0; i < _count; i++) {
+			uint32_t bits;
+			memcpy(&bits, _values + i, sizeof(bits));
+			_hash = (_hash ^ bits) * 1099511628211ull;
+		}
+		return _hash;
+	}
+
+	// every benchmark prints its own report and returns false if a result is wrong
+	bool RunMath();
+	bool RunIsoSurface();
+	bool RunCsv();
+	bool RunRay();
+	bool RunCull();
+	bool RunSceneGraph();
+	bool RunHover();
+}
\ No newline at end of file
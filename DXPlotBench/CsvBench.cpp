@@ -0,0 +1,94 @@
+#include "Bench.hpp"
+
+#include <Resource/CsvTable.hpp>
+#include <util.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Cass;
+
+namespace {
+	const size_t s_rowCount = 2000000;
+	const double s_epoch = 1700000000.0;
+
+	// exact in float and double, so the parsed values can be compared for equality
+	double TimeAt(size_t _row) { return s_epoch + static_cast <double> (_row); }
+	float XAt(size_t _row) { return 0.5f * static_cast <float> (_row % 100000); }
+	float YAt(size_t _row) { return 0.25f * static_cast <float> (_row % 1000) - 100.0f; }
+
+	/**
+	* @brief Line by line parsing through strings, the way a plot was filled before CsvTable
+	*/
+	size_t ParseWithStreams(const std::filesystem::path& _path, std::vector <double>& _oTime, std::vector <float>& _oX, std::vector <float>& _oY) {
+		std::ifstream file(_path);
+		std::string line, field;
+		std::getline(file, line);
+
+		while (std::getline(file, line)) {
+			if (line.empty()) continue;
+
+			std::istringstream fields(line);
+			std::getline(fields, field, ',');
+			_oTime.push_back(std::stod(field));
+			std::getline(fields, field, ',');
+			_oX.push_back(std::stof(field));
+			std::getline(fields, field, ',');
+			_oY.push_back(std::stof(field));
+		}
+		return _oTime.size();
+	}
+}
+
+bool Bench::RunCsv() {
+	// epoch seconds, two numbers and a label, with a blank line every thousand rows
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "DXPlotBench.csv";
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << "time,x,y,label\n";
+
+		char line[96];
+		for (size_t i = 0; i < s_rowCount; i++) {
+			int length = snprintf(line, sizeof(line), "%.0f,%.1f,%.2f,p%u\n", TimeAt(i), XAt(i), YAt(i), static_cast <unsigned> (i % 10));
+			file.write(line, length);
+			if (i % 1000 == 999) file << "\n";
+		}
+	}
+	uint64_t bytes = std::filesystem::file_size(path);
+
+	CsvTable table;
+	double tableTime = Bench::Time([&]() { ThrowIfFailed(table.Load(path.c_str())); }, 3);
+
+	std::vector <double> time;
+	std::vector <float> x, y;
+	double streamTime = Bench::Time([&]() {
+		time.clear();
+		x.clear();
+		y.clear();
+		ParseWithStreams(path, time, x, y);
+	}, 1);
+
+	std::filesystem::remove(path);
+
+	printf("%-10s %10s %10s %8s\n", "", "ms", "GB/s", "rows");
+	printf("%-10s %10.1f %10.3f %8zu\n", "CsvTable", tableTime, bytes / 1e6 / tableTime, table.GetRowCount());
+	printf("%-10s %10.1f %10.3f %8zu\n", "streams", streamTime, bytes / 1e6 / streamTime, time.size());
+	printf("speedup %.1f\n", streamTime / tableTime);
+
+	// the time column has to come back wide to keep its seconds, the label column as text
+	bool passed = table.GetRowCount() == s_rowCount && table.GetColumnCount() == 4 && time.size() == s_rowCount &&
+		table.GetType(0) == COLUMN_TYPE::WIDE_NUMBER && table.GetType(1) == COLUMN_TYPE::NUMBER &&
+		table.GetType(2) == COLUMN_TYPE::NUMBER && table.GetType(3) == COLUMN_TYPE::TEXT;
+	if (!passed) return false;
+
+	const std::vector <double>& tableTimes = table.GetWideColumn(0);
+	const std::vector <float>& tableX = table.GetColumn(1), & tableY = table.GetColumn(2);
+	for (size_t i = 0; i < s_rowCount && passed; i++) {
+		passed = tableTimes[i] == TimeAt(i) && tableX[i] == XAt(i) && tableY[i] == YAt(i) && time[i] == TimeAt(i) && x[i] == XAt(i) && y[i] == YAt(i);
+	}
+	return passed;
+}
\ No newline at end of file
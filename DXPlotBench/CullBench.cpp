@@ -0,0 +1,65 @@
+#include "Bench.hpp"
+
+#include <Elements/Frustum.hpp>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Cass;
+
+namespace {
+	const size_t s_boxCount = 1000000;
+}
+
+bool Bench::RunCull() {
+	// small boxes scattered through a cube larger than the view, a camera inside it looking along a turned z axis
+	std::mt19937 generator(11);
+	std::uniform_real_distribution <float> position(-100.0f, 100.0f), size(0.1f, 2.0f);
+
+	std::vector <DirectX::XMFLOAT3> lb(s_boxCount), ub(s_boxCount);
+	BoxArray boxes;
+	boxes.Resize(s_boxCount);
+	for (size_t i = 0; i < s_boxCount; i++) {
+		DirectX::XMFLOAT3 center = { position(generator), position(generator), position(generator) };
+		float extent = 0.5f * size(generator);
+		lb[i] = { center.x - extent, center.y - extent, center.z - extent };
+		ub[i] = { center.x + extent, center.y + extent, center.z + extent };
+		boxes.Set(i, lb[i], ub[i]);
+	}
+
+	DirectX::XMMATRIX view = DirectX::XMMatrixMultiply(DirectX::XMMatrixRotationY(0.3f), DirectX::XMMatrixTranslation(0.0f, 0.0f, 20.0f));
+	Frustum frustum(DirectX::XMMatrixMultiply(view, DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 150.0f)));
+
+	std::vector <uint32_t> visible, reference;
+	visible.reserve(s_boxCount);
+	reference.reserve(s_boxCount);
+
+	double cullTime = Bench::Time([&]() {
+		visible.clear();
+		frustum.Cull(boxes, visible);
+	});
+	double scalarTime = Bench::Time([&]() {
+		reference.clear();
+		for (size_t i = 0; i < s_boxCount; i++) {
+			if (frustum.Intersects(lb[i], ub[i])) reference.push_back(static_cast <uint32_t> (i));
+		}
+	});
+
+	printf("%-10s %10s %12s\n", "", "ms", "Mboxes/s");
+	printf("%-10s %10.2f %12.1f\n", "Cull", cullTime, s_boxCount / cullTime / 1e3);
+	printf("%-10s %10.2f %12.1f\n", "Intersects", scalarTime, s_boxCount / scalarTime / 1e3);
+	printf("speedup %.1f, %zu of %zu boxes visible\n", scalarTime / cullTime, visible.size(), s_boxCount);
+
+	// both lists are sorted, count the boxes only one of them kept
+	size_t mismatches = 0, a = 0, b = 0;
+	while (a < visible.size() || b < reference.size()) {
+		if (b == reference.size() || (a < visible.size() && visible[a] < reference[b])) a++, mismatches++;
+		else if (a == visible.size() || reference[b] < visible[a]) b++, mismatches++;
+		else a++, b++;
+	}
+	printf("%zu boxes disagree\n", mismatches);
+
+	// the sums run in a different order, only boxes touching a plane within rounding may go either way
+	return !visible.empty() && visible.size() < s_boxCount && mismatches * 100000 < s_boxCount;
+}
\ No newline at end of file
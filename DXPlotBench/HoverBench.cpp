@@ -0,0 +1,95 @@
+#include "Bench.hpp"
+
+#include <Elements/ScreenPointIndex.hpp>
+#include <Object/Camera.hpp>
+#include <Object/CameraFrame.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Cass;
+
+namespace {
+	const size_t s_pointCount = 1000000;
+	const size_t s_queryCount = 10000;
+	const size_t s_bruteCount = 500;
+	const float s_radius = 8.0f;
+
+	// pixel positions of the brute force search differ from the index's by rounding only
+	const float s_tolerance = 1e-2f;
+}
+
+bool Bench::RunHover() {
+	// a planar scatter plot in a full HD view as DXPlot sets it up, dense in the middle and sparse enough at the borders for half the queries to miss
+	Camera camera({ 0.0f, 0.0f, -10.0f });
+	camera.SetProjection(PROJECTION::PERSPECTIVE, 1920.0f, 1080.0f);
+	CameraFrame frame(camera);
+	DirectX::XMMATRIX model = DirectX::XMMatrixIdentity();
+
+	std::mt19937 generator(5);
+	std::normal_distribution <float> x(0.0f, 2.0f), y(0.0f, 1.2f);
+	std::uniform_real_distribution <float> pixelX(0.0f, 1920.0f), pixelY(0.0f, 1080.0f);
+	std::vector <DirectX::XMFLOAT2> points(s_pointCount);
+	for (DirectX::XMFLOAT2& point : points) point = { x(generator), y(generator) };
+
+	std::vector <DirectX::XMFLOAT2> queries(s_queryCount);
+	for (DirectX::XMFLOAT2& query : queries) query = { pixelX(generator), pixelY(generator) };
+
+	ScreenPointIndex index;
+	double buildTime = Bench::Time([&]() {
+		index.Invalidate();
+		index.Update(frame, model, points.data(), points.size());
+	});
+
+	std::vector <uint32_t> nearest(s_queryCount);
+	std::vector <float> distances(s_queryCount);
+	double queryTime = Bench::Time([&]() {
+		for (size_t q = 0; q < s_queryCount; q++) nearest[q] = index.Nearest(queries[q].x, queries[q].y, s_radius, distances[q]);
+	});
+
+	// brute force over every point, projected one at a time
+	DirectX::XMMATRIX toClip = DirectX::XMMatrixMultiply(model, frame.GetViewProjection());
+	DirectX::XMFLOAT2 viewport = frame.GetViewportSize();
+	std::vector <DirectX::XMFLOAT2> pixels(s_pointCount);
+	std::vector <uint8_t> onScreen(s_pointCount);
+	for (size_t i = 0; i < s_pointCount; i++) {
+		DirectX::XMFLOAT4 clip;
+		DirectX::XMStoreFloat4(&clip, DirectX::XMVector4Transform(DirectX::XMVectorSet(points[i].x, points[i].y, 0.0f, 1.0f), toClip));
+		pixels[i] = { (clip.x / clip.w * 0.5f + 0.5f) * viewport.x, (0.5f - clip.y / clip.w * 0.5f) * viewport.y };
+		onScreen[i] = clip.w > 0.0f && pixels[i].x >= 0.0f && pixels[i].x < viewport.x && pixels[i].y >= 0.0f && pixels[i].y < viewport.y;
+	}
+
+	std::vector <float> bruteDistances(s_bruteCount);
+	double bruteTime = Bench::Time([&]() {
+		for (size_t q = 0; q < s_bruteCount; q++) {
+			float best = INFINITY;
+			for (size_t i = 0; i < s_pointCount; i++) {
+				float dx = pixels[i].x - queries[q].x, dy = pixels[i].y - queries[q].y;
+				if (onScreen[i]) best = std::fmin(best, dx * dx + dy * dy);
+			}
+			bruteDistances[q] = std::sqrt(best);
+		}
+	}, 1);
+
+	// a point found by one side only has to lie on the edge of the radius
+	size_t found = 0, mismatches = 0;
+	for (size_t q = 0; q < s_bruteCount; q++) {
+		bool indexFound = nearest[q] != ScreenPointIndex::s_nullPoint, bruteFound = bruteDistances[q] <= s_radius;
+		found += indexFound;
+
+		if (indexFound && bruteFound) mismatches += std::fabs(distances[q] - bruteDistances[q]) > s_tolerance;
+		else if (indexFound) mismatches += bruteDistances[q] > s_radius + s_tolerance;
+		else if (bruteFound) mismatches += bruteDistances[q] < s_radius - s_tolerance;
+	}
+
+	printf("%zu points, %zu on the screen, radius %.0f pixels\n", s_pointCount, index.GetVisibleCount(), s_radius);
+	printf("%-12s %12s\n", "", "us");
+	printf("%-12s %12.1f\n", "build", buildTime * 1e3);
+	printf("%-12s %12.3f\n", "query", queryTime * 1e3 / s_queryCount);
+	printf("%-12s %12.1f\n", "brute force", bruteTime * 1e3 / s_bruteCount);
+	printf("%zu of %zu queries checked against brute force hit a point, %zu disagree\n", found, s_bruteCount, mismatches);
+
+	return found > 0 && mismatches == 0;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "Bench.hpp"
+
+#include <Object/IsoSurface.hpp>
+#include <util.hpp>
+
+#include <d3d11.h>
+#include <wrl/client.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace Cass;
+
+namespace {
+	const float s_radius = 0.8f;
+
+	float SphereField(float _x, float _y, float _z) {
+		return std::sqrt(_x * _x + _y * _y + _z * _z) - s_radius;
+	}
+
+	/**
+	* @brief Every edge of a closed surface is shared by exactly two triangles, slab borders that weren't stitched break this
+	*/
+	bool IsClosed(const TriangleBvh::Geometry& _geometry) {
+		std::vector <uint64_t> edges;
+		edges.reserve(_geometry.triangleCount * 3);
+
+		for (size_t t = 0; t < _geometry.triangleCount; t++) {
+			for (size_t c = 0; c < 3; c++) {
+				uint64_t a = _geometry.indices[t * 3 + c], b = _geometry.indices[t * 3 + (c + 1) % 3];
+				edges.push_back(std::min(a, b) << 32 | std::max(a, b));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+
+		for (size_t i = 0; i < edges.size(); i += 2) {
+			if (i + 1 == edges.size() || edges[i] != edges[i + 1] || (i + 2 < edges.size() && edges[i + 2] == edges[i])) return false;
+		}
+		return true;
+	}
+
+	/**
+	* @brief Largest distance of a vertex from the sphere
+	*/
+	float SphereError(const TriangleBvh::Geometry& _geometry) {
+		float worst = 0.0f;
+		for (size_t t = 0; t < _geometry.triangleCount; t++) {
+			for (size_t c = 0; c < 3; c++) {
+				const DirectX::XMFLOAT3& p = _geometry.GetVertex(t, c);
+				worst = std::max(worst, std::fabs(SphereField(p.x, p.y, p.z)));
+			}
+		}
+		return worst;
+	}
+}
+
+bool Bench::RunIsoSurface() {
+	// the meshes only need buffers, the software rasterizer runs anywhere
+	Microsoft::WRL::ComPtr <ID3D11Device> device;
+	Microsoft::WRL::ComPtr <ID3D11DeviceContext> context;
+	ThrowIfFailed(D3D11CreateDevice(
+		nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, nullptr, 0, D3D11_SDK_VERSION, device.GetAddressOf(), nullptr, context.GetAddressOf()
+	));
+
+	printf("%-22s %10s %14s %12s %8s %10s\n", "", "ms", "Msamples/s", "triangles", "closed", "max error");
+
+	bool passed = true;
+	auto report = [&](const char* _name, const IsoSurface& _surface, uint32_t _res) {
+		TriangleBvh::Geometry geometry = _surface.GetGeometry();
+		bool closed = IsClosed(geometry);
+		float error = SphereError(geometry), cell = 2.0f / (_res - 1U);
+		double samples = static_cast <double> (_res) * _res * _res;
+
+		printf("%-22s %10.1f %14.1f %12llu %8s %10.2f cells\n", _name, _surface.GetExtractionTime(), samples / _surface.GetExtractionTime() / 1e3,
+			static_cast <unsigned long long> (geometry.triangleCount), closed ? "yes" : "NO", error / cell);
+
+		// interpolating the samples along the cell edges lands well within a cell of the true surface
+		passed = passed && closed && error < 0.25f * cell;
+	};
+
+	for (uint32_t res : { 256U, 512U }) {
+		IsoSurface surface(SphereField, { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f }, { res, res, res }, 0.0f, device.Get(), context.Get());
+		report(res == 256U ? "function 256^3" : "function 512^3", surface, res);
+	}
+
+	// a stored volume only revisits the bricks the octree finds crossed by the new iso value
+	const uint32_t res = 256U;
+	std::vector <float> samples(static_cast <size_t> (res) * res * res);
+	ParallelFor(0, res, [&](size_t _begin, size_t _end) {
+		for (size_t z = _begin; z < _end; z++) {
+			for (uint32_t y = 0; y < res; y++) {
+				for (uint32_t x = 0; x < res; x++) {
+					float step = 2.0f / (res - 1U);
+					samples[(z * res + y) * res + x] = SphereField(-1.0f + step * x, -1.0f + step * y, -1.0f + step * z);
+				}
+			}
+		}
+	});
+
+	IsoSurface volume(std::move(samples), { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f }, { res, res, res }, 0.0f, device.Get(), context.Get());
+	report("volume 256^3", volume, res);
+
+	volume.SetIsoValue(0.0f);
+	report("volume 256^3 again", volume, res);
+
+	return passed;
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "Bench.hpp"
+
+#include <util.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+using namespace Cass;
+
+namespace {
+	const size_t s_count = 1 << 20;
+
+	/**
+	* @brief Distance of _value from _reference in units of the last place of the float nearest _reference
+	*/
+	double UlpError(float _value, double _reference) {
+		if (std::isnan(_reference)) return std::isnan(_value) ? 0.0 : HUGE_VAL;
+		if (std::isinf(static_cast <float> (_reference))) return _value == static_cast <float> (_reference) ? 0.0 : HUGE_VAL;
+
+		int exponent = -126;
+		if (std::fabs(_reference) >= FLT_MIN) {
+			std::frexp(_reference, &exponent);
+			exponent -= 1;
+		}
+		return std::fabs(_value - _reference) / std::ldexp(1.0, exponent - 23);
+	}
+
+	// xorshift, the same sequence on every build so the hashes compare
+	float Random(uint64_t& _state, float _lo, float _hi) {
+		_state ^= _state << 13;
+		_state ^= _state >> 7;
+		_state ^= _state << 17;
+		return _lo + (_hi - _lo) * static_cast <float> (_state >> 40) / static_cast <float> (1 << 24);
+	}
+
+	struct Case {
+		const char* name;
+		double limit;
+		std::function <void()> batch, scalar;
+
+		// exact value of output i, SinCos has a second output
+		std::function <double(size_t)> reference;
+		const float* result;
+		std::function <double(size_t)> secondReference;
+		const float* secondResult;
+	};
+}
+
+bool Bench::RunMath() {
+	std::vector <float> x(s_count), y(s_count), angle(s_count), unit(s_count), exponent(s_count), positive(s_count), power(s_count);
+	uint64_t state = 88172645463325252ull;
+	for (size_t i = 0; i < s_count; i++) {
+		float t = static_cast <float> (i) / (s_count - 1);
+		angle[i] = -Math::PIx2 + 2.0f * Math::PIx2 * t;
+		unit[i] = -1.0f + 2.0f * t;
+		exponent[i] = -87.0f + 175.0f * t;
+		positive[i] = std::exp(-69.0f + 138.0f * t);
+
+		x[i] = Random(state, -1e3f, 1e3f);
+		y[i] = Random(state, -1e3f, 1e3f);
+		power[i] = Random(state, -4.0f, 4.0f);
+	}
+
+	// pow is documented for bases in [1e-3, 1e3]
+	std::vector <float> base(s_count);
+	for (size_t i = 0; i < s_count; i++) base[i] = std::exp(-6.9f + 13.8f * static_cast <float> (i) / (s_count - 1));
+
+	std::vector <float> out(s_count), out2(s_count), ref(s_count);
+
+	// limits from util.hpp rounded up, a kernel over them fails the run
+	Case cases[] = {
+		{
+			"Sin", 2.0,
+			[&]() { Math::Sin(angle.data(), out.data(), s_count); },
+			[&]() { for (size_t i = 0; i < s_count; i++) ref[i] = std::sin(angle[i]); },
+			[&](size_t i) { return std::sin(static_cast <double> (angle[i])); }, out.data(), nullptr, nullptr
+		},
+		{
+			"Cos", 2.0,
+			[&]() { Math::Cos(angle.data(), out.data(), s_count); },
+			[&]() { for (size_t i = 0; i < s_count; i++) ref[i] = std::cos(angle[i]); },
+			[&](size_t i) { return std::cos(static_cast <double> (angle[i])); }, out.data(), nullptr, nullptr
+		},
+		{
+			"SinCos", 2.0,
+			[&]() { Math::SinCos(angle.data(), out.data(), out2.data(), s_count); },
+			[&]() { for (size_t i = 0; i < s_count; i++) ref[i] = std::sin(angle[i]) + std::cos(angle[i]); },
+			[&](size_t i) { return std::sin(static_cast <double> (angle[i])); }, out.data(),
+			[&](size_t i) { return std::cos(static_cast <double> (angle[i])); }, out2.data()
+		},
+		{
+			"ASin", 3.0,
+			[&]() { Math::ASin(unit.data(), out.data(), s_count); },
+			[&]() { for (size_t i = 0; i < s_count; i++) ref[i] = std::asin(unit[i]); },
+			[&](size_t i) { return std::asin(static_cast <double> (unit[i])); }, out.data(), nullptr, nullptr
+		},
+		{
+			"ATan2", 4.0,
+			[&]() { Math::ATan2(y.data(), x.data(), out.data(), s_count); },
+			[&]() { for (size_t i = 0; i < s_count; i++) ref[i] = std::atan2(y[i], x[i]); },
+			[&](size_t i) { return std::atan2(static_cast <double> (y[i]), static_cast <double> (x[i])); }, out.data(), nullptr, nullptr
+		},
+		{
+			"Exp", 1.0,
+			[&]() { Math::Exp(exponent.data(), out.data(), s_count); },
+			[&]() { for (size_t i = 0; i < s_count; i++) ref[i] = std::exp(exponent[i]); },
+			[&](size_t i) { return std::exp(static_cast <double> (exponent[i])); }, out.data(), nullptr, nullptr
+		},
+		{
+			"Log", 1.0,
+			[&]() { Math::Log(positive.data(), out.data(), s_count); },
+			[&]() { for (size_t i = 0; i < s_count; i++) ref[i] = std::log(positive[i]); },
+			[&](size_t i) { return std::log(static_cast <double> (positive[i])); }, out.data(), nullptr, nullptr
+		},
+		{
+			"Pow", 32.0,
+			[&]() { Math::Pow(base.data(), power.data(), out.data(), s_count); },
+			[&]() { for (size_t i = 0; i < s_count; i++) ref[i] = std::pow(base[i], power[i]); },
+			[&](size_t i) { return std::pow(static_cast <double> (base[i]), static_cast <double> (power[i])); }, out.data(), nullptr, nullptr
+		},
+	};
+
+	printf("%-8s %12s %12s %8s %10s %8s\n", "", "Cass M/s", "libm M/s", "speedup", "max ulp", "limit");
+
+	bool passed = true;
+	uint64_t hash = Hash(nullptr, 0);
+	for (Case& c : cases) {
+		double batch = Bench::Time(c.batch), scalar = Bench::Time(c.scalar);
+
+		double worst = 0.0;
+		for (size_t i = 0; i < s_count; i++) worst = std::max(worst, UlpError(c.result[i], c.reference(i)));
+		hash = Hash(c.result, s_count, hash);
+
+		if (c.secondResult != nullptr) {
+			for (size_t i = 0; i < s_count; i++) worst = std::max(worst, UlpError(c.secondResult[i], c.secondReference(i)));
+			hash = Hash(c.secondResult, s_count, hash);
+		}
+
+		printf("%-8s %12.1f %12.1f %8.2f %10.2f %8.1f\n",
+			c.name, s_count / batch / 1e3, s_count / scalar / 1e3, scalar / batch, worst, c.limit);
+		passed = passed && worst <= c.limit;
+	}
+
+	printf("output hash %016llx (%s)\n", static_cast <unsigned long long> (hash),
+#if defined(_XM_NO_INTRINSICS_)
+		"scalar"
+#elif defined(__AVX2__)
+		"AVX2"
+#else
+		"SSE2"
+#endif
+	);
+
+	return passed;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "Bench.hpp"
+
+#include <Elements/BoundingBox.hpp>
+#include <Elements/Ray.hpp>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Cass;
+
+namespace {
+	const size_t s_rayCount = 1000000;
+
+	/**
+	* @brief The box test BoundingBox::Intersect ran before the slab test, the ray against the twelve triangles of the faces
+	* @return 1: front facing intersection, -1: back facing intersection, 0: no intersection
+	*/
+	int IntersectTriangles(const BoundingBox& _box, const Ray& _ray) {
+		DirectX::XMFLOAT3 p = _box.GetPosition(), d = _box.GetDimensions();
+		if (d.x <= 0.0f || d.y <= 0.0f || d.z <= 0.0f) return 0;
+
+		DirectX::XMFLOAT3 lb = { p.x - d.x * 0.5f, p.y - d.y * 0.5f, p.z - d.z * 0.5f };
+		DirectX::XMFLOAT3 ub = { p.x + d.x * 0.5f, p.y + d.y * 0.5f, p.z + d.z * 0.5f };
+
+		int count = 0;
+		for (int axis = 0; axis < 3; axis++) {
+			for (int side = 0; side < 2; side++) {
+				// corner of the face in the two axes other than the face's own
+				auto corner = [&](bool _u, bool _v) {
+					float c[3], face = side ? (&ub.x)[axis] : (&lb.x)[axis];
+					c[axis] = face;
+					c[(axis + 1) % 3] = _u ? (&ub.x)[(axis + 1) % 3] : (&lb.x)[(axis + 1) % 3];
+					c[(axis + 2) % 3] = _v ? (&ub.x)[(axis + 2) % 3] : (&lb.x)[(axis + 2) % 3];
+					return DirectX::XMFLOAT3 { c[0], c[1], c[2] };
+				};
+				count += _ray.IntersectTriangle(corner(false, false), corner(true, false), corner(true, true));
+				count += _ray.IntersectTriangle(corner(false, false), corner(false, true), corner(true, true));
+			}
+			if (count >= 2) return 1;
+		}
+		return -count;
+	}
+}
+
+bool Bench::RunRay() {
+	// rays from around the box in every direction, about half of them hit
+	std::mt19937 generator(7);
+	std::uniform_real_distribution <float> position(-3.0f, 3.0f);
+	BoundingBox box({ 0.3f, -0.2f, 0.1f }, { 1.5f, 2.0f, 0.7f });
+
+	std::vector <Ray> rays;
+	rays.reserve(s_rayCount);
+	for (size_t i = 0; i < s_rayCount; i++) {
+		rays.emplace_back(DirectX::XMFLOAT3 { position(generator), position(generator), position(generator) },
+			DirectX::XMFLOAT3 { position(generator), position(generator), position(generator) });
+	}
+
+	std::vector <int> slab(s_rayCount), triangles(s_rayCount);
+	double slabTime = Bench::Time([&]() {
+		for (size_t i = 0; i < s_rayCount; i++) slab[i] = box.Intersect(rays[i]);
+	});
+	double trianglesTime = Bench::Time([&]() {
+		for (size_t i = 0; i < s_rayCount; i++) triangles[i] = IntersectTriangles(box, rays[i]);
+	}, 3);
+
+	size_t hits = 0, mismatches = 0;
+	for (size_t i = 0; i < s_rayCount; i++) {
+		hits += slab[i] != 0;
+		mismatches += slab[i] != triangles[i];
+	}
+
+	printf("%-10s %10s %12s\n", "", "ms", "Mrays/s");
+	printf("%-10s %10.1f %12.1f\n", "slab", slabTime, s_rayCount / slabTime / 1e3);
+	printf("%-10s %10.1f %12.1f\n", "triangles", trianglesTime, s_rayCount / trianglesTime / 1e3);
+	printf("speedup %.1f, %zu hits, %zu rays disagree\n", trianglesTime / slabTime, hits, mismatches);
+
+	// the two tests only disagree for rays grazing an edge, where the triangle test's epsilons decide
+	bool agree = mismatches * 10000 < s_rayCount;
+
+	// axis aligned rays, also ones lying in the plane of a face, lower or upper, which must touch the box instead of giving NaN
+	BoundingBox unit({ 0.0f, 0.0f, 0.0f }, { 2.0f, 2.0f, 2.0f });
+	float tNear, tFar;
+	bool passed = unit.Intersect(Ray({ 0.0f, 0.0f, -5.0f }, { 0.0f, 0.0f, 1.0f }), tNear, tFar) && tNear == 4.0f && tFar == 6.0f;
+	passed = passed && unit.Intersect(Ray({ -1.0f, -1.0f, -5.0f }, { 0.0f, 0.0f, 1.0f }), tNear, tFar) && tNear == 4.0f && tFar == 6.0f;
+	passed = passed && unit.Intersect(Ray({ 1.0f, 1.0f, -5.0f }, { 0.0f, 0.0f, 1.0f }), tNear, tFar) && tNear == 4.0f && tFar == 6.0f;
+	passed = passed && unit.Intersect(Ray({ 1.0f, 0.0f, 5.0f }, { 0.0f, 0.0f, -1.0f }), tNear, tFar) && tNear == 4.0f && tFar == 6.0f;
+	passed = passed && unit.Intersect(Ray({ 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f })) == -1;
+	passed = passed && unit.Intersect(Ray({ 0.0f, 1.5f, -5.0f }, { 0.0f, 0.0f, 1.0f })) == 0;
+	passed = passed && unit.Intersect(Ray({ 0.0f, 0.0f, -5.0f }, { 0.0f, 0.0f, -1.0f })) == 0;
+	printf("axis aligned rays %s\n", passed ? "ok" : "wrong");
+
+	return agree && passed;
+}
\ No newline at end of file
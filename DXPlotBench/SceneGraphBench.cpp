@@ -0,0 +1,106 @@
+#include "Bench.hpp"
+
+#include <SceneGraph.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Cass;
+
+namespace {
+	const size_t s_nodeCount = 100000;
+	const size_t s_fanOut = 16;
+
+	DirectX::XMMATRIX Local(const SceneGraph& _graph, uint32_t _node) {
+		DirectX::XMFLOAT3 position = _graph.GetPosition(_node), scale = _graph.GetScale(_node);
+		DirectX::XMFLOAT4 rotation = _graph.GetRotation(_node);
+		return DirectX::XMMatrixMultiply(
+			DirectX::XMMatrixMultiply(DirectX::XMMatrixScaling(scale.x, scale.y, scale.z), DirectX::XMMatrixRotationQuaternion(DirectX::XMLoadFloat4(&rotation))),
+			DirectX::XMMatrixTranslation(position.x, position.y, position.z)
+		);
+	}
+
+	/**
+	* @brief World matrix composed up the parent chain for every node on its own, the way each object built its matrix before the graph
+	*/
+	DirectX::XMMATRIX ChainWorld(const SceneGraph& _graph, uint32_t _node) {
+		DirectX::XMMATRIX world = Local(_graph, _node);
+		for (uint32_t parent = _graph.GetParent(_node); parent != SceneGraph::s_nullNode; parent = _graph.GetParent(parent)) {
+			world = DirectX::XMMatrixMultiply(world, Local(_graph, parent));
+		}
+		return world;
+	}
+}
+
+bool Bench::RunSceneGraph() {
+	// every node below the one s_fanOut times earlier, five levels with small random offsets and turns
+	std::mt19937 generator(3);
+	std::uniform_real_distribution <float> offset(-1.0f, 1.0f);
+	auto randomize = [&](SceneGraph& _graph, uint32_t _node) {
+		float angle = 0.5f * offset(generator);
+		_graph.SetLocal(_node, { offset(generator), offset(generator), offset(generator) }, { 0.0f, std::sin(angle), 0.0f, std::cos(angle) },
+			{ 1.0f + 0.1f * offset(generator), 1.0f, 1.0f });
+	};
+
+	SceneGraph graph;
+	std::vector <uint32_t> nodes;
+	nodes.reserve(s_nodeCount);
+	for (size_t i = 0; i < s_nodeCount; i++) {
+		nodes.push_back(graph.AddNode(i == 0 ? SceneGraph::s_nullNode : nodes[(i - 1) / s_fanOut]));
+		randomize(graph, nodes.back());
+	}
+	graph.Update();
+
+	// moving the root recomputes every node, 1% of the nodes moved only their subtrees
+	size_t allCount = 0, dirtyCount = 0, cleanCount = 0;
+	std::vector <uint8_t> moved;
+	double allTime = Bench::Time([&]() {
+		randomize(graph, nodes[0]);
+		allCount = graph.Update();
+	});
+	double dirtyTime = Bench::Time([&]() {
+		moved.assign(s_nodeCount, 0);
+		for (size_t i = 0; i < s_nodeCount / 100; i++) {
+			size_t index = generator() % s_nodeCount;
+			randomize(graph, nodes[index]);
+			moved[index] = 1;
+		}
+		dirtyCount = graph.Update();
+	});
+	double cleanTime = Bench::Time([&]() { cleanCount = graph.Update(); });
+
+	// parents come before their children in nodes, so one pass spreads the moved flags down the subtrees
+	size_t expected = 0;
+	for (size_t i = 0; i < s_nodeCount; i++) {
+		moved[i] = moved[i] || (i > 0 && moved[(i - 1) / s_fanOut]);
+		expected += moved[i];
+	}
+
+	std::vector <DirectX::XMFLOAT4X4> reference(s_nodeCount);
+	double chainTime = Bench::Time([&]() {
+		for (size_t i = 0; i < s_nodeCount; i++) DirectX::XMStoreFloat4x4(&reference[i], ChainWorld(graph, nodes[i]));
+	}, 3);
+
+	printf("%-16s %10s %10s\n", "", "ms", "updated");
+	printf("%-16s %10.2f %10zu\n", "root moved", allTime, allCount);
+	printf("%-16s %10.2f %10zu\n", "1% moved", dirtyTime, dirtyCount);
+	printf("%-16s %10.3f %10zu\n", "nothing moved", cleanTime, cleanCount);
+	printf("%-16s %10.2f %10zu\n", "parent chains", chainTime, s_nodeCount);
+
+	bool passed = allCount == s_nodeCount && dirtyCount == expected && cleanCount == 0;
+
+	// the graph multiplies down from the root, the chains up from the node, so the roundings differ slightly
+	float worst = 0.0f;
+	for (size_t i = 0; i < s_nodeCount; i++) {
+		DirectX::XMFLOAT4X4 world;
+		DirectX::XMStoreFloat4x4(&world, graph.GetWorld(nodes[i]));
+		for (size_t r = 0; r < 4; r++) {
+			for (size_t c = 0; c < 4; c++) worst = std::fmax(worst, std::fabs(world.m[r][c] - reference[i].m[r][c]));
+		}
+	}
+	printf("largest difference to the parent chains %g\n", worst);
+
+	return passed && worst < 1e-4f;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "Bench.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+/**
+* Benchmarks of the engine's CPU paths, each against the code or library it replaced
+* run without arguments for all of them, or name the ones to run: DXPlotBench math
+*
+* the Cass::Math kernels follow the instruction set of the build, MSBuild's BenchIsa property picks it:
+*	msbuild DXPlotBench.vcxproj /p:Configuration=Release /p:Platform=x64 /p:BenchIsa=AVX2	(SSE2, AVX2 or Scalar)
+* the math benchmark prints a hash of every output, equal hashes across the three builds mean equal results
+*
+* benchmarks that create meshes load the engine's shaders from ../shaders, like DXPlot they run from the project directory
+*/
+
+namespace {
+	struct Entry {
+		const char* name;
+		bool (*run)();
+	};
+
+	const Entry s_benchmarks[] = {
+		{ "math", Bench::RunMath },
+		{ "isosurface", Bench::RunIsoSurface },
+		{ "csv", Bench::RunCsv },
+		{ "ray", Bench::RunRay },
+		{ "cull", Bench::RunCull },
+		{ "scenegraph", Bench::RunSceneGraph },
+		{ "hover", Bench::RunHover },
+	};
+}
+
+int main(int argc, char** argv) {
+	bool passed = true;
+
+	for (const Entry& entry : s_benchmarks) {
+		bool selected = argc < 2;
+		for (int i = 1; i < argc; i++) selected = selected || strcmp(argv[i], entry.name) == 0;
+		if (!selected) continue;
+
+		printf("---------- %s\n", entry.name);
+		bool result = entry.run();
+		printf("%s\n\n", result ? "ok" : "FAILED");
+		passed = passed && result;
+	}
+
+	return passed ? 0 : 1;
+}
\ No newline at end of file
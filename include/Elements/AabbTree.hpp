@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Elements/Ray.hpp>
+
+#include <DirectXMath.h>
+
+#include <functional>
+#include <vector>
+
+namespace Cass {
+	namespace detail {
+		struct AABB_TREE_NODE {
+			// enlarged bounds on leaves, so that small moves leave the tree untouched
+			DirectX::XMFLOAT3 lb, ub;
+			uint64_t userData;
+
+			// next free node while the node is unused
+			uint32_t parent;
+			uint32_t children[2];
+
+			// 0 on leaves, -1 on free nodes
+			int32_t height;
+		};
+	}
+
+	/**
+	* Dynamic bounding volume hierarchy over boxes that are added, moved and removed one at a time
+	* leaves go down the branch that grows the least in surface area, the tree is kept balanced by AVL rotations on the way up
+	* a proxy (leaf index) stays valid until it is removed
+	*/
+	class AabbTree {
+	public:
+		static constexpr uint32_t s_nullProxy = 0xFFFFFFFF;
+
+		AabbTree();
+
+		/**
+		* @return proxy of the new leaf
+		*/
+		uint32_t Insert(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, uint64_t _userData);
+		void Remove(uint32_t _proxy);
+
+		/**
+		* @brief Update the bounds of a proxy, it is only reinserted once it leaves its enlarged bounds
+		* @return true if the tree changed
+		*/
+		bool Move(uint32_t _proxy, DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub);
+
+		uint64_t GetUserData(uint32_t _proxy) const { return m_nodes[_proxy].userData; }
+		size_t GetProxyCount() const { return m_proxyCount; }
+		int32_t GetHeight() const { return m_root == s_nullProxy ? 0 : m_nodes[m_root].height; }
+
+		/**
+		* @brief Collect the proxies whose enlarged bounds overlap a box
+		* @param _oProxies appended to
+		*/
+		void Query(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, std::vector <uint32_t>& _oProxies) const;
+
+		/**
+		* @brief Closest proxy along a ray, subtrees are visited near to far and skipped once they start beyond the closest hit
+		* @param _hit	exact test of a proxy whose bounds the ray crosses, sets the distance and returns true on a hit
+		* @return s_nullProxy if nothing is hit
+		*/
+		uint32_t RayCast(const Ray& _ray, const std::function <bool(uint32_t, float&)>& _hit, float& _oDistance) const;
+
+		/**
+		* @brief Proxy closest to a point, subtrees are visited by the distance to their bounds
+		* @param _distance	exact distance of a proxy to the point, at least the distance to its bounds
+		* @return s_nullProxy if the tree is empty
+		*/
+		uint32_t Nearest(DirectX::XMFLOAT3 _point, const std::function <float(uint32_t)>& _distance, float& _oDistance) const;
+
+	private:
+		uint32_t AllocateNode();
+		void FreeNode(uint32_t _node);
+
+		void InsertLeaf(uint32_t _leaf);
+		void RemoveLeaf(uint32_t _leaf);
+
+		/**
+		* @brief Rotate a grandchild up if the subtrees under _node differ in height by more than one
+		* @return the node now at the place of _node
+		*/
+		uint32_t Balance(uint32_t _node);
+
+		/**
+		* @brief Refit bounds and heights from _node up to the root, balancing along the way
+		*/
+		void Repair(uint32_t _node);
+
+		bool IsLeaf(uint32_t _node) const { return m_nodes[_node].children[0] == s_nullProxy; }
+
+		std::vector <detail::AABB_TREE_NODE> m_nodes;
+		uint32_t m_root, m_freeList;
+		size_t m_proxyCount;
+	};
+}
\ No newline at end of file
@@ -31,6 +31,13 @@ namespace Cass {
 		*/
 		int Intersect(const Cass::Ray& _ray) const;
 
+		/**
+		* @brief Calculates ray-box intersection with the slab test
+		* @param _oNear, _oFar distances along the ray where it enters and leaves the box, _oNear is negative when the origin is inside
+		* @return true if the box is hit in front of the ray origin
+		*/
+		bool Intersect(const Cass::Ray& _ray, float& _oNear, float& _oFar) const;
+
 	private:
 		DirectX::XMFLOAT3 m_pos;
 		DirectX::XMFLOAT3 m_dims;
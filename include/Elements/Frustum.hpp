@@ -0,0 +1,69 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <vector>
+
+namespace Cass {
+	/**
+	* Axis aligned boxes stored as centers and half extents, one array per coordinate padded to a multiple of four
+	* so that a frustum tests four boxes per iteration
+	*/
+	class BoxArray {
+	public:
+		BoxArray();
+
+		size_t GetSize() const { return m_size; }
+
+		/**
+		* @brief Grow or shrink to _size boxes, new boxes are empty points at the origin
+		*/
+		void Resize(size_t _size);
+		void Clear() { Resize(0); }
+
+		void Set(size_t _index, DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub);
+		void Push(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub);
+
+		const float* GetCenters(size_t _axis) const { return m_centers[_axis].data(); }
+		const float* GetExtents(size_t _axis) const { return m_extents[_axis].data(); }
+
+	private:
+		std::vector <float> m_centers[3], m_extents[3];
+		size_t m_size;
+	};
+
+	/**
+	* View frustum as six inward facing planes extracted from a view projection matrix
+	*/
+	class Frustum {
+	public:
+		Frustum();
+
+		/**
+		* @param _viewProjection view matrix times projection matrix, clip space as in D3D with 0 <= z <= w
+		*/
+		explicit Frustum(DirectX::FXMMATRIX _viewProjection);
+
+		void Update(DirectX::FXMMATRIX _viewProjection);
+
+		/**
+		* @brief Plane as (normal, distance) with a unit normal pointing inside, ordered left, right, bottom, top, near, far
+		*/
+		DirectX::XMFLOAT4 GetPlane(size_t _index) const { return m_planes[_index]; }
+
+		/**
+		* @brief Conservative box test, false only if the box lies entirely outside one of the planes
+		*/
+		bool Intersects(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub) const;
+
+		/**
+		* @brief Test all boxes of _boxes four at a time, with the same conservative test as Intersects
+		* @param _oVisible indices of the boxes not culled in increasing order, appended to
+		* @return number of boxes appended
+		*/
+		size_t Cull(const BoxArray& _boxes, std::vector <uint32_t>& _oVisible) const;
+
+	private:
+		DirectX::XMFLOAT4 m_planes[6];
+	};
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <vector>
+
+namespace Cass {
+	/**
+	* Span space index over a regular grid of scalar samples
+	* the cells are grouped into cubic bricks, every octree level stores the value range of 2x2x2 nodes of the level below
+	* so the bricks crossed by an iso value are found without touching the samples
+	*/
+	class MinMaxOctree {
+	public:
+		/**
+		* @param _samples	_res.x * _res.y * _res.z values, x varies fastest
+		* @param _brickSize	cells per brick along each axis
+		*/
+		MinMaxOctree(const float* _samples, DirectX::XMUINT3 _res, uint32_t _brickSize = 8);
+
+		uint32_t GetBrickSize() const { return m_brickSize; }
+
+		/**
+		* @return smallest and largest sample of the grid
+		*/
+		DirectX::XMFLOAT2 GetRange() const { return m_levels.back()[0]; }
+
+		/**
+		* @brief Collect the bricks containing cells with corners on both sides of _isoValue
+		* @param _z0, _z1	only bricks overlapping the cell layers [_z0, _z1) are reported
+		* @param _oBricks	brick coordinates, appended to
+		*/
+		void Query(float _isoValue, uint32_t _z0, uint32_t _z1, std::vector <DirectX::XMUINT3>& _oBricks) const;
+
+	private:
+		void Visit(size_t _level, uint32_t _x, uint32_t _y, uint32_t _z, float _isoValue, uint32_t _z0, uint32_t _z1, std::vector <DirectX::XMUINT3>& _oBricks) const;
+
+		uint32_t m_brickSize;
+
+		// level 0 holds the bricks, the last level a single root node; (min, max) per node
+		std::vector <std::vector <DirectX::XMFLOAT2>> m_levels;
+		std::vector <DirectX::XMUINT3> m_levelDims;
+	};
+}
\ No newline at end of file
@@ -6,6 +6,7 @@ namespace Cass {
 	/**
 	* Represents a ray in 3D
 	* composed of point of emergence (m_origin) and a normalized dimension vector (m_dir)
+	* the per axis reciprocal of the direction (m_invDir) is kept for the slab tests
 	*/
 	class Ray {
 	public:
@@ -13,13 +14,44 @@ namespace Cass {
 		
 		void Update(DirectX::XMFLOAT3 _origin, DirectX::XMFLOAT3 _dir);
 
+		DirectX::XMFLOAT3 GetOrigin() const { return m_origin; }
+		DirectX::XMFLOAT3 GetDirection() const { return m_dir; }
+		DirectX::XMFLOAT3 GetInvDirection() const { return m_invDir; }
+
 		/**
 		* @brief Calculate if the ray intersects a triangle
 		* @return true on intersection
 		*/
 		bool IntersectTriangle(DirectX::XMFLOAT3 _a, DirectX::XMFLOAT3 _b, DirectX::XMFLOAT3 _c) const;
+
+		/**
+		* @brief Calculate if the ray intersects a triangle, either side counts
+		* @param _oDistance distance along the ray to the intersection
+		*/
+		bool IntersectTriangle(DirectX::XMFLOAT3 _a, DirectX::XMFLOAT3 _b, DirectX::XMFLOAT3 _c, float& _oDistance) const;
+
+		/**
+		* @brief Slab test against an axis aligned box given by its per axis bounds
+		* @param _oNear, _oFar distances along the ray where it enters and leaves the box, _oNear is negative when the origin is inside
+		* @return true if the box is hit in front of the origin
+		*/
+		bool IntersectBox(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, float& _oNear, float& _oFar) const;
+
+		/**
+		* @brief Calculate the first intersection in front of the origin with a sphere, the exit point if the origin is inside
+		*/
+		bool IntersectSphere(DirectX::XMFLOAT3 _center, float _radius, float& _oDistance) const;
+
+		/**
+		* @brief Calculate the intersection in front of the origin with an infinite plane through _point
+		*/
+		bool IntersectPlane(DirectX::XMFLOAT3 _point, DirectX::XMFLOAT3 _normal, float& _oDistance) const;
+
 	private:
+		bool IsValid() const { return m_dir.x != 0.0f || m_dir.y != 0.0f || m_dir.z != 0.0f; }
+
 		DirectX::XMFLOAT3 m_origin;
 		DirectX::XMFLOAT3 m_dir;
+		DirectX::XMFLOAT3 m_invDir;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Object/CameraFrame.hpp>
+
+#include <DirectXMath.h>
+
+#include <vector>
+
+namespace Cass {
+	/**
+	* Points of a plot at their pixel positions in one view, bucketed into a grid of square cells over the viewport,
+	* for finding the points under the cursor
+	* the projection runs four points per step on DirectXMath vectors spread over threads, and only when the points,
+	* their transform or the view changed, points behind the camera or off the screen are left out
+	*/
+	class ScreenPointIndex {
+	public:
+		static constexpr uint32_t s_nullPoint = 0xFFFFFFFF;
+
+		/**
+		* @param _cellSize width and height of a grid cell in pixels
+		*/
+		ScreenPointIndex(float _cellSize = 16.0f);
+
+		/**
+		* @brief Bring the index up to date with the view of _frame, nothing is done if the view and points are the same as last time
+		* @param _model local to world transform of the points
+		* @param _stride bytes from one point to the next
+		* @return true if the index was rebuilt
+		*/
+		bool Update(const CameraFrame& _frame, DirectX::FXMMATRIX _model, const DirectX::XMFLOAT3* _points, size_t _count, size_t _stride = sizeof(DirectX::XMFLOAT3));
+
+		/**
+		* @brief Same for points on the z = 0 plane
+		*/
+		bool Update(const CameraFrame& _frame, DirectX::FXMMATRIX _model, const DirectX::XMFLOAT2* _points, size_t _count);
+
+		/**
+		* @brief Rebuild on the next Update, for points changed in place
+		*/
+		void Invalidate() { m_valid = false; }
+
+		/**
+		* @brief Point nearest to the pixel (_x, _y) at most _radius pixels away
+		* @param _oDistance distance in pixels
+		* @return index of the point as passed to Update, s_nullPoint if none is close enough
+		*/
+		uint32_t Nearest(float _x, float _y, float _radius, float& _oDistance) const;
+
+		/**
+		* @param _oPoints indices of all points at most _radius pixels away from (_x, _y), appended to in no particular order
+		* @return number of points appended
+		*/
+		size_t WithinRadius(float _x, float _y, float _radius, std::vector <uint32_t>& _oPoints) const;
+
+		/**
+		* @brief Points on the screen as of the last rebuild
+		*/
+		size_t GetVisibleCount() const { return m_cellPoints.size(); }
+
+	private:
+		/**
+		* @brief Project the points, z is taken as 0 for _planar ones which only have x and y, and sort them into the grid
+		*/
+		void Build(DirectX::FXMMATRIX _toClip, DirectX::XMFLOAT2 _viewport, const uint8_t* _points, size_t _count, size_t _stride, bool _planar);
+
+		/**
+		* @brief Whether the index is out of date for these points seen through _toClip
+		*/
+		bool Changed(DirectX::FXMMATRIX _toClip, DirectX::XMFLOAT2 _viewport, const void* _points, size_t _count) const;
+
+		/**
+		* @brief Cells overlapping the square of side 2 * _radius around (_x, _y), as inclusive ranges
+		* @return false if the square misses the grid
+		*/
+		bool GetCellRange(float _x, float _y, float _radius, uint32_t& _oX0, uint32_t& _oY0, uint32_t& _oX1, uint32_t& _oY1) const;
+
+		float m_cellSize;
+		uint32_t m_columns, m_rows;
+
+		// cell c holds the entries [m_cellStarts[c], m_cellStarts[c + 1]) of the arrays below, by row then column
+		std::vector <uint32_t> m_cellStarts;
+		std::vector <uint32_t> m_cellPoints;
+		std::vector <DirectX::XMFLOAT2> m_cellPositions;
+
+		// per point scratch of the projection, s_nullPoint for points off the screen
+		std::vector <uint32_t> m_cellOf;
+		std::vector <DirectX::XMFLOAT2> m_positions;
+
+		// what the index was built for
+		bool m_valid;
+		DirectX::XMFLOAT4X4 m_lastTransform;
+		DirectX::XMFLOAT2 m_lastViewport;
+		const void* m_lastPoints;
+		size_t m_lastCount;
+	};
+}
\ No newline at end of file
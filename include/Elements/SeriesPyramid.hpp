@@ -0,0 +1,138 @@
+#pragma once
+
+#include <Resource/MappedFile.hpp>
+
+#include <windows.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Cass {
+	/*
+	* multi resolution summary of a uniformly sampled series, stored in one file and read through a memory mapping
+	* level 0 holds the samples, every level above holds (min, max, mean) of _fanout buckets of the level below,
+	* so any time range is drawn from about as many records as the screen has pixels, whatever the length of the series
+	*/
+	class SeriesPyramid {
+	public:
+		struct Bucket {
+			float min, max, mean;
+		};
+
+		SeriesPyramid();
+
+		/**
+		* @brief Map a file written by SeriesPyramidWriter, fails with ERROR_FILE_CORRUPT if the layout doesn't check out
+		*/
+		HRESULT Open(LPCWSTR _fileName);
+
+		uint64_t GetSampleCount() const { return m_sampleCount; }
+		uint32_t GetFanout() const { return m_fanout; }
+		uint32_t GetLevelCount() const { return static_cast <uint32_t> (m_levels.size()); }
+
+		/**
+		* @brief Time of sample i is GetStart() + i * GetStep()
+		*/
+		double GetStart() const { return m_start; }
+		double GetStep() const { return m_step; }
+
+		/**
+		* @brief Samples summarized by one bucket of _level, fanout ^ level, the last bucket of a level may hold fewer
+		*/
+		uint64_t GetBucketSamples(uint32_t _level) const { return m_levels[_level].samples; }
+		uint64_t GetBucketCount(uint32_t _level) const { return m_levels[_level].count; }
+
+		const float* GetSamples() const;
+		const Bucket* GetBuckets(uint32_t _level) const;
+
+		/**
+		* @brief Finest level whose buckets summarize no more than _samplesPerPixel samples
+		*/
+		uint32_t SelectLevel(double _samplesPerPixel) const;
+
+		/**
+		* @brief Buckets covering the time range [_t0, _t1] on a screen _pixelWidth pixels wide, with one neighbour on each side
+		*		 at most fanout records per pixel are read, level 0 samples come back as buckets with min = max = mean
+		* @param _oFirst	index of the first sample summarized by _oBuckets[0]
+		* @return level the buckets were read from
+		*/
+		uint32_t Query(double _t0, double _t1, uint32_t _pixelWidth, std::vector <Bucket>& _oBuckets, uint64_t& _oFirst) const;
+
+	private:
+		struct Level {
+			uint64_t offset, count, samples;
+		};
+
+		MappedFile m_file;
+
+		double m_start, m_step;
+		uint64_t m_sampleCount;
+		uint32_t m_fanout;
+		std::vector <Level> m_levels;
+	};
+
+	/*
+	* builds a SeriesPyramid file in a single pass over the samples, only one partial bucket per level is held in memory
+	* the summary levels are spooled to temporary files next to the output and joined behind the samples by Finish
+	*/
+	class SeriesPyramidWriter {
+	public:
+		SeriesPyramidWriter();
+		~SeriesPyramidWriter();
+
+		SeriesPyramidWriter(const SeriesPyramidWriter&) = delete;
+		SeriesPyramidWriter& operator = (const SeriesPyramidWriter&) = delete;
+
+		/**
+		* @param _start, _step	time of the first sample and between consecutive samples
+		* @param _fanout		buckets of a level summarized by one bucket of the level above, at least 2
+		*/
+		HRESULT Create(LPCWSTR _fileName, double _start, double _step, uint32_t _fanout = 8);
+
+		HRESULT Append(const float* _values, size_t _count);
+
+		/**
+		* @brief Close the partial buckets, write the levels and the header, the file is unusable before this
+		*/
+		HRESULT Finish();
+
+		uint64_t GetSampleCount() const { return m_sampleCount; }
+
+	private:
+		struct Output {
+			HANDLE file;
+			std::vector <uint8_t> buffer;
+		};
+
+		struct Level {
+			Output output;
+			uint64_t count;
+
+			// bucket being filled
+			float min, max;
+			double sum;
+			uint64_t samples;
+			uint32_t children;
+		};
+
+		HRESULT Write(Output& _output, const void* _data, size_t _size);
+		HRESULT Flush(Output& _output);
+
+		/**
+		* @brief Add a summary of one child to the open bucket of _level, emitting the bucket once it's full
+		*/
+		HRESULT Push(size_t _level, float _min, float _max, double _sum, uint64_t _samples);
+		HRESULT Emit(size_t _level);
+
+		void Close();
+
+		std::wstring m_fileName;
+		double m_start, m_step;
+		uint32_t m_fanout;
+		uint64_t m_sampleCount;
+
+		// level 0 writes the samples straight into the output file
+		std::vector <Level> m_levels;
+	};
+}
\ No newline at end of file
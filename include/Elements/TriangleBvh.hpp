@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Elements/Ray.hpp>
+
+#include <DirectXMath.h>
+
+#include <vector>
+
+namespace Cass {
+	namespace detail {
+		/**
+		* 32 byte node, an inner node (count 0) has its children at first and first + 1,
+		* a leaf references the triangles at [first, first + count) of the hierarchy's triangle order
+		*/
+		struct BVH_NODE {
+			DirectX::XMFLOAT3 lb;
+			uint32_t first;
+			DirectX::XMFLOAT3 ub;
+			uint32_t count;
+		};
+	}
+
+	/**
+	* Bounding volume hierarchy over the triangles of an indexed mesh, split by the surface area heuristic over binned centroids
+	* the nodes are stored flat and the triangles are only referenced, so the vertices are passed along with every query
+	*/
+	class TriangleBvh {
+	public:
+		/**
+		* @brief Vertex positions read with a byte stride, three indices per triangle
+		*/
+		struct Geometry {
+			const void* positions;
+			size_t stride;
+			const uint32_t* indices;
+			size_t triangleCount;
+
+			const DirectX::XMFLOAT3& GetVertex(size_t _triangle, size_t _corner) const {
+				return *reinterpret_cast <const DirectX::XMFLOAT3*> (static_cast <const uint8_t*> (positions) + stride * indices[_triangle * 3 + _corner]);
+			}
+		};
+
+		/**
+		* @brief Build the hierarchy, the upper levels bin on all threads and the subtrees below are built concurrently
+		*/
+		TriangleBvh(const Geometry& _geometry);
+
+		size_t GetNodeCount() const { return m_nodes.size(); }
+		size_t GetTriangleCount() const { return m_triangles.size(); }
+
+		/**
+		* @brief Recompute the node bounds for moved vertices, the topology must be the one the hierarchy was built on
+		*		 the tree itself is kept, queries slow down if the surface moves far from the shape it was built for
+		*/
+		void Refit(const Geometry& _geometry);
+
+		/**
+		* @brief Closest triangle hit by the ray, either side counts
+		* @param _oDistance	distance along the ray
+		* @param _oTriangle	index of the triangle in the geometry
+		*/
+		bool Intersect(const Ray& _ray, const Geometry& _geometry, float& _oDistance, uint32_t& _oTriangle) const;
+
+		/**
+		* @brief Collect the triangles whose bounds overlap a box
+		* @param _oTriangles triangle indices, appended to
+		*/
+		void Query(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, const Geometry& _geometry, std::vector <uint32_t>& _oTriangles) const;
+
+	private:
+		std::vector <detail::BVH_NODE> m_nodes;
+
+		// triangle indices grouped by leaf
+		std::vector <uint32_t> m_triangles;
+	};
+}
\ No newline at end of file
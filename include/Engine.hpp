@@ -8,22 +8,58 @@
 #include <Resource/DeviceResources.hpp>
 #include <Resource/Shader.hpp>
 #include <Resource/Texture.hpp>
+#include <Resource/ResourcePool.hpp>
 #include <Object/Mesh.hpp>
+#include <Object/IsoSurface.hpp>
+#include <Object/Contours.hpp>
+#include <Object/Curve.hpp>
+#include <Object/ProgressivePlane.hpp>
+#include <Object/AnimatedPlane.hpp>
+#include <Object/DomainColoring.hpp>
+#include <Object/DecimatedSeries.hpp>
+#include <Object/ArchiveSeries.hpp>
+#include <Object/PointCloud.hpp>
 #include <Object/Empty.hpp>
+#include <Elements/AabbTree.hpp>
+#include <Elements/Frustum.hpp>
+#include <Object/CameraFrame.hpp>
+#include <SceneGraph.hpp>
 
 #include <vector>
 #include <memory>
 
 namespace Application {
+	/**
+	* Reference to an object of a D3DScene, an index into the scene's handle table and the generation of that slot
+	* a handle goes stale once its object is removed, and never resolves to an object added later in the same slot
+	*/
+	struct ObjectHandle {
+		uint32_t index;
+		uint32_t generation;
+
+		bool operator == (const ObjectHandle& _other) const { return index == _other.index && generation == _other.generation; }
+		bool operator != (const ObjectHandle& _other) const { return !(*this == _other); }
+	};
+
+	using ShaderHandle = Cass::ResourceHandle <Cass::Shader>;
+	using TextureHandle = Cass::ResourceHandle <Cass::Texture>;
+
 	class Object {
+		friend class D3DScene;
+
 	public:
 		Object();
 		Object(const std::string& _name);
 
+		/**
+		* @brief Handle given by the scene the object was added to
+		*/
+		ObjectHandle GetHandle() const { return m_handle; }
+
 		std::string m_name;
 
 	protected:
-		uint64_t m_id;
+		ObjectHandle m_handle;
 	};
 
 	class MeshObject: public Object {
@@ -33,7 +69,9 @@ namespace Application {
 
 		bool culling;
 		std::unique_ptr <Cass::Mesh> pMesh;
-		std::shared_ptr <Cass::Shader> pShader;
+
+		// resolved through D3DScene::GetShader, counted as a use of the shader once the object is inserted
+		ShaderHandle shader;
 	};
 
 	class EmptyObject: public Object {
@@ -42,14 +80,22 @@ namespace Application {
 		EmptyObject(const std::string& _name);
 
 		std::unique_ptr <Cass::Empty> pEmpty;
-		std::shared_ptr <Cass::Shader> pShader;
+
+		// resolved through D3DScene::GetShader, counted as a use of the shader once the object is inserted
+		ShaderHandle shader;
 	};
 
 
 	class D3DScene {
 	public:
+		static constexpr ObjectHandle s_nullObject = { 0xFFFFFFFF, 0 };
+
 		D3DScene();
 
+		// the objects report their changes into m_movedObjects, a scene stays where it was created
+		D3DScene(const D3DScene&) = delete;
+		D3DScene& operator = (const D3DScene&) = delete;
+
 		// getters
 
 		int GetHeight() const {
@@ -60,10 +106,49 @@ namespace Application {
 			RECT rc = m_resources.GetClientRect();
 			return rc.right - rc.left;
 		}
-		MeshObject* GetMesh(size_t _index) const {
-			if (_index >= 0 && _index < m_vec_mesh.size()) return m_vec_mesh[_index].get();
+
+		/**
+		* @brief Meshes and emptys are stored densely in order of addition, removing one moves the last into its place
+		*		 the pointers returned stay valid until the next object is added or removed
+		*/
+		MeshObject* GetMesh(size_t _index) {
+			if (_index < m_meshes.size()) return &m_meshes[_index];
+			return nullptr;
+		}
+		EmptyObject* GetEmpty(size_t _index) {
+			if (_index < m_emptys.size()) return &m_emptys[_index];
 			return nullptr;
 		}
+		size_t GetMeshCount() const { return m_meshes.size(); }
+		size_t GetEmptyCount() const { return m_emptys.size(); }
+
+		/**
+		* @return nullptr for a stale handle or one of another kind of object
+		*/
+		MeshObject* GetMesh(ObjectHandle _handle);
+		EmptyObject* GetEmpty(ObjectHandle _handle);
+
+		bool IsValid(ObjectHandle _handle) const {
+			return _handle.index < m_handles.size() && m_handles[_handle.index].generation == _handle.generation &&
+				m_handles[_handle.index].entry != s_nullEntry;
+		}
+
+		/**
+		* @return nullptr for a stale handle
+		*/
+		Cass::Shader* GetShader(ShaderHandle _handle) const { return m_shaders.Get(_handle); }
+		Cass::Texture* GetTexture(TextureHandle _handle) const { return m_textures.Get(_handle); }
+
+		/**
+		* @brief Meshes and emptys drawn and skipped by the frustum test of the last frame
+		*/
+		size_t GetVisibleCount() const { return m_visibleCount; }
+		size_t GetCulledCount() const { return m_culledCount; }
+
+		/**
+		* @brief Camera as of the last frame drawn, which is what the user sees while handling input
+		*/
+		const Cass::CameraFrame& GetCameraFrame() const { return m_frame; }
 
 
 		// state change and creation
@@ -72,36 +157,281 @@ namespace Application {
 		void Render(const float _clearColor[4], int _syncInterval, bool _msaa);
 		void ResizeContext(int _width, int _height);
 
-		// Resource Creation
+		// Resource Creation, the object adders return the handle of the new object
+
+		ObjectHandle AddPolygon(const std::string &_name, float _radius = 1.0f , uint32_t _degree = 16, Cass::SHADING _shading = Cass::SHADING::FLAT, bool _culling = true);
+		ObjectHandle AddCuboid(const std::string& _name, float _width = 2.0f, float _height = 2.0f, float _depth = 2.0f, Cass::SHADING _shading = Cass::SHADING::FLAT, bool _culling = true);
+		ObjectHandle AddSphere(const std::string& _name, float _radius = 1.0f, uint32_t _resX = 32, uint32_t _resY = 16, Cass::SHADING _shading = Cass::SHADING::SMOOTH, bool _culling = true);
+		ObjectHandle AddPlane(const std::string& _name, float _width = 2.0f, float _length = 2.0f, uint32_t _resX = 32, uint32_t _resY = 32, Cass::SHADING _shading = Cass::SHADING::SMOOTH, bool _culling = false);
+		ObjectHandle AddProgressivePlane(
+			const std::string& _name, Cass::ProgressivePlane::Function _func, float _width = 2.0f, float _length = 2.0f,
+			uint32_t _resX = 256, uint32_t _resY = 256, Cass::SHADING _shading = Cass::SHADING::SMOOTH, bool _culling = false
+		);
+		ObjectHandle AddAnimatedPlane(
+			const std::string& _name, Cass::AnimatedPlane::Function _func, float _width = 2.0f, float _length = 2.0f,
+			uint32_t _resX = 256, uint32_t _resY = 256, bool _culling = false
+		);
+		/**
+		* @brief Domain coloring of a complex function, the view can be moved later through Cass::DomainColoring::SetView
+		*/
+		ObjectHandle AddDomainColoring(
+			const std::string& _name, Cass::DomainColoring::Kernel _kernel, DirectX::XMFLOAT2 _center = { 0.0f, 0.0f },
+			float _extent = 4.0f, DirectX::XMUINT2 _resolution = { 1024, 1024 }, float _width = 2.0f
+		);
+		ObjectHandle AddParametricSurface(
+			const std::string& _name, Cass::ParametricSurface::Function _func,
+			DirectX::XMFLOAT2 _rangeU, DirectX::XMFLOAT2 _rangeV, uint32_t _resU = 64, uint32_t _resV = 64,
+			Cass::WRAP _wrapU = Cass::WRAP::NONE, Cass::WRAP _wrapV = Cass::WRAP::NONE,
+			Cass::SHADING _shading = Cass::SHADING::SMOOTH, bool _culling = false
+		);
+		ObjectHandle AddIsoSurface(
+			const std::string& _name, Cass::IsoSurface::Function _func,
+			DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, DirectX::XMUINT3 _res = { 64, 64, 64 }, float _isoValue = 0.0f,
+			bool _culling = false
+		);
+		ObjectHandle AddIsoSurface(
+			const std::string& _name, std::vector <float> _samples,
+			DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, DirectX::XMUINT3 _res, float _isoValue = 0.0f,
+			bool _culling = false
+		);
+
+		ObjectHandle AddContours(
+			const std::string& _name, Cass::Contours::Function _func,
+			DirectX::XMFLOAT2 _rangeX, DirectX::XMFLOAT2 _rangeY, std::vector <float> _levels = { 0.0f },
+			DirectX::XMUINT2 _res = { 256, 256 }, DirectX::XMFLOAT4 _color = { 1.0f, 1.0f, 1.0f, 1.0f }
+		);
+
+		/**
+		* @brief Contour lines of the plane _plane, throws if the handle is stale or not a plane
+		*/
+		ObjectHandle AddContours(
+			const std::string& _name, ObjectHandle _plane, std::vector <float> _levels,
+			DirectX::XMFLOAT4 _color = { 1.0f, 1.0f, 1.0f, 1.0f }
+		);
+		ObjectHandle AddCurve(
+			const std::string& _name, Cass::Curve::Function _func, DirectX::XMFLOAT2 _range,
+			DirectX::XMFLOAT4 _color = { 1.0f, 1.0f, 1.0f, 1.0f }, float _pixelTolerance = 0.5f
+		);
+		ObjectHandle AddGraph(
+			const std::string& _name, std::function <float(float)> _func, DirectX::XMFLOAT2 _rangeX,
+			DirectX::XMFLOAT4 _color = { 1.0f, 1.0f, 1.0f, 1.0f }, float _pixelTolerance = 0.5f
+		);
+
+		/**
+		* @brief Scatter plot of any number of points, drawn through an octree within a per frame point budget
+		* @param _colors	one color per point, or empty to draw all of them in _color
+		*/
+		ObjectHandle AddPointCloud(
+			const std::string& _name, std::vector <DirectX::XMFLOAT3> _points, const std::vector <DirectX::XMFLOAT4>& _colors = {},
+			DirectX::XMFLOAT4 _color = { 1.0f, 1.0f, 1.0f, 1.0f }, float _pointSize = 4.0f
+		);
+
+		/**
+		* @brief Line through a series of any length, only a few points per pixel column are uploaded
+		*/
+		ObjectHandle AddSeries(const std::string& _name, std::vector <DirectX::XMFLOAT2> _points, DirectX::XMFLOAT4 _color = { 1.0f, 1.0f, 1.0f, 1.0f });
 
-		void AddPolygon(const std::string &_name, float _radius = 1.0f , uint32_t _degree = 16, Cass::SHADING _shading = Cass::SHADING::FLAT, bool _culling = true);
-		void AddCuboid(const std::string& _name, float _width = 2.0f, float _height = 2.0f, float _depth = 2.0f, Cass::SHADING _shading = Cass::SHADING::FLAT, bool _culling = true);
-		void AddSphere(const std::string& _name, float _radius = 1.0f, uint32_t _resX = 32, uint32_t _resY = 16, Cass::SHADING _shading = Cass::SHADING::SMOOTH, bool _culling = true);
-		void AddPlane(const std::string& _name, float _width = 2.0f, float _length = 2.0f, uint32_t _resX = 32, uint32_t _resY = 32, Cass::SHADING _shading = Cass::SHADING::SMOOTH, bool _culling = false);
+		/**
+		* @brief Line through a series file written by Cass::SeriesPyramidWriter, read through a memory mapping
+		*/
+		ObjectHandle AddArchiveSeries(const std::string& _name, LPCWSTR _fileName, DirectX::XMFLOAT4 _color = { 1.0f, 1.0f, 1.0f, 1.0f });
 
-		void AddTexture(D3D11_FILTER _filter, D3D11_TEXTURE_ADDRESS_MODE _mode, LPCWSTR _filename);
-		void AddTexture(D3D11_FILTER _filter, D3D11_TEXTURE_ADDRESS_MODE _mode, uint32_t _width, uint32_t _height, const std::vector <uint8_t> &_colorData);
+		/**
+		* @brief Line over the last _window points of a stream, fed through Cass::StreamingPolyline::Append
+		*/
+		ObjectHandle AddStreamingPolyline(
+			const std::string& _name, size_t _window, DirectX::XMFLOAT4 _color = { 1.0f, 1.0f, 1.0f, 1.0f }, size_t _capacity = 0
+		);
+
+		TextureHandle AddTexture(D3D11_FILTER _filter, D3D11_TEXTURE_ADDRESS_MODE _mode, LPCWSTR _filename);
+
+		/**
+		* @param _colorData RGBA values, 4 per texel
+		*/
+		TextureHandle AddTexture(D3D11_FILTER _filter, D3D11_TEXTURE_ADDRESS_MODE _mode, uint32_t _width, uint32_t _height, const std::vector <uint8_t> &_colorData);
+
+		/**
+		* @brief Take an object out of the scene, objects attached to it become roots keeping their local transform
+		*		 its GPU data, and its shader if no other object uses it, is destroyed once the frames in flight are done with it
+		* @return false for a stale handle
+		*/
+		bool Remove(ObjectHandle _handle);
+
+		/**
+		* @brief Release a texture, destroyed once the frames in flight are done with it, shaders using it as albedo keep it alive
+		* @return false for a stale handle
+		*/
+		bool RemoveTexture(TextureHandle _handle);
 
 		// Overlays
 
 		void ToggleBoundingBox(bool _value);
 
+		// Debugging
+
+		/**
+		* @brief Write the live shaders, textures and objects with their GPU memory to the debug output
+		*/
+		void LogResources() const;
+
+		// Hierarchy
+
+		/**
+		* @brief Hang a mesh or empty below another one, from then on its transform is relative to the parent's
+		*		 throws std::invalid_argument for objects not in the scene or a parent below _child
+		* @param _parent s_nullObject to detach _child again
+		*/
+		void Attach(ObjectHandle _child, ObjectHandle _parent);
+
+		// Spatial queries, over the world bounds of all meshes and emptys
+
+		/**
+		* @brief Object hit first by a world space ray, meshes are intersected exactly and emptys by their bounds
+		* @param _oDistance distance along the ray to the hit
+		* @return s_nullObject if nothing is hit
+		*/
+		ObjectHandle Pick(const Cass::Ray& _ray, float& _oDistance);
+
+		/**
+		* @brief Object under a pixel of the last frame drawn
+		* @param _x, _y pixel position from the top left corner of the viewport
+		*/
+		ObjectHandle Pick(float _x, float _y, float& _oDistance);
+
+		/**
+		* @brief Collect the objects whose world bounds overlap a box
+		* @param _oObjects appended to
+		*/
+		void QueryBox(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, std::vector <ObjectHandle>& _oObjects);
+
+		/**
+		* @brief Object with the world bounds closest to a point, 0 distance for a point inside the bounds
+		* @return s_nullObject for an empty scene
+		*/
+		ObjectHandle Nearest(DirectX::XMFLOAT3 _point, float& _oDistance);
+
+		/**
+		* @brief Data point nearest to a pixel of the last frame drawn, over the emptys that plot points and are in view
+		* @param _x, _y pixel position from the top left corner of the viewport
+		* @param _radius farthest distance from the pixel in pixels
+		* @param _oPoint world space position of the point
+		* @param _oDistance distance to the pixel in pixels
+		* @return object of the point, s_nullObject if no point is within _radius
+		*/
+		ObjectHandle HoverPoint(float _x, float _y, float _radius, DirectX::XMFLOAT3& _oPoint, float& _oDistance);
+
+		/**
+		* @brief Same for the pixel under the mouse cursor
+		*/
+		ObjectHandle HoverPoint(float _radius, DirectX::XMFLOAT3& _oPoint, float& _oDistance);
+
 		Cass::Camera m_camera;
 
 	private:
+		// snapshot of m_camera taken at the start of every frame
+		Cass::CameraFrame m_frame;
+
+		static constexpr uint32_t s_nullEntry = 0xFFFFFFFF;
+
+		/**
+		* @brief Per object data read by the per frame loops, with the world bounds at the last update
+		*/
+		struct SceneEntry {
+			ObjectHandle handle;
+
+			// the scale, rotation, translation and world matrix stay in the object, meshes and emptys are their own transform
+			// and are used without a scene too, updates only read it for the objects on m_movedObjects, drawing through the object
+			Cass::Transform* transform;
+
+			// index into m_meshes or m_emptys
+			uint32_t component;
+			bool isMesh;
+
+			uint32_t proxy;
+			DirectX::XMFLOAT3 lb, ub;
+
+			// Cass::SceneGraph::s_nullNode until attached
+			uint32_t node;
+		};
+
+		/**
+		* @brief Entry a handle index refers to, s_nullEntry while the slot is free
+		*/
+		struct HandleSlot {
+			uint32_t entry;
+			uint32_t generation;
+		};
+
+		ObjectHandle Insert(MeshObject&& _mesh);
+		ObjectHandle Insert(EmptyObject&& _empty);
+		ObjectHandle AddEntry(Cass::Transform* _transform, bool _isMesh, size_t _component);
+
+		SceneEntry* FindEntry(ObjectHandle _handle);
+
+		/**
+		* @brief Add a shader to the pool with one use held by the scene itself, for the shaders it keeps whatever objects are left
+		*/
+		ShaderHandle AddSceneShader(std::shared_ptr <Cass::Shader> _shader, const std::string& _name);
+
+		/**
+		* @brief Add a shader to the pool, it is released along with the last object inserted with it
+		*/
+		ShaderHandle AddShader(std::shared_ptr <Cass::Shader> _shader, const std::string& _name);
+
+		/**
+		* @brief Move the objects whose transform or bounds changed in the spatial index and the cull boxes
+		*/
+		void UpdateSpatialIndex();
+
+		/**
+		* @brief Pass changed local transforms into the hierarchy and the resulting parent matrices back out
+		*/
+		void UpdateHierarchy();
+
+		/**
+		* @brief Copy the transform of an attached object into its node
+		*/
+		void SetLocal(const SceneEntry& _entry);
+
 		Cass::DeviceResources m_resources;
-		std::vector <std::unique_ptr<MeshObject>> m_vec_mesh;
-		std::vector <std::unique_ptr<EmptyObject>> m_vec_empty;
-		std::vector <std::shared_ptr<Cass::Texture>> m_textures;
-		std::vector <EmptyObject> m_grid;
+
+		// released resources and the GPU data of removed objects stay here until the GPU finished their last frame
+		Cass::ResourcePool <Cass::Shader> m_shaders;
+		Cass::ResourcePool <Cass::Texture> m_textures;
+		Cass::RetireQueue m_retired;
+		ShaderHandle m_defSurf, m_defFlat;
+
+		EmptyObject m_grid[2];
 		EmptyObject m_axis;
 
 		bool m_msaa;
 		bool m_showGrid;
 
-		static std::shared_ptr <Cass::SurfaceShader> s_defSurf;
-		static std::shared_ptr <Cass::FlatShader> s_defFlat;
-	};
-}
+		// dense by kind and all together, an object removed from the middle is replaced by the last one
+		std::vector <MeshObject> m_meshes;
+		std::vector <EmptyObject> m_emptys;
+		std::vector <SceneEntry> m_entries;
+
+		// by handle index
+		std::vector <HandleSlot> m_handles;
+		std::vector <uint32_t> m_freeHandles;
+
+		// leaves carry the handle index of their object
+		Cass::AabbTree m_spatialIndex;
+
+		// handle indices of the objects whose transform reported a change, filled by the transforms themselves
+		std::vector <uint64_t> m_movedObjects;
 
-// TODO Refine scene class, all meshes should be stored in a single vector
\ No newline at end of file
+		// world bounds by entry index, tested against the view frustum every frame
+		Cass::BoxArray m_cullBoxes;
+		std::vector <uint32_t> m_visible;
+		size_t m_visibleCount, m_culledCount;
+
+		// component indices of the visible objects by draw pass
+		std::vector <uint32_t> m_drawMeshes, m_drawCulledMeshes, m_drawEmptys;
+
+		// handle indices of the objects with a node in the hierarchy
+		Cass::SceneGraph m_hierarchy;
+		std::vector <uint32_t> m_attached;
+	};
+}
\ No newline at end of file
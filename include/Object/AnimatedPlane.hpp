@@ -0,0 +1,101 @@
+#pragma once
+
+#include <Object/Mesh.hpp>
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Cass {
+	/*
+	* smooth shaded height field z = f(x, y, t) animated over time
+	* a fixed set of worker threads evaluates the next frame into a back buffer while the current one is drawn,
+	* finished frames are swapped in and uploaded once, nothing is allocated per frame
+	*/
+	class AnimatedPlane : public Plane {
+	public:
+		using Function = std::function <float(float, float, float)>;
+
+		/**
+		* @param _func	evaluated concurrently from multiple threads, never on the calling thread
+		*/
+		AnimatedPlane(
+			Function _func, float _width, float _length, uint32_t _resX, uint32_t _resY,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+		);
+
+		~AnimatedPlane();
+
+		bool IsPlaying() const { return m_playing; }
+		float GetTime() const { return m_time; }
+
+		/**
+		* @brief Time of the frame on screen, lags GetTime by the frames still being evaluated
+		*/
+		float GetFrameTime() const { return m_frameTime; }
+
+		void Play() { m_playing = true; }
+		void Pause() { m_playing = false; }
+		void SetTime(float _time) { m_time = _time; }
+		void SetSpeed(float _speed) { m_speed = _speed; }
+
+		/**
+		* @brief Swap in the next frame if the workers finished it and start on the one after
+		*/
+		void Refresh() override;
+
+	private:
+		void WorkerLoop(uint32_t _index);
+
+		/**
+		* @brief Block until all workers reached the same point of the current frame
+		*/
+		void ArriveAndWait();
+
+		/**
+		* @brief Start evaluating the frame at _time into the back buffer
+		*/
+		void Dispatch(float _time);
+
+		/**
+		* @brief Make the back buffer the front buffer and upload it
+		*/
+		void Present();
+
+		Function m_func;
+
+		// render thread only
+		bool m_playing;
+		bool m_busy;
+		float m_speed;
+		float m_time, m_frameTime, m_dispatchedTime;
+		std::chrono::steady_clock::time_point m_lastRefresh;
+
+		// written by the workers between Dispatch and m_backReady
+		std::unique_ptr <detail::MESH_VERTEX_DATA[]> m_backData;
+		std::vector <float> m_heights;
+		std::vector <DirectX::XMFLOAT2> m_workerRange;
+		std::atomic <bool> m_backReady;
+
+		std::mutex m_mutex;
+		std::condition_variable m_start;
+		std::condition_variable m_phaseDone;
+		uint64_t m_ticket;
+		uint64_t m_phase;
+		uint32_t m_workerCount;
+		uint32_t m_arrived;
+		uint32_t m_finished;
+		float m_workerTime;
+		bool m_stop;
+
+		std::vector <std::thread> m_workers;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Object/Empty.hpp>
+#include <Object/CameraFrame.hpp>
+#include <Resource/Shader.hpp>
+#include <Elements/SeriesPyramid.hpp>
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+#include <memory>
+#include <vector>
+
+namespace Cass {
+	/*
+	* line through a series kept on disk as a SeriesPyramid, with time along x in the z = 0 plane
+	* every view change reads the level with about one bucket per pixel for the visible time range and draws its min / max envelope,
+	* so the records touched stay in the order of the screen width from the whole archive down to single samples
+	* times are kept in double, the vertices hold them relative to the first sample read and the series is drawn around the camera
+	* target, with the offset from the target to that first sample worked out in double, so float only holds positions near the view
+	*/
+	class ArchiveSeries : public Polyline {
+	public:
+		ArchiveSeries(std::shared_ptr <const SeriesPyramid> _pyramid, DirectX::XMFLOAT4 _color, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext);
+
+		std::shared_ptr <const SeriesPyramid> GetPyramid() const { return m_pyramid; }
+
+		/**
+		* @brief Pyramid level and number of records read by the last query
+		*/
+		uint32_t GetLevel() const { return m_level; }
+		size_t GetRecordCount() const { return m_buckets.size(); }
+
+		/**
+		* @brief Query the pyramid again if the visible range or the viewport changed since the last frame, then draw
+		*/
+		void Render(const CameraFrame& _frame, Shader& _shader) override;
+
+	protected:
+		void InitVertices() override;
+
+	private:
+		/**
+		* @brief Read the buckets for [_t0, _t1] and rebuild the line from them
+		*/
+		void Update(double _t0, double _t1, uint32_t _pixelWidth);
+
+		/**
+		* @brief Bring m_drawTransform in line with the object's transform and m_origin, relative to the world point _target
+		*/
+		void UpdateDrawTransform(DirectX::XMFLOAT3 _target);
+
+		std::shared_ptr <const SeriesPyramid> m_pyramid;
+
+		std::vector <SeriesPyramid::Bucket> m_buckets;
+		uint32_t m_level;
+
+		// extent of the whole archive, kept as the bounds whatever part was read so the series isn't culled by its last view
+		DirectX::XMFLOAT3 m_lb, m_ub;
+
+		// time of vertex x = 0, and the object's transform moved by it along x and taken relative to the camera target for drawing
+		double m_origin;
+		Transform m_drawTransform;
+		double m_drawOrigin;
+		DirectX::XMFLOAT3 m_drawTarget;
+		uint64_t m_drawVersion;
+
+		double m_lastT0, m_lastT1;
+		uint32_t m_lastWidth;
+		bool m_dirty;
+	};
+}
\ No newline at end of file
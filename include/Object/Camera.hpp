@@ -18,6 +18,17 @@ namespace Cass {
 		DirectX::XMFLOAT3 GetRightDir() const;
 		DirectX::XMFLOAT3 GetUpDir() const;
 		DirectX::XMFLOAT3 GetScale() const { return m_scale; }
+		DirectX::XMFLOAT2 GetViewportSize() const { return m_viewport; }
+
+		/**
+		* @brief World space point the rig is centered on, moved through TranslateTarget
+		*/
+		DirectX::XMFLOAT3 GetTarget() const { return { -m_target.x, -m_target.y, -m_target.z }; }
+
+		/**
+		* @brief View matrix for positions taken relative to GetTarget, without the translation to the target in it
+		*/
+		DirectX::XMMATRIX GetTargetViewMat() const { return m_viewMat; }
 
 		Camera(DirectX::XMFLOAT3 _position = { 0.0f, 0.0f, 0.0f });
 
@@ -71,6 +82,7 @@ namespace Cass {
 
 		DirectX::XMFLOAT3 m_target;
 		DirectX::XMFLOAT3 m_scale;
+		DirectX::XMFLOAT2 m_viewport;
 
 		DirectX::XMMATRIX m_viewMat;
 		DirectX::XMMATRIX m_projectionMat;
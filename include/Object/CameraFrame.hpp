@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Object/Camera.hpp>
+#include <Elements/Frustum.hpp>
+#include <Elements/Ray.hpp>
+
+#include <DirectXMath.h>
+
+namespace Cass {
+	/**
+	* State of a camera for one frame, with every matrix rendering, culling and picking need worked out once
+	* changes to the camera after the snapshot is taken show up in the next one only
+	*/
+	class CameraFrame {
+	public:
+		/**
+		* @brief Identity matrices and an empty viewport
+		*/
+		CameraFrame();
+		explicit CameraFrame(const Camera& _camera);
+
+		DirectX::XMMATRIX GetView() const { return DirectX::XMLoadFloat4x4(&m_view); }
+		DirectX::XMMATRIX GetProjection() const { return DirectX::XMLoadFloat4x4(&m_projection); }
+		DirectX::XMMATRIX GetViewProjection() const { return DirectX::XMLoadFloat4x4(&m_viewProjection); }
+		DirectX::XMMATRIX GetInverseView() const { return DirectX::XMLoadFloat4x4(&m_inverseView); }
+		DirectX::XMMATRIX GetInverseViewProjection() const { return DirectX::XMLoadFloat4x4(&m_inverseViewProjection); }
+
+		const Frustum& GetFrustum() const { return m_frustum; }
+
+		/**
+		* @brief Scale of the view set through Camera::Scale
+		*/
+		DirectX::XMFLOAT3 GetScale() const { return m_scale; }
+
+		/**
+		* @brief World space position of the eye
+		*/
+		DirectX::XMFLOAT3 GetPosition() const { return m_position; }
+		DirectX::XMFLOAT2 GetViewportSize() const { return m_viewport; }
+
+		/**
+		* @brief World space point the camera rig is centered on
+		*/
+		DirectX::XMFLOAT3 GetTarget() const { return m_target; }
+
+		/**
+		* @brief The same view with the world moved by -GetTarget, for geometry too far from the world origin for float positions
+		*		 a model drawn with it has to be placed relative to GetTarget, worked out in double
+		*/
+		CameraFrame GetTargetRelative() const;
+
+		/**
+		* @brief World space length covered by one pixel around a world space point, along the screen axis where it's smallest
+		* @return 0 if the point is behind the camera or no projection was set
+		*/
+		float GetPixelSize(DirectX::XMFLOAT3 _point) const;
+
+		/**
+		* @brief Range of x on the z = 0 plane of a model that the screen covers, from the frustum corners hitting the plane
+		* @return false if a side of the screen looks past the plane and the range is unbounded
+		*/
+		bool GetPlaneRangeX(const Transform& _model, float& _oMinX, float& _oMaxX) const;
+
+		/**
+		* @brief World space ray through a pixel, starting on the near plane
+		* @param _x, _y pixel position from the top left corner of the viewport
+		*/
+		Ray GetRay(float _x, float _y) const;
+
+	private:
+		/**
+		* @brief Work out every matrix from the view and projection, along with the frustum and the eye
+		*/
+		void SetMatrices(DirectX::FXMMATRIX _view, DirectX::CXMMATRIX _projection);
+
+		DirectX::XMFLOAT4X4 m_view, m_projection, m_viewProjection;
+		DirectX::XMFLOAT4X4 m_inverseView, m_inverseViewProjection;
+
+		// the view projection can't be inverted without a projection
+		bool m_invertible;
+
+		Frustum m_frustum;
+		DirectX::XMFLOAT3 m_scale;
+		DirectX::XMFLOAT3 m_position;
+		DirectX::XMFLOAT2 m_viewport;
+
+		// view of the positions relative to m_target, the translation to the target left out
+		DirectX::XMFLOAT3 m_target;
+		DirectX::XMFLOAT4X4 m_targetView;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Object/Empty.hpp>
+#include <Object/Mesh.hpp>
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+#include <functional>
+#include <vector>
+
+namespace Cass {
+	/*
+	* contour lines of a scalar field sampled on a regular grid, extracted with marching squares
+	* all levels are traced in a single pass over the grid, segments are joined into strips before upload
+	*/
+	class Contours : public Polyline {
+	public:
+		using Function = std::function <float(float, float)>;
+
+		/**
+		* @brief Contours of f(x, y) in the z = 0 plane, level 0 gives the implicit curve f(x, y) = 0
+		* @param _func	evaluated concurrently from multiple threads
+		* @param _res	number of samples along x and y
+		*/
+		Contours(
+			Function _func, DirectX::XMFLOAT2 _rangeX, DirectX::XMFLOAT2 _rangeY, DirectX::XMUINT2 _res,
+			std::vector <float> _levels, DirectX::XMFLOAT4 _color,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+		);
+
+		/**
+		* @brief Contours of the z coordinate of a displaced plane, lines follow the surface in the plane's local space
+		*		 with one height per grid vertex whether the plane is smooth or flat shaded
+		*/
+		Contours(
+			const Plane& _plane, std::vector <float> _levels, DirectX::XMFLOAT4 _color,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+		);
+
+		const std::vector <float>& GetLevels() const { return m_levels; }
+
+		/**
+		* @brief Trace a new set of levels over the same samples
+		*/
+		void SetLevels(std::vector <float> _levels);
+
+	protected:
+		void InitVertices() override;
+
+	private:
+		/**
+		* @brief Position of the crossing of _level on a grid edge, edge keys are (y * width + x) * 2 + axis
+		*/
+		DirectX::XMFLOAT3 EdgePoint(uint64_t _key, float _level) const;
+
+		uint32_t m_width, m_height;
+		std::vector <float> m_values;
+		std::vector <DirectX::XMFLOAT3> m_positions;
+		std::vector <float> m_levels;
+	};
+}
\ No newline at end of file
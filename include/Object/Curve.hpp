@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Object/Empty.hpp>
+#include <Object/CameraFrame.hpp>
+#include <Resource/Shader.hpp>
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+#include <functional>
+#include <vector>
+
+namespace Cass {
+	/*
+	* curve t -> (x, y, z) sampled adaptively, intervals are split until the curve deviates from its chords by less than
+	* a pixel tolerance at the current zoom, the curve is resampled when rendered after the zoom changed enough
+	* non finite points break the curve into separate strips
+	*/
+	class Curve : public Polyline {
+	public:
+		using Function = std::function <DirectX::XMFLOAT3(float)>;
+
+		/**
+		* @param _range				parameter domain as { min, max }
+		* @param _pixelTolerance	largest distance in pixels between the curve and its polyline
+		* @param _angleTolerance	largest turn in degrees between consecutive segments longer than a few pixels
+		*/
+		Curve(
+			Function _func, DirectX::XMFLOAT2 _range, DirectX::XMFLOAT4 _color,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext,
+			float _pixelTolerance = 0.5f, float _angleTolerance = 10.0f
+		);
+
+		/**
+		* @brief Graph of y = f(x) in the z = 0 plane
+		*/
+		static Function Explicit(std::function <float(float)> _func);
+
+		/**
+		* @brief Resample if the pixel size changed significantly since the last sampling, then draw
+		*/
+		void Render(const CameraFrame& _frame, Shader& _shader) override;
+
+		/**
+		* @brief Tolerance in local units the current polyline was sampled with
+		*/
+		float GetTolerance() const { return m_tolerance; }
+
+	protected:
+		void InitVertices() override;
+
+	private:
+		/**
+		* @brief Append the samples of (_t0, _t1], _p0 is expected to be already appended
+		*/
+		void Subdivide(float _t0, DirectX::XMFLOAT3 _p0, float _t1, DirectX::XMFLOAT3 _p1, uint32_t _depth, std::vector <DirectX::XMFLOAT3>& _oPoints) const;
+		bool NeedsRefinement(DirectX::XMFLOAT3 _p0, DirectX::XMFLOAT3 _pm, DirectX::XMFLOAT3 _p1) const;
+
+		/**
+		* @brief Drop the points of a strip that lie within the tolerance of the chord spanning them
+		*/
+		void Simplify(std::vector <DirectX::XMFLOAT3>& _points) const;
+
+		Function m_func;
+		DirectX::XMFLOAT2 m_range;
+		float m_pixelTolerance;
+		float m_cosAngleTolerance;
+		float m_tolerance;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Object/Empty.hpp>
+#include <Object/CameraFrame.hpp>
+#include <Resource/Shader.hpp>
+#include <Elements/ScreenPointIndex.hpp>
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+#include <vector>
+
+namespace Cass {
+	/*
+	* line through a large 2D series in the z = 0 plane, reduced before upload to the first, last, lowest and highest point
+	* of every pixel column it crosses (M4), which rasterizes to the same pixels as the full series
+	* the reduction runs again whenever the camera, the transform or the viewport changes
+	*/
+	class DecimatedSeries : public Polyline {
+	public:
+		/**
+		* @param _points	series sorted by x for the off screen parts to be skipped, any order is drawn correctly
+		*/
+		DecimatedSeries(std::vector <DirectX::XMFLOAT2> _points, DirectX::XMFLOAT4 _color, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext);
+
+		void SetPoints(std::vector <DirectX::XMFLOAT2> _points);
+
+		size_t GetPointCount() const { return m_points.size(); }
+
+		/**
+		* @brief Decimate again if the view changed since the last frame, then draw
+		*/
+		void Render(const CameraFrame& _frame, Shader& _shader) override;
+
+		/**
+		* @brief Nearest of all points of the series, not only the decimated ones, on the z = 0 plane
+		*/
+		bool FindPoint(const CameraFrame& _frame, float _x, float _y, float _radius, DirectX::XMFLOAT3& _oPoint, float& _oDistance) override;
+
+	protected:
+		void InitVertices() override;
+
+	private:
+		/**
+		* @brief Samples of one run of consecutive points falling in the same pixel column
+		*/
+		struct Column {
+			int64_t column;
+			size_t first, last, min, max;
+			float minY, maxY;
+		};
+
+		/**
+		* @brief Reduce m_points to the vertices drawn under _toScreen, the local to clip space transform
+		*/
+		void Decimate(const CameraFrame& _frame, DirectX::FXMMATRIX _toScreen, DirectX::XMFLOAT2 _viewport);
+
+		void DecimateRange(size_t _begin, size_t _end, DirectX::FXMMATRIX _toScreen, DirectX::XMFLOAT2 _viewport, std::vector <Column>& _oColumns) const;
+
+		/**
+		* @brief Index range of the points between the left and right edge of the screen, with one neighbour on each side
+		*/
+		void VisibleRange(const CameraFrame& _frame, size_t& _oBegin, size_t& _oEnd) const;
+
+		std::vector <DirectX::XMFLOAT2> m_points;
+		bool m_sorted;
+
+		// extent of all points, kept as the bounds whatever part was uploaded so the series isn't culled by its last view
+		DirectX::XMFLOAT3 m_lb, m_ub;
+
+		DirectX::XMFLOAT4X4 m_lastTransform;
+		DirectX::XMFLOAT2 m_lastViewport;
+		bool m_dirty;
+
+		ScreenPointIndex m_hoverIndex;
+	};
+}
\ No newline at end of file
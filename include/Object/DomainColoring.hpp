@@ -0,0 +1,125 @@
+#pragma once
+
+#include <Object/Mesh.hpp>
+#include <Resource/Texture.hpp>
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+#include <complex>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Cass {
+	/*
+	* domain coloring of a complex function w = f(z) drawn as a texture on a plane, hue follows arg(w) and brightness |w|
+	* the view is split into fixed tiles of the complex plane, panning only evaluates the tiles that come into view
+	*/
+	class DomainColoring : public Plane {
+	public:
+		using Function = std::function <std::complex <float>(std::complex <float>)>;
+
+		/**
+		* @brief Evaluate _count points z = (_re[i], _im[i]) into (_outRe[i], _outIm[i]), called concurrently from multiple threads
+		*/
+		using Kernel = std::function <void(const float* _re, const float* _im, float* _outRe, float* _outIm, size_t _count)>;
+
+		/**
+		* @param _center		point of the complex plane in the middle of the view
+		* @param _extent		width of the view in the complex plane, the height follows from the resolution
+		* @param _resolution	texels covered by the view, the plane has the same aspect ratio
+		* @param _width			width of the plane in world space
+		*/
+		DomainColoring(
+			Kernel _kernel, DirectX::XMFLOAT2 _center, float _extent, DirectX::XMUINT2 _resolution, float _width,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+		);
+
+		/**
+		* @brief Wrap a function of one complex value as a kernel
+		*/
+		static Kernel Scalar(Function _func);
+
+		/**
+		* @brief Texture to bind as albedo, its contents scroll with the view
+		*/
+		std::shared_ptr <Texture> GetTexture() const { return m_texture; }
+
+		/**
+		* @brief Move and zoom the view, the center snaps to whole texels and the extent to a fixed set of zoom levels
+		*		 so that tiles evaluated before can be reused, the tiles are updated on the next Render
+		*/
+		void SetView(DirectX::XMFLOAT2 _center, float _extent);
+
+		/**
+		* @brief Replace the function, all cached tiles are dropped
+		*/
+		void SetKernel(Kernel _kernel);
+
+		DirectX::XMFLOAT2 GetCenter() const;
+		float GetExtent() const { return static_cast <float> (m_pixelSize * m_resolution.x); }
+
+		/**
+		* @brief Tiles evaluated and tiles copied into the texture by the last update
+		*/
+		size_t GetEvaluatedTiles() const { return m_evaluatedTiles; }
+		size_t GetUploadedTiles() const { return m_uploadedTiles; }
+
+		/**
+		* @brief Bring the visible tiles up to date, then draw
+		*/
+		void Render(const CameraFrame& _frame, Shader& _shader) override;
+
+	private:
+		struct TileKey {
+			int32_t level;
+			int64_t x, y;
+
+			bool operator == (const TileKey& _other) const { return level == _other.level && x == _other.x && y == _other.y; }
+		};
+
+		struct TileHash {
+			size_t operator () (const TileKey& _key) const;
+		};
+
+		struct Tile {
+			std::vector <uint8_t> colors;
+			uint64_t lastUse;
+		};
+
+		/**
+		* @brief Evaluate and shade one tile of the current level into _tile
+		*/
+		void EvaluateTile(const TileKey& _key, Tile& _tile) const;
+
+		void UpdateTiles();
+		void UpdateUVs();
+
+		/**
+		* @brief Drop the least recently used tiles once the cache is over budget, tiles used by the current update are kept
+		*/
+		void TrimCache();
+
+		Kernel m_kernel;
+		DirectX::XMUINT2 m_resolution;
+
+		// view, in texels of the current zoom level
+		int32_t m_level;
+		double m_pixelSize;
+		int64_t m_centerX, m_centerY;
+		bool m_dirty;
+
+		// the texture is a torus of tile slots, tile (x, y) always lands in the same slot
+		std::shared_ptr <Texture> m_texture;
+		DirectX::XMUINT2 m_slotCount;
+		std::vector <TileKey> m_slots;
+
+		std::unordered_map <TileKey, Tile, TileHash> m_cache;
+		size_t m_cacheBudget;
+		uint64_t m_updateCount;
+
+		size_t m_evaluatedTiles, m_uploadedTiles;
+	};
+}
\ No newline at end of file
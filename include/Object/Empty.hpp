@@ -2,12 +2,15 @@
 
 #include <Transform.hpp>
 #include <Resource/Shader.hpp>
-#include <Object/Camera.hpp>
+#include <Object/CameraFrame.hpp>
 
 #include <d3d11.h>
 #include <WRL/client.h>
 #include <DirectXMath.h>
 
+#include <mutex>
+#include <vector>
+
 namespace Cass {
 	namespace detail {
 		struct EMPTY_VERTEX_DATA {
@@ -31,19 +34,48 @@ namespace Cass {
 		/**
 		* @brief Update vertex buffer Data
 		*/
-		virtual void Render(Camera& camera, Shader &shader);
+		virtual void Render(const CameraFrame& _frame, Shader &shader);
 		void SetBuffers();
 
+		/**
+		* @brief Take in data produced since the last frame, called by the scene every frame before culling so the bounds are current
+		*/
+		virtual void Refresh() { }
+
+		/**
+		* @brief Data point of the object nearest to the pixel (_x, _y) of _frame, for objects that plot data points
+		* @param _radius farthest distance from the pixel in pixels
+		* @param _oPoint world space position of the point
+		* @param _oDistance distance to the pixel in pixels
+		* @return false if no point is within _radius
+		*/
+		virtual bool FindPoint(const CameraFrame& _frame, float _x, float _y, float _radius, DirectX::XMFLOAT3& _oPoint, float& _oDistance) { return false; }
+
+		/**
+		* @brief GPU memory of the vertex and index buffers
+		*/
+		size_t GetByteSize() const;
+
 		virtual ~Empty();
 
 	protected:
 		virtual void InitVertices() = 0;
 		void CreateBuffers();
 
+		/**
+		* @brief Draw the buffers with _model as the local to world transform in place of the object's own
+		*/
+		void Draw(const CameraFrame& _frame, Shader& _shader, const Transform& _model);
+
 		size_t m_vertCount;
 		std::unique_ptr <detail::EMPTY_VERTEX_DATA[]> m_vertexData;
 		Microsoft::WRL::ComPtr <ID3D11Buffer> m_vertexBuffer;
 
+		// optional, drawn indexed when present
+		size_t m_indexCount;
+		Microsoft::WRL::ComPtr <ID3D11Buffer> m_indexBuffer;
+		D3D11_PRIMITIVE_TOPOLOGY m_topology;
+
 		Microsoft::WRL::ComPtr <ID3D11Device> m_device;
 		Microsoft::WRL::ComPtr <ID3D11DeviceContext> m_deviceContext;
 	};
@@ -82,6 +114,123 @@ namespace Cass {
 		int m_skipOffset;
 	};
 
+	/*
+	* set of connected line strips, buffers grow on demand so the strips can be replaced any number of times
+	*/
+	class Polyline : public Empty {
+	public:
+		Polyline(DirectX::XMFLOAT4 _color, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext);
+
+		DirectX::XMFLOAT4 GetColor() const { return m_color; }
+		size_t GetStripCount() const { return m_stripCount; }
+
+		/**
+		* @brief Remove all strips, takes effect on the next Upload
+		*/
+		void Clear();
+
+		/**
+		* @param _closed	connect the last point back to the first one
+		*/
+		void AddStrip(const DirectX::XMFLOAT3* _points, size_t _count, bool _closed = false);
+
+		/**
+		* @brief Copy the strips added since the last Clear into the GPU buffers
+		*/
+		void Upload();
+
+	protected:
+		void InitVertices() override;
+
+		DirectX::XMFLOAT4 m_color;
+
+	private:
+		std::vector <DirectX::XMFLOAT3> m_points;
+		std::vector <uint32_t> m_indices;
+		size_t m_stripCount;
+
+		size_t m_vertCapacity, m_indexCapacity;
+	};
+
+	/*
+	* line strip over the most recent points of an unbounded stream, e.g. live samples of a time series
+	* new points are appended to the GPU buffer without touching the ones already there, the buffer is only
+	* discarded and refilled with the visible window when the end is reached
+	*/
+	class StreamingPolyline : public Empty {
+	public:
+		/**
+		* @param _window	number of most recent points drawn
+		* @param _capacity	vertices in the GPU buffer, 4 * _window when 0, larger values refill less often
+		*/
+		StreamingPolyline(size_t _window, DirectX::XMFLOAT4 _color, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext, size_t _capacity = 0);
+
+		size_t GetWindow() const { return m_window; }
+
+		/**
+		* @brief Number of points appended since construction or the last Clear, including those that left the window
+		*/
+		uint64_t GetTotalCount() const;
+
+		/**
+		* @brief Append points to the stream, safe to call from another thread than the one rendering
+		*		 the points reach the GPU on the next Render, only the last GetWindow of them are kept
+		*/
+		void Append(const DirectX::XMFLOAT3* _points, size_t _count);
+		void Append(float _x, float _y) {
+			DirectX::XMFLOAT3 point = { _x, _y, 0.0f };
+			Append(&point, 1);
+		}
+
+		/**
+		* @brief Drop all points
+		*/
+		void Clear();
+
+		/**
+		* @brief Copy the points appended since the last frame into the GPU buffer, then draw the window in a single call
+		*/
+		void Render(const CameraFrame& _frame, Shader& _shader) override;
+
+		/**
+		* @brief Publish the bounds of the points appended since the last frame
+		*/
+		void Refresh() override;
+
+	protected:
+		void InitVertices() override { }
+
+	private:
+		void Flush();
+
+		/**
+		* @brief Extend m_lb, m_ub by _count points of the history ring starting at _first, m_mutex must be held
+		*/
+		void GrowBounds(size_t _first, size_t _count);
+
+		/**
+		* @brief Copy the newest _count points of the history into _dest, oldest first
+		*/
+		void CopyNewest(size_t _count, detail::EMPTY_VERTEX_DATA* _dest) const;
+
+		DirectX::XMFLOAT4 m_color;
+		size_t m_window, m_capacity;
+
+		// the last m_window points in a ring (m_vertexData), guarded by m_mutex
+		mutable std::mutex m_mutex;
+		size_t m_historyHead;
+		size_t m_unflushed;
+		uint64_t m_total;
+		bool m_cleared;
+
+		// bounds of the points held, guarded by m_mutex until the render thread publishes them
+		DirectX::XMFLOAT3 m_lb, m_ub;
+		bool m_boundsChanged;
+
+		// render thread only, the window occupies [m_gpuHead - m_vertCount, m_gpuHead) of the GPU buffer
+		size_t m_gpuHead;
+	};
+
 	/*
 	* box for visualizing bounds
 	*/
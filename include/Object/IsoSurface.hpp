@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Object/Mesh.hpp>
+#include <Elements/MinMaxOctree.hpp>
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Cass {
+	/*
+	* level set f(x, y, z) = isoValue of a scalar field, triangulated with marching cubes
+	* the field is either a function sampled on every extraction or a stored volume indexed by a min/max octree
+	* samples below the iso value are considered inside, normals point towards increasing f
+	*/
+	class IsoSurface : public Mesh {
+	public:
+		using Function = std::function <float(float, float, float)>;
+
+		/**
+		* @param _func	scalar field, evaluated concurrently from multiple threads
+		* @param _lb	lower corner of the sampled volume
+		* @param _ub	upper corner of the sampled volume
+		* @param _res	number of samples along each axis
+		*/
+		IsoSurface(
+			Function _func, DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, DirectX::XMUINT3 _res, float _isoValue,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+		);
+
+		/**
+		* @param _samples	_res.x * _res.y * _res.z values, x varies fastest, spread evenly over [_lb, _ub]
+		* @param _res		at least 2 along each axis, std::invalid_argument is thrown otherwise
+		*/
+		IsoSurface(
+			std::vector <float> _samples, DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub, DirectX::XMUINT3 _res, float _isoValue,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+		);
+
+		float GetIsoValue() const { return m_isoValue; }
+
+		/**
+		* @brief Duration of the last extraction in milliseconds, buffer upload excluded
+		*/
+		double GetExtractionTime() const { return m_extractionTime; }
+
+		/**
+		* @brief Extract the surface again at a different iso value
+		*		 for stored volumes only the bricks crossed by the new value are visited
+		*/
+		void SetIsoValue(float _isoValue);
+
+	protected:
+		void InitVertices() override;
+
+	private:
+		/**
+		* @brief Grow the GPU buffers if the current vertex or face count no longer fits, then upload
+		*/
+		void UploadSurface();
+
+		Function m_func;
+		std::vector <float> m_samples;
+		std::unique_ptr <MinMaxOctree> m_octree;
+		DirectX::XMFLOAT3 m_lb, m_ub;
+		DirectX::XMUINT3 m_res;
+		float m_isoValue;
+		double m_extractionTime;
+
+		size_t m_vertCapacity, m_polyCapacity;
+	};
+}
\ No newline at end of file
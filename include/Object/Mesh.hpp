@@ -3,8 +3,9 @@
 #include <Transform.hpp>
 #include <Object/Empty.hpp>
 #include <Resource/Shader.hpp>
-#include <Object/Camera.hpp>
+#include <Object/CameraFrame.hpp>
 #include <Object/Empty.hpp>
+#include <Elements/TriangleBvh.hpp>
 
 #include <d3d11.h>
 #include <WRL/client.h>
@@ -13,6 +14,7 @@
 #include <numeric>
 #include <cmath>
 #include <vector>
+#include <functional>
 
 namespace Cass {
 	namespace detail {
@@ -28,6 +30,15 @@ namespace Cass {
 		SMOOTH
 	};
 
+	/**
+	* How a parameter domain joins up at its upper end
+	*/
+	enum class WRAP {
+		NONE,		// open edge
+		PERIODIC,	// last row joins the first one (cylinder, torus)
+		TWISTED		// last row joins the first one with the other parameter mirrored (mobius strip, klein bottle)
+	};
+
 	class Mesh : public Transform {
 	public:
 		Mesh(size_t _vertCount, size_t _polyCount, SHADING _shading, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext);
@@ -37,7 +48,12 @@ namespace Cass {
 		/**
 		* @brief Renders the mesh if buffer size is valid
 		*/
-		virtual void Render(Camera& _camera, Shader& _shader);
+		virtual void Render(const CameraFrame& _frame, Shader& _shader);
+
+		/**
+		* @brief Take in data produced since the last frame, called by the scene every frame before culling so the bounds are current
+		*/
+		virtual void Refresh() { }
 
 		/**
 		* @brief Duplicate per face normals on connected vertices
@@ -68,8 +84,30 @@ namespace Cass {
 
 		void SetPositions(const std::vector<DirectX::XMFLOAT3> &_position);
 		
+		/**
+		* @brief Draw the axis aligned world bounds along with the mesh, the box culling and picking test against
+		*/
 		void ShowBounds(bool _toggle);
 
+		/**
+		* @brief Closest intersection of a world space ray with the mesh, traced through the triangle hierarchy
+		*		 primitives override this with an exact test against their shape while their vertices are untouched
+		* @param _oDistance world space distance from the ray origin to the hit
+		*/
+		virtual bool Intersect(const Ray& _ray, float& _oDistance) const;
+
+		/**
+		* @brief Hierarchy over the triangles in local space, built on first use and refit after the vertices moved
+		*/
+		const TriangleBvh& GetBvh() const;
+
+		TriangleBvh::Geometry GetGeometry() const;
+
+		/**
+		* @brief GPU memory of the vertex and index buffers
+		*/
+		size_t GetByteSize() const;
+
 	protected:
 		/** 
 		* @brief Initialize vertices, normals, UV, vertex colors and indices, for primitives
@@ -89,14 +127,37 @@ namespace Cass {
 		*/
 		void SetBuffers();
 
+		/**
+		* @brief Copy vertex data into the vertex buffer only, for updates that leave the indices untouched
+		*/
+		void SetVertexBuffer();
+
+		/**
+		* @brief Recompute the vertex normals from the current face normals without uploading
+		*/
+		void RecomputeNormals();
+
 		/**
 		* @brief Create vertex and index buffers based on vertex and face count
 		*/
 		void CreateBuffers();
 
+		/**
+		* @brief Bring a world space ray into the untransformed space of the vertices
+		*/
+		Ray ToLocal(const Ray& _ray) const;
+
+		/**
+		* @brief World space distance of the hit found at _distance along the local ray _local
+		*/
+		float ToWorldDistance(const Ray& _ray, const Ray& _local, float _distance) const;
+
 		size_t m_vertCount, m_polyCount;
 		SHADING m_shadingMode;
 
+		// vertices were moved away from the generated shape, analytic intersections no longer apply
+		bool m_deformed;
+
 		std::unique_ptr <uint32_t[]> m_indices;
 		std::unique_ptr <detail::MESH_VERTEX_DATA[]> m_vertexData;
 		Microsoft::WRL::ComPtr <ID3D11Buffer> m_vBuffer;
@@ -105,9 +166,20 @@ namespace Cass {
 		Microsoft::WRL::ComPtr <ID3D11Device> m_device;
 		Microsoft::WRL::ComPtr <ID3D11DeviceContext> m_deviceContext;
 
+		// the vertex buffer was rewritten since the hierarchy was fit
+		mutable bool m_bvhStale;
+
 	private:
+		/**
+		* @brief Fit the bounds overlay to the current world bounds
+		*/
+		void PlaceBoundsMesh();
+
 		std::unique_ptr <Box> m_boundsMesh;
+		uint64_t m_boundsVersion;
 		static std::unique_ptr <FlatShader> s_defShader;
+
+		mutable std::unique_ptr <TriangleBvh> m_bvh;
 	};
 
 	class RegularPolygon : public Mesh {
@@ -117,6 +189,8 @@ namespace Cass {
 			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext,
 			SHADING _shading = SHADING::SMOOTH);
 
+		bool Intersect(const Ray& _ray, float& _oDistance) const override;
+
 	protected:
 		void InitVertices() override;
 
@@ -132,6 +206,8 @@ namespace Cass {
 			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext,
 			SHADING _shading = SHADING::FLAT);
 
+		bool Intersect(const Ray& _ray, float& _oDistance) const override;
+
 	protected:
 		void InitVertices() override;
 
@@ -147,6 +223,8 @@ namespace Cass {
 			SHADING _shading = SHADING::SMOOTH
 		);
 
+		bool Intersect(const Ray& _ray, float& _oDistance) const override;
+
 	protected:
 		void InitVertices() override;
 
@@ -163,14 +241,80 @@ namespace Cass {
 			SHADING _shading = SHADING::SMOOTH
 		);
 
+		/**
+		* @brief Number of vertices along x and y, vertices are stored row by row starting at +y
+		*/
+		DirectX::XMUINT2 GetGridSize() const { return { m_resX + 2U, m_resY + 2U }; }
+		DirectX::XMFLOAT2 GetDimensions() const { return { m_width, m_length }; }
+
+		/**
+		* @brief Displace the vertices along z and recompute the normals from the grid, only the vertex buffer is updated
+		* @param _heights one value per grid vertex, in the order given by GetGridSize
+		*/
+		void SetHeights(const std::vector <float>& _heights);
+
+		bool Intersect(const Ray& _ray, float& _oDistance) const override;
+
 	protected:
 		void InitVertices() override;
 
+		/**
+		* @brief Smooth normal of grid vertex (_i, _j) from central differences of the heights, one sided on the border
+		*/
+		static DirectX::XMFLOAT3 HeightNormal(const float* _heights, size_t _width, size_t _height, size_t _i, size_t _j, float _offsetX, float _offsetY);
+
 	private:
 		float m_width, m_length;
 		uint32_t m_resX, m_resY;
 	};
 
+	/*
+	* surface generated from a (u, v) -> (x, y, z) mapping sampled over a rectangular domain
+	*/
+	class ParametricSurface : public Mesh {
+	public:
+		using Function = std::function <DirectX::XMFLOAT3(float, float)>;
+
+		/**
+		* @param _rangeU, _rangeV	parameter domain as { min, max }, wrapped parameters treat max as a repeat of min
+		* @param _resU, _resV		number of samples along each parameter
+		* @param _wrapU, _wrapV		seams along wrapped parameters share vertices instead of duplicating them
+		*/
+		ParametricSurface(
+			Function _func,
+			DirectX::XMFLOAT2 _rangeU, DirectX::XMFLOAT2 _rangeV,
+			uint32_t _resU, uint32_t _resV,
+			WRAP _wrapU, WRAP _wrapV,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext,
+			SHADING _shading = SHADING::SMOOTH
+		);
+
+		/**
+		* @brief Wrap a polar plot r(theta, phi) as a surface function, theta is measured from +Z and phi around it
+		*		 use with theta in [0, PI] (WRAP::NONE) and phi in [0, 2PI] (WRAP::PERIODIC)
+		*/
+		static Function Polar(std::function <float(float, float)> _radius);
+
+	protected:
+		void InitVertices() override;
+
+	private:
+		static size_t QuadCount(uint32_t _res, WRAP _wrap) { return _wrap == WRAP::NONE ? _res - 1U : _res; }
+
+		/**
+		* @brief Map a possibly out of range grid coordinate onto the sample it is welded to
+		*/
+		uint32_t SampleIndex(uint32_t _i, uint32_t _j) const;
+
+		Function m_func;
+		DirectX::XMFLOAT2 m_rangeU, m_rangeV;
+		uint32_t m_resU, m_resV;
+		WRAP m_wrapU, m_wrapV;
+
+		// boundary rows / columns that collapse onto a single point (poles, cone tips)
+		bool m_collapsedU[2], m_collapsedV[2];
+	};
+
 	class CustomMesh : public Mesh {
 	public:
 		CustomMesh(ID3D11Device*, ID3D11DeviceContext*);
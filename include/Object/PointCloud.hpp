@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Object/Empty.hpp>
+#include <Object/CameraFrame.hpp>
+#include <Resource/Shader.hpp>
+#include <Elements/ScreenPointIndex.hpp>
+
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <DirectXMath.h>
+
+#include <vector>
+
+namespace Cass {
+	namespace detail {
+		struct POINT_INSTANCE_DATA {
+			DirectX::XMFLOAT3 position;
+			uint32_t color;
+		};
+	}
+
+	/*
+	* scatter plot of any number of points, drawn as one camera facing impostor instance per point with a PointShader
+	* the points are sorted into an octree where every node keeps a random subset of the points below it and passes the rest on,
+	* each frame the nodes are refined largest on screen first until the point budget is spent, so far away regions draw
+	* a thinned out cloud and a node plus its ancestors never draw the same point twice
+	*/
+	class PointCloud : public Empty {
+	public:
+		/**
+		* @param _colors	one color per point, or empty for white points tinted by the shader color
+		*/
+		PointCloud(
+			std::vector <DirectX::XMFLOAT3> _points, const std::vector <DirectX::XMFLOAT4>& _colors,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+		);
+
+		size_t GetPointCount() const { return m_points.size(); }
+		size_t GetNodeCount() const { return m_nodes.size(); }
+
+		/**
+		* @brief Most points drawn in one frame
+		*/
+		void SetPointBudget(size_t _budget) { m_pointBudget = _budget; }
+		size_t GetPointBudget() const { return m_pointBudget; }
+
+		/**
+		* @brief Nodes smaller than this on screen aren't refined further
+		*/
+		void SetMinNodeSize(float _pixels) { m_minNodePixels = _pixels; }
+
+		/**
+		* @brief Nodes and points drawn by the last frame
+		*/
+		size_t GetDrawnNodes() const { return m_drawnNodes; }
+		size_t GetDrawnPoints() const { return m_drawnPoints; }
+
+		/**
+		* @brief Select the nodes for this view and draw them, _shader must be a PointShader
+		*/
+		void Render(const CameraFrame& _frame, Shader& _shader) override;
+
+		/**
+		* @brief Nearest of all points, drawn or thinned out, through an index of their pixel positions rebuilt when the view changes
+		*/
+		bool FindPoint(const CameraFrame& _frame, float _x, float _y, float _radius, DirectX::XMFLOAT3& _oPoint, float& _oDistance) override;
+
+	protected:
+		void InitVertices() override { }
+
+	private:
+		struct Node {
+			DirectX::XMFLOAT3 center;
+			float halfSize;
+
+			// the node's own points, then the subtrees of its children in order
+			size_t begin, count;
+			uint32_t children[8];
+		};
+
+		/**
+		* @brief Keep the first points of [_begin, _end) in the node and distribute the rest over the octants
+		*/
+		void Build(uint32_t _node, size_t _begin, size_t _end, uint32_t _depth, std::vector <detail::POINT_INSTANCE_DATA>& _scratch);
+
+		void CreateInstanceBuffers();
+
+		/**
+		* @brief Nodes to draw for _frame, as ranges into m_points
+		*/
+		void Select(const CameraFrame& _frame, std::vector <std::pair <size_t, size_t>>& _oRanges);
+
+		std::vector <detail::POINT_INSTANCE_DATA> m_points;
+		std::vector <Node> m_nodes;
+
+		// the points are split over several buffers to stay below the resource size limit
+		std::vector <Microsoft::WRL::ComPtr <ID3D11Buffer>> m_instanceBuffers;
+
+		size_t m_pointBudget;
+		float m_minNodePixels;
+		size_t m_drawnNodes, m_drawnPoints;
+
+		ScreenPointIndex m_hoverIndex;
+	};
+}
\ No newline at end of file
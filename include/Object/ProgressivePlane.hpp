@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Object/Mesh.hpp>
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Cass {
+	/*
+	* height field z = f(x, y) over a plane, evaluated on a background thread from a coarse lattice down to full resolution
+	* every finished level is shown with the missing samples interpolated, a new function cancels the work in flight
+	*/
+	class ProgressivePlane : public Plane {
+	public:
+		using Function = std::function <float(float, float)>;
+
+		/**
+		* @param _func	evaluated concurrently from multiple threads, never on the calling thread
+		*				an exception it throws ends the evaluation and is rethrown by the next Refresh
+		*/
+		ProgressivePlane(
+			Function _func, float _width, float _length, uint32_t _resX, uint32_t _resY,
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext,
+			SHADING _shading = SHADING::SMOOTH
+		);
+
+		~ProgressivePlane();
+
+		/**
+		* @brief Replace the function, the previous evaluation is abandoned and the coarse level of the new one comes first
+		*/
+		void SetFunction(Function _func);
+
+		/**
+		* @brief Sample spacing of the level on screen, 1 once the full resolution is shown and 0 before the first level
+		*/
+		uint32_t GetStride() const { return m_stride; }
+
+		/**
+		* @brief Upload the latest finished level if there is one, or rethrow what the current function threw on the worker
+		*/
+		void Refresh() override;
+
+	private:
+		void WorkerLoop();
+
+		/**
+		* @brief Evaluate all levels of _func, returns early once _generation is outdated
+		*/
+		void Evaluate(const Function& _func, uint64_t _generation);
+
+		bool IsCurrent(uint64_t _generation) const { return m_generation.load() == _generation; }
+
+		// render thread only
+		uint32_t m_stride;
+		std::vector <float> m_display;
+
+		// worker only, evaluated samples and the interpolated level being prepared
+		std::vector <float> m_samples;
+		std::vector <float> m_level;
+
+		// shared with the worker, guarded by m_mutex
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		Function m_pending;
+		bool m_hasPending;
+		bool m_stop;
+		std::vector <float> m_published;
+		uint64_t m_publishedGeneration;
+		uint32_t m_publishedStride;
+		bool m_hasPublished;
+		std::exception_ptr m_error;
+		uint64_t m_errorGeneration;
+
+		std::atomic <uint64_t> m_generation;
+		std::thread m_worker;
+	};
+}
\ No newline at end of file
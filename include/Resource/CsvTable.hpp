@@ -0,0 +1,96 @@
+#pragma once
+
+#include <windows.h>
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Cass {
+	enum class COLUMN_TYPE {
+		NUMBER,
+		// numbers too large for float to keep their units, such as epoch timestamps, held in double
+		WIDE_NUMBER,
+		TEXT
+	};
+
+	/*
+	* numeric columns of a delimited text file, read through a memory mapping and parsed on all cores
+	* line breaks and delimiters are located 16 bytes at a time and the values go straight from the mapped bytes into the columns
+	* quoted fields are not supported, a delimiter inside quotes splits the field, lines holding only whitespace are skipped
+	*/
+	class CsvTable {
+	public:
+		CsvTable();
+
+		/**
+		* @brief Parse _fileName, replacing any previous contents
+		*		 the column types are taken from the first data row, text columns are skipped, a value of 2^24 or more
+		*		 makes a wide number column and empty or malformed cells of number columns read as NaN
+		* @param _header	the first line holds the column names, otherwise columns are named by their index
+		*/
+		HRESULT Load(LPCWSTR _fileName, char _delimiter = ',', bool _header = true);
+
+		size_t GetRowCount() const { return m_rowCount; }
+		size_t GetColumnCount() const { return m_names.size(); }
+
+		const std::string& GetName(size_t _column) const { return m_names[_column]; }
+		COLUMN_TYPE GetType(size_t _column) const { return m_types[_column]; }
+
+		/**
+		* @return index of the column called _name, SIZE_MAX if there is none
+		*/
+		size_t FindColumn(const std::string& _name) const;
+
+		/**
+		* @brief Values of a number column, one per row; empty for wide number and text columns
+		*/
+		const std::vector <float>& GetColumn(size_t _column) const { return m_columns[_column]; }
+
+		/**
+		* @brief Values of a wide number column, one per row; empty for the other columns
+		*/
+		const std::vector <double>& GetWideColumn(size_t _column) const { return m_wideColumns[_column]; }
+
+		/**
+		* @brief Rows as points for line and series plots
+		* @param _xOrigin	subtracted from x in double before it is rounded to float, to keep the precision of a wide x column
+		*/
+		std::vector <DirectX::XMFLOAT2> GetPoints(size_t _x, size_t _y, double _xOrigin = 0.0) const;
+
+		/**
+		* @brief Rows as points for scatter plots and Mesh::SetPositions, wide columns are rounded to float
+		*/
+		std::vector <DirectX::XMFLOAT3> GetPoints(size_t _x, size_t _y, size_t _z) const;
+
+		/**
+		* @brief Size of the last file loaded, time spent on it in milliseconds and the resulting rate in GB/s
+		*/
+		uint64_t GetByteCount() const { return m_byteCount; }
+		double GetLoadTime() const { return m_loadTime; }
+		double GetThroughput() const;
+
+	private:
+		/**
+		* @brief Fill rows [_row, ...) of the columns from the whole lines in [_begin, _end)
+		*/
+		void ParseLines(const char* _begin, const char* _end, size_t _row, char _delimiter);
+
+		/**
+		* @brief Value of row _row of a number or wide number column as float, minus _origin
+		*/
+		float GetNumber(size_t _column, size_t _row, double _origin) const;
+
+		void CheckNumbers(size_t _column) const;
+
+		std::vector <std::string> m_names;
+		std::vector <COLUMN_TYPE> m_types;
+		std::vector <std::vector <float>> m_columns;
+		std::vector <std::vector <double>> m_wideColumns;
+		size_t m_rowCount;
+
+		uint64_t m_byteCount;
+		double m_loadTime;
+	};
+}
\ No newline at end of file
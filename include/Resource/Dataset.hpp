@@ -0,0 +1,106 @@
+#pragma once
+
+#include <Resource/MappedFile.hpp>
+#include <Resource/CsvTable.hpp>
+#include <Elements/BoundingBox.hpp>
+
+#include <windows.h>
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Cass {
+	/*
+	* float columns stored in one little endian file, each column contiguous and 64 byte aligned so it's used in place from the mapping
+	* the rows are split into fixed size chunks with the range and valid count of every chunk kept in front of the data,
+	* so bounds and range filters are answered from a few bytes of metadata instead of the columns
+	*/
+	class Dataset {
+	public:
+		struct ChunkStats {
+			float min, max;
+			// values that aren't NaN, min and max are NaN when it's 0
+			uint32_t count;
+			uint32_t reserved;
+		};
+
+		Dataset();
+
+		/**
+		* @brief Write _columns[i][0 .. _rowCount) under _names[i], names are cut to 47 characters
+		*/
+		static HRESULT Write(
+			LPCWSTR _fileName, const std::vector <std::string>& _names, const std::vector <const float*>& _columns, size_t _rowCount,
+			uint32_t _chunkRows = 1 << 16
+		);
+
+		/**
+		* @brief Write the number columns of a table, wide number columns rounded to float
+		*/
+		static HRESULT Write(LPCWSTR _fileName, const CsvTable& _table, uint32_t _chunkRows = 1 << 16);
+
+		/**
+		* @brief Map a file written by Write, fails with ERROR_FILE_CORRUPT if the layout doesn't check out
+		*/
+		HRESULT Open(LPCWSTR _fileName);
+
+		size_t GetRowCount() const { return m_rowCount; }
+		size_t GetColumnCount() const { return m_columns.size(); }
+		size_t GetChunkRows() const { return m_chunkRows; }
+		size_t GetChunkCount() const { return m_chunkRows > 0 ? (m_rowCount + m_chunkRows - 1) / m_chunkRows : 0; }
+
+		const std::string& GetName(size_t _column) const { return m_columns[_column].name; }
+
+		/**
+		* @return index of the column called _name, SIZE_MAX if there is none
+		*/
+		size_t FindColumn(const std::string& _name) const;
+
+		/**
+		* @brief Values of a column straight from the mapping, valid while the file is open
+		*/
+		const float* GetColumn(size_t _column) const;
+		const ChunkStats* GetChunkStats(size_t _column) const;
+
+		/**
+		* @brief Smallest and largest value of a column from the chunk metadata, (NaN, NaN) if it has no values
+		*/
+		DirectX::XMFLOAT2 GetRange(size_t _column) const;
+
+		/**
+		* @brief Box around the points formed by three columns, from the chunk metadata
+		*/
+		BoundingBox GetBounds(size_t _x, size_t _y, size_t _z) const;
+
+		/**
+		* @brief Chunks whose range overlaps [_min, _max], only these can hold matching rows
+		*/
+		void FindChunks(size_t _column, float _min, float _max, std::vector <size_t>& _oChunks) const;
+
+		/**
+		* @brief Rows with a value in [_min, _max], chunks entirely inside or outside the range are decided without reading them
+		*/
+		void Filter(size_t _column, float _min, float _max, std::vector <size_t>& _oRows) const;
+
+		/**
+		* @brief Rows as points, gathered from the mapping directly into the vertex array
+		*/
+		std::vector <DirectX::XMFLOAT2> GetPoints(size_t _x, size_t _y) const;
+		std::vector <DirectX::XMFLOAT3> GetPoints(size_t _x, size_t _y, size_t _z) const;
+
+	private:
+		struct Column {
+			std::string name;
+			uint64_t statsOffset, dataOffset;
+		};
+
+		const Column& GetDesc(size_t _column) const;
+
+		MappedFile m_file;
+		std::vector <Column> m_columns;
+		size_t m_rowCount;
+		size_t m_chunkRows;
+	};
+}
\ No newline at end of file
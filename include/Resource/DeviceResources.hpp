@@ -24,7 +24,9 @@ namespace Cass {
 		ID3D11RenderTargetView* GetRTV() const { return m_RTV.Get(); }
 		ID3D11DepthStencilView* GetDSV() const { return m_DSV.Get(); }
 
+		HWND GetWindow() const { return m_window; }
 		RECT GetClientRect() const { return m_windowSize; }
+		D3D11_VIEWPORT GetViewport() const { return m_viewport; }
 
 		/** 
 		* @brief Create size Independent device resources
@@ -46,6 +48,21 @@ namespace Cass {
 		*/
 		void Resolve();
 
+		/**
+		* @brief Mark the end of the commands of the current frame, call once per frame after Present
+		*/
+		void EndFrame();
+
+		/**
+		* @brief Frame being recorded, counting from 0
+		*/
+		uint64_t GetFrameIndex() const { return m_frameIndex; }
+
+		/**
+		* @brief Number of frames the GPU has finished, resources last used in a frame below this are safe to destroy
+		*/
+		uint64_t GetCompletedFrames() const { return m_completedFrames; }
+
 		void SetWindow(HWND _hWnd, int _width, int _height);
 		void WindowSizeChanged(int _width, int _height);
 
@@ -55,6 +72,14 @@ namespace Cass {
 		void CreateStates();
 		void CreateRenderTargets_msaa();
 
+		/**
+		* @brief Count the frames whose end query has been signaled, waits for the oldest one if _wait is set
+		*/
+		void PollFrames(bool _wait);
+
+		// frames in flight tracked at once, a frame's end query is reused this many frames later
+		static constexpr UINT s_frameQueryCount = 4;
+
 		static Microsoft::WRL::ComPtr <IDXGIFactory1>		s_factory;
 
 		Microsoft::WRL::ComPtr <ID3D11Device>				m_device;
@@ -79,6 +104,10 @@ namespace Cass {
 		Microsoft::WRL::ComPtr <ID3D11DepthStencilState>	m_DSS;
 		Microsoft::WRL::ComPtr <ID3D11BlendState>			m_blendState;
 
+		Microsoft::WRL::ComPtr <ID3D11Query>				m_frameQueries[s_frameQueryCount];
+		uint64_t				m_frameIndex;
+		uint64_t				m_completedFrames;
+
 		HWND					m_window;
 		RECT					m_windowSize;
 		UINT					m_backBufferCount;
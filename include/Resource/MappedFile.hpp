@@ -0,0 +1,36 @@
+#pragma once
+
+#include <windows.h>
+
+#include <cstdint>
+
+namespace Cass {
+	/*
+	* read only view of a whole file mapped into the address space, pages are read from disk on first access
+	* and dropped again by the system under memory pressure, so files far larger than RAM can be used in place
+	*/
+	class MappedFile {
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator = (const MappedFile&) = delete;
+
+		/**
+		* @brief Map _fileName, any previously mapped file is closed first
+		*/
+		HRESULT Open(LPCWSTR _fileName);
+		void Close();
+
+		const uint8_t* GetData() const { return m_data; }
+		uint64_t GetSize() const { return m_size; }
+		bool IsOpen() const { return m_data != nullptr; }
+
+	private:
+		HANDLE m_file;
+		HANDLE m_mapping;
+		const uint8_t* m_data;
+		uint64_t m_size;
+	};
+}
\ No newline at end of file
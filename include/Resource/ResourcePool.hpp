@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Cass {
+	/**
+	* Reference to a resource of a ResourcePool <T>, the index of a slot and the generation it was handed out in
+	* a handle goes stale once its resource is released, and never resolves to a resource added later in the same slot
+	*/
+	template <class T>
+	struct ResourceHandle {
+		uint32_t index;
+		uint32_t generation;
+
+		bool operator == (const ResourceHandle& _other) const { return index == _other.index && generation == _other.generation; }
+		bool operator != (const ResourceHandle& _other) const { return !(*this == _other); }
+	};
+
+	/**
+	* Resources held back until the GPU has finished the frame they were last used in
+	* frames are counted as by DeviceResources::GetFrameIndex and GetCompletedFrames
+	*/
+	class RetireQueue {
+	public:
+		/**
+		* @brief Keep _resource alive until frame _frame is complete, the pointer may be the only reference left
+		*/
+		void Retire(std::shared_ptr <void> _resource, uint64_t _frame);
+
+		/**
+		* @brief Drop the resources of every frame below _completedFrames
+		* @return number of resources dropped
+		*/
+		size_t Collect(uint64_t _completedFrames);
+
+		size_t GetSize() const { return m_retired.size(); }
+
+	private:
+		struct Retired {
+			std::shared_ptr <void> resource;
+			uint64_t frame;
+		};
+
+		// in order of the frame retired in
+		std::vector <Retired> m_retired;
+	};
+
+	/**
+	* Owner of all resources of one type, addressed by generational handles in O(1)
+	* a released resource leaves the pool right away but is only destroyed by a Collect once the GPU is done with it
+	*/
+	template <class T>
+	class ResourcePool {
+	public:
+		using Handle = ResourceHandle <T>;
+
+		static constexpr Handle s_nullHandle = { 0xFFFFFFFF, 0 };
+
+		ResourcePool() : m_count(0), m_byteSize(0) {}
+
+		/**
+		* @param _name		shown by debug listings only
+		* @param _byteSize	GPU memory held by the resource, shown by debug listings
+		*/
+		Handle Add(std::shared_ptr <T> _resource, const std::string& _name, size_t _byteSize) {
+			uint32_t index;
+			if (!m_freeSlots.empty()) {
+				index = m_freeSlots.back();
+				m_freeSlots.pop_back();
+			}
+			else {
+				index = static_cast <uint32_t> (m_slots.size());
+				m_slots.push_back({ nullptr, "", 0, 0, 0 });
+			}
+
+			Slot& slot = m_slots[index];
+			slot.resource = std::move(_resource);
+			slot.name = _name;
+			slot.byteSize = _byteSize;
+			slot.uses = 0;
+			m_count++;
+			m_byteSize += _byteSize;
+
+			return { index, slot.generation };
+		}
+
+		bool IsValid(Handle _handle) const {
+			return _handle.index < m_slots.size() && m_slots[_handle.index].generation == _handle.generation && m_slots[_handle.index].resource;
+		}
+
+		/**
+		* @return nullptr for a stale handle
+		*/
+		T* Get(Handle _handle) const {
+			return IsValid(_handle) ? m_slots[_handle.index].resource.get() : nullptr;
+		}
+
+		/**
+		* @brief Shared reference for the few places that keep one, such as the albedo of a shader
+		*/
+		std::shared_ptr <T> GetShared(Handle _handle) const {
+			return IsValid(_handle) ? m_slots[_handle.index].resource : nullptr;
+		}
+
+		/**
+		* @brief Count one more user of a resource, for owners that release it along with its last user
+		*/
+		void AddUse(Handle _handle) {
+			if (IsValid(_handle)) m_slots[_handle.index].uses++;
+		}
+
+		/**
+		* @return users left, 0 for a stale handle
+		*/
+		uint32_t RemoveUse(Handle _handle) {
+			if (!IsValid(_handle) || m_slots[_handle.index].uses == 0) return 0;
+			return --m_slots[_handle.index].uses;
+		}
+
+		uint32_t GetUseCount(Handle _handle) const { return IsValid(_handle) ? m_slots[_handle.index].uses : 0; }
+
+		/**
+		* @brief Take a resource out of the pool, the handle goes stale at once
+		* @param _frame last frame that may have used the resource
+		* @return false for a stale handle
+		*/
+		bool Release(Handle _handle, uint64_t _frame) {
+			if (!IsValid(_handle)) return false;
+
+			Slot& slot = m_slots[_handle.index];
+			m_retired.Retire(std::move(slot.resource), _frame);
+			m_count--;
+			m_byteSize -= slot.byteSize;
+
+			slot.resource = nullptr;
+			slot.name.clear();
+			slot.byteSize = 0;
+			slot.uses = 0;
+			slot.generation++;
+			m_freeSlots.push_back(_handle.index);
+
+			return true;
+		}
+
+		/**
+		* @brief Destroy the released resources of every frame below _completedFrames
+		*/
+		size_t Collect(uint64_t _completedFrames) { return m_retired.Collect(_completedFrames); }
+
+		size_t GetCount() const { return m_count; }
+		size_t GetByteSize() const { return m_byteSize; }
+		size_t GetRetiredCount() const { return m_retired.GetSize(); }
+
+		/**
+		* @brief Call _func(handle, name, byte size, resource) for every live resource
+		*/
+		template <class Func>
+		void ForEach(Func&& _func) const {
+			for (size_t i = 0; i < m_slots.size(); i++) {
+				const Slot& slot = m_slots[i];
+				if (slot.resource) _func(Handle { static_cast <uint32_t> (i), slot.generation }, slot.name, slot.byteSize, *slot.resource);
+			}
+		}
+
+	private:
+		struct Slot {
+			std::shared_ptr <T> resource;
+			std::string name;
+			size_t byteSize;
+			uint32_t generation;
+
+			// counted by AddUse and RemoveUse only, the pool itself doesn't act on it
+			uint32_t uses;
+		};
+
+		std::vector <Slot> m_slots;
+		std::vector <uint32_t> m_freeSlots;
+		RetireQueue m_retired;
+
+		size_t m_count, m_byteSize;
+	};
+}
\ No newline at end of file
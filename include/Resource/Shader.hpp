@@ -1,7 +1,7 @@
 #pragma once
 
 #include <util.hpp>
-#include <Object/Camera.hpp>
+#include <Object/CameraFrame.hpp>
 #include <Resource/Texture.hpp>
 
 #include <d3d11.h>
@@ -18,10 +18,18 @@ namespace Cass {
 	public:
 		Shader(DirectX::XMFLOAT4 _color);
 
-		void SetActive(ID3D11DeviceContext* _pContext, Camera& camera, DirectX::XMMATRIX _modelMat, UINT32 flags = 0);
+		/**
+		* @brief Bind the shader with its constant buffers filled for one model drawn in _frame
+		*/
+		void SetActive(ID3D11DeviceContext* _pContext, const CameraFrame& _frame, const Transform& _model, UINT32 flags = 0);
 
 		void SetAlbedo(std::shared_ptr <Texture> _albedo);
 
+		/**
+		* @brief GPU memory of the constant buffers, the albedo is a texture of its own and not counted
+		*/
+		size_t GetByteSize() const;
+
 		DirectX::XMFLOAT4 m_color;
 	
 	protected:
@@ -33,7 +41,7 @@ namespace Cass {
 		/**
 		* @brief Set Constant Buffers for shader stages
 		*/
-		virtual void SetBuffers(ID3D11DeviceContext* _pContext, Camera& camera, DirectX::XMMATRIX _modelMat, uint32_t flags = 0) = 0;
+		virtual void SetBuffers(ID3D11DeviceContext* _pContext, const CameraFrame& _frame, const Transform& _model, uint32_t flags = 0) = 0;
 		virtual HRESULT LoadFromFile(LPCWSTR fName, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) = 0;
 		
 		Microsoft::WRL::ComPtr <ID3D11VertexShader> m_vertShader;
@@ -55,7 +63,7 @@ namespace Cass {
 		float m_metallic;
 	
 	protected:
-		void SetBuffers(ID3D11DeviceContext* _pContext, Camera& camera, DirectX::XMMATRIX _modelMat, uint32_t flags = SHADER_FLAGS_NONE) override;
+		void SetBuffers(ID3D11DeviceContext* _pContext, const CameraFrame& _frame, const Transform& _model, uint32_t flags = SHADER_FLAGS_NONE) override;
 	};
 
 	class FlatShader : public Shader {
@@ -64,6 +72,21 @@ namespace Cass {
 		HRESULT LoadFromFile(LPCWSTR _fName, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) override;
 	
 	protected:
-		void SetBuffers(ID3D11DeviceContext* _pContext, Camera& camera, DirectX::XMMATRIX _modelMat, uint32_t flags = SHADER_FLAGS_NONE) override;
+		void SetBuffers(ID3D11DeviceContext* _pContext, const CameraFrame& _frame, const Transform& _model, uint32_t flags = SHADER_FLAGS_NONE) override;
+	};
+
+	/*
+	* round impostors for PointCloud, a quad of _pointSize pixels per instance shaded like a small sphere facing the camera
+	*/
+	class PointShader : public Shader {
+	public:
+		PointShader(DirectX::XMFLOAT4 _color = DirectX::XMFLOAT4 { 1.0f, 1.0f, 1.0f, 1.0f }, float _pointSize = 4.0f);
+		HRESULT LoadFromFile(LPCWSTR _fName, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext) override;
+
+		// diameter on screen in pixels
+		float m_pointSize;
+
+	protected:
+		void SetBuffers(ID3D11DeviceContext* _pContext, const CameraFrame& _frame, const Transform& _model, uint32_t flags = SHADER_FLAGS_NONE) override;
 	};
 }
\ No newline at end of file
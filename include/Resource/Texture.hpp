@@ -20,6 +20,11 @@ namespace Cass {
 		inline ID3D11ShaderResourceView* GetSRV() const { return m_SRV.Get(); }
 		inline ID3D11SamplerState* GetSampler() const { return m_sampler.Get(); }
 
+		/**
+		* @brief GPU memory of the texture and its mips, 0 before one is created
+		*/
+		size_t GetByteSize() const;
+
 		/**
 		* @brief Create a mono color texture of specified dimensions
 		*/
@@ -34,10 +39,19 @@ namespace Cass {
 		HRESULT LoadFromFile(LPCWSTR _fileName, ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext);
 		/**
 		* @brief Create a texture from supplied color data, each group of 4 elements must contain RGBA values respectively
+		* @param _generateMips textures that are updated in parts should skip mips, every update would regenerate all of them
 		*/
 		HRESULT LoadFromMemory(
 			uint32_t _width, uint32_t _height, const std::vector<uint8_t> &colorData, 
-			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext
+			ID3D11Device* _pDevice, ID3D11DeviceContext* _pContext, bool _generateMips = true
+		);
+		/**
+		* @brief Overwrite a region of a texture created by LoadFromMemory, in place
+		* @param _colorData RGBA values of the region, rows are _rowPitch bytes apart
+		*/
+		HRESULT UpdateFromMemory(
+			uint32_t _x, uint32_t _y, uint32_t _width, uint32_t _height, const uint8_t* _colorData, uint32_t _rowPitch,
+			ID3D11DeviceContext* _pContext
 		);
 
 		static DXGI_FORMAT WICToDXGI(const GUID& guid);
@@ -49,6 +63,7 @@ namespace Cass {
 		static Microsoft::WRL::ComPtr <IWICImagingFactory> s_factory;
 
 		size_t m_width, m_height;
+		bool m_hasMips;
 		D3D11_FILTER m_filtering;
 		D3D11_TEXTURE_ADDRESS_MODE m_addressMode;
 		DirectX::XMFLOAT4 m_borderColor;
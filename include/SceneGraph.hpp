@@ -0,0 +1,99 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <vector>
+
+namespace Cass {
+	/**
+	* Hierarchy of local scale, rotation and translation, composed into world matrices as child * parent
+	* nodes are kept as one array per attribute in order of depth, so that each level is updated in parallel once the one above is done
+	* and only the nodes changed since the last update and everything below them are recomputed
+	* a node id stays valid until the node is removed, its slot in the arrays changes whenever the order is rebuilt
+	*/
+	class SceneGraph {
+	public:
+		static constexpr uint32_t s_nullNode = 0xFFFFFFFF;
+
+		SceneGraph();
+
+		/**
+		* @param _parent s_nullNode for a root
+		* @return id of the new node, with an identity local transform
+		*/
+		uint32_t AddNode(uint32_t _parent = s_nullNode);
+
+		/**
+		* @brief Remove a node along with its whole subtree
+		*/
+		void RemoveNode(uint32_t _node);
+
+		/**
+		* @brief Move a node with its subtree below _parent, throws std::invalid_argument if _parent lies in that subtree
+		*/
+		void SetParent(uint32_t _node, uint32_t _parent);
+		uint32_t GetParent(uint32_t _node) const;
+
+		size_t GetNodeCount() const { return m_nodeCount; }
+
+		/**
+		* @brief Set the whole local transform, the node is only marked changed if it differs from the current one
+		*/
+		void SetLocal(uint32_t _node, DirectX::XMFLOAT3 _position, DirectX::XMFLOAT4 _rotation, DirectX::XMFLOAT3 _scale);
+		void SetPosition(uint32_t _node, DirectX::XMFLOAT3 _position);
+		void SetRotation(uint32_t _node, DirectX::XMFLOAT4 _rotation);
+		void SetScale(uint32_t _node, DirectX::XMFLOAT3 _scale);
+
+		DirectX::XMFLOAT3 GetPosition(uint32_t _node) const { return m_positions[m_slotOf[_node]]; }
+		DirectX::XMFLOAT4 GetRotation(uint32_t _node) const { return m_rotations[m_slotOf[_node]]; }
+		DirectX::XMFLOAT3 GetScale(uint32_t _node) const { return m_scales[m_slotOf[_node]]; }
+
+		/**
+		* @brief World matrix as of the last Update
+		*/
+		DirectX::XMMATRIX GetWorld(uint32_t _node) const { return DirectX::XMLoadFloat4x4(&m_world[m_slotOf[_node]]); }
+
+		/**
+		* @brief Whether the last Update recomputed the world matrix of _node
+		*/
+		bool IsUpdated(uint32_t _node) const { return m_updated[m_slotOf[_node]] != 0; }
+
+		/**
+		* @brief Recompute the world matrices of the changed nodes and their descendants, level by level
+		* @return number of world matrices recomputed
+		*/
+		size_t Update();
+
+	private:
+		/**
+		* @brief Drop removed nodes and order the rest by depth, keeping the relative order within a level
+		*/
+		void Sort();
+
+		/**
+		* @brief Slot of a live node, throws std::invalid_argument for any other id
+		*/
+		uint32_t GetSlot(uint32_t _node) const;
+
+		void MarkDirty(uint32_t _slot);
+
+		// by node id, s_nullNode for free ids
+		std::vector <uint32_t> m_slotOf;
+		std::vector <uint32_t> m_freeIds;
+
+		// by slot, s_nullNode in m_nodeOf for removed nodes until the next sort
+		std::vector <uint32_t> m_nodeOf, m_parentSlot, m_depth;
+		std::vector <DirectX::XMFLOAT3> m_positions, m_scales;
+		std::vector <DirectX::XMFLOAT4> m_rotations;
+		std::vector <DirectX::XMFLOAT4X4> m_world;
+		std::vector <uint8_t> m_dirty, m_updated;
+
+		// slots of depth d are [m_levelStarts[d], m_levelStarts[d + 1]) while the order is valid
+		std::vector <size_t> m_levelStarts;
+		bool m_orderValid;
+
+		size_t m_nodeCount;
+		size_t m_dirtyCount, m_updatedCount;
+		uint32_t m_minDirtyDepth;
+	};
+}
\ No newline at end of file
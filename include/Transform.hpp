@@ -3,6 +3,8 @@
 #include <DirectXMath.h>
 #include <Elements/BoundingBox.hpp>
 
+#include <vector>
+
 namespace Cass {
 	enum class AXIS {
 		X,
@@ -10,19 +12,75 @@ namespace Cass {
 		Z
 	};
 
+	/*
+	* scale, rotation and translation applied in that order, kept apart so that reading them back needs no decomposition
+	* followed by the world matrix of a parent for objects attached in a scene graph, the getters return the local part
+	* the matrices and the world bounds derived from them are composed on first use after a change
+	*/
 	class Transform {
 	public:
 		Transform();
 
-		DirectX::XMFLOAT3 GetPosition() const;
-		DirectX::XMFLOAT4 GetRotationQuat() const;
+		/**
+		* @brief Copy the transformation and the bounds, a watch set through WatchChanges stays with the object it was set on
+		*/
+		Transform(const Transform& _other);
+		Transform& operator = (const Transform& _other);
+
+		DirectX::XMFLOAT3 GetPosition() const { return m_position; }
+		DirectX::XMFLOAT4 GetRotationQuat() const { return m_rotation; }
 		DirectX::XMFLOAT3 GetRotationEuler() const;
-		DirectX::XMFLOAT3 GetScale() const;
+		DirectX::XMFLOAT3 GetScale() const { return m_scale; }
 		BoundingBox GetBounds() const { return m_bounds; }
+
+		/**
+		* @brief Local to world matrix, scale * rotation * translation * parent
+		*/
+		DirectX::XMMATRIX GetTransformation() const;
+
+		/**
+		* @brief World to local matrix
+		*/
+		DirectX::XMMATRIX GetInverseTransformation() const;
+
+		/**
+		* @brief Counter bumped whenever the transformation or the local bounds change
+		*/
+		uint64_t GetVersion() const { return m_version; }
+
+		/**
+		* @brief Axis aligned world space bounds of the transformed local bounding box (Arvo), cached until the next change
+		*/
+		void GetWorldBounds(DirectX::XMFLOAT3& _oLb, DirectX::XMFLOAT3& _oUb) const;
+
+		/**
+		* @brief Have _key appended to _pQueue on the first change after this call, call again once it was taken off to rearm
+		* @param _pQueue nullptr to stop watching
+		*/
+		void WatchChanges(std::vector <uint64_t>* _pQueue, uint64_t _key);
 		
+		/**
+		* @brief World matrix of the parent this object is attached to, identity for none
+		*/
+		void SetParentTransformation(DirectX::FXMMATRIX _parent);
+		DirectX::XMMATRIX GetParentTransformation() const { return DirectX::XMLoadFloat4x4(&m_parent); }
+
 		void ResetTransform();
+		/**
+		* @brief Move by _offset in the space of the parent, world space for objects that aren't attached
+		*/
 		void Translate(DirectX::XMFLOAT3 _offset);
+		/**
+		* @brief Move to _position, in the space of the parent
+		*/
+		void SetPosition(DirectX::XMFLOAT3 _position);
+		/**
+		* @brief Rotate about an axis through the origin of the object, before the current rotation
+		*/
 		void Rotate(DirectX::XMFLOAT3 _axis, float _angleEuler);
+		/**
+		* @brief Multiply the per axis scale, along the axes of the object
+		*/
 		void Scale(DirectX::XMFLOAT3 _axis);
 
 		/**
@@ -34,7 +92,34 @@ namespace Cass {
 		virtual ~Transform();
 
 	protected:
-		DirectX::XMMATRIX m_transformation;
+		/**
+		* @brief Set the local bounding box from per axis bounds
+		*/
+		void SetBounds(DirectX::XMFLOAT3 _lb, DirectX::XMFLOAT3 _ub);
+
+		void Changed();
+
 		BoundingBox m_bounds;
+
+	private:
+		void CopyFrom(const Transform& _other);
+
+		DirectX::XMFLOAT3 m_position;
+		DirectX::XMFLOAT4 m_rotation;
+		DirectX::XMFLOAT3 m_scale;
+
+		DirectX::XMFLOAT4X4 m_parent;
+		bool m_hasParent;
+
+		// derived from the above on demand
+		mutable DirectX::XMMATRIX m_transformation, m_inverse;
+		mutable DirectX::XMFLOAT3 m_worldLb, m_worldUb;
+		mutable bool m_matrixDirty, m_inverseDirty, m_boundsDirty;
+
+		uint64_t m_version;
+
+		std::vector <uint64_t>* m_pChangeQueue;
+		uint64_t m_changeKey;
+		bool m_changeQueued;
 	};
 }
\ No newline at end of file
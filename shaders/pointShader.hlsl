@@ -0,0 +1,44 @@
+struct FRAG_INPUT {
+    float4 position : SV_POSITION;
+    float4 color : TEXCOORD0;
+    float2 corner : TEXCOORD1;
+};
+
+cbuffer matrices : register(b0) {
+    matrix<float, 4, 4> modelMat;
+    matrix<float, 4, 4> viewMat;
+    matrix<float, 4, 4> projectionMat;
+    float2 viewportSize;
+    float pointSize;
+}
+
+cbuffer shaderData : register(b0) {
+    float worldScale;
+    float4 albedoColor;
+}
+
+// one instance per point, the 4 vertices of the strip are the corners of its quad
+FRAG_INPUT vertex(float3 position : POSITION, float4 pointColor : COLOR, uint vertexId : SV_VertexID) {
+    FRAG_INPUT o;
+
+    float2 corner = float2((vertexId & 1) ? 1.0f : -1.0f, (vertexId & 2) ? 1.0f : -1.0f);
+
+    float4 posMV = mul(viewMat, mul(modelMat, float4(position, 1.0f)));
+    o.position = mul(projectionMat, posMV);
+
+    // offset in clip space so the quad keeps its size in pixels at any depth
+    o.position.xy += corner * pointSize / viewportSize * o.position.w;
+    o.color = pointColor;
+    o.corner = corner;
+
+    return o;
+}
+
+float4 fragment(FRAG_INPUT i) : SV_TARGET {
+    float r2 = dot(i.corner, i.corner);
+    clip(1.0f - r2);
+
+    // lit like a sphere seen head on
+    float shade = 0.4f + 0.6f * sqrt(1.0f - r2);
+    return float4(i.color.rgb * albedoColor.rgb * shade, i.color.a * albedoColor.a);
+}
\ No newline at end of file